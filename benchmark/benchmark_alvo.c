@@ -0,0 +1,258 @@
+//Firmware de benchmark no Pico W (alvo thermoguard_bench_alvo)
+//Roda os mesmos núcleos de ferramentas/thermoguard_bench no RP2040, sem FreeRTOS nem
+//Wi-Fi, para medir float em software, faltas no cache XIP e tempo real de I2C/PIO.
+//Cada iteração é medida em ciclos pelo SysTick (24 bits, clock do processador) e o
+//lote inteiro pelo temporizador de 1 MHz. O relatório sai pela USB CDC a cada
+//PERIODO_RELATORIO_MS em linhas CSV:
+//  # thermoguard_bench_alvo clk_sys_hz=125000000 iteracoes=64
+//  tag,caso,iteracoes,ciclos_primeira,ciclos_min,ciclos_mediana,ciclos_max,us_total,us_op
+//  BENCH,oled_flush,64,...
+//  FIM
+//A primeira iteração é reportada à parte: inclui o carregamento do código pelo XIP
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/i2c.h"
+#include "hardware/clocks.h"
+#include "hardware/structs/systick.h"
+#include "lib/Display_Bibliotecas/ssd1306.h"
+#include "lib/Matriz_Bibliotecas/matriz_led.h"
+#include "lib/dht11/dht11.h"
+#include "lib/Controle/controle_pi.h"
+#include "lib/Controle/controlador.h"
+#include "lib/Historico/historico.h"
+#include "lib/Web/pagina_web.h"
+
+//Mesmos pinos do firmware principal
+#define PINO_I2C_SDA   14
+#define PINO_I2C_SCL   15
+#define PORTA_I2C_OLED i2c1
+#define ENDERECO_OLED  0x3C
+
+#define ITERACOES            64    //Iterações medidas por caso
+#define ESPERA_USB_MS        10000 //Tempo máximo aguardando o terminal abrir a porta
+#define PERIODO_RELATORIO_MS 10000 //Intervalo entre relatórios
+
+#define SYSTICK_HABILITAR   (1u << 0)
+#define SYSTICK_CLOCK_CPU   (1u << 2)
+#define SYSTICK_MASCARA     0x00FFFFFFu
+
+static ssd1306_t display;
+static Historico historico;
+static ControladorPI controlador;
+static ResumoPagina resumo;
+static char corpo_web[3072];
+static uint8_t pulsos_dht11[40];
+static volatile uint32_t escudo; //Impede que o compilador descarte os resultados
+static uint32_t contador_iteracao;
+
+/* ---------- Núcleos medidos ---------- */
+
+static void nucleo_oled_render(void) {
+    //Mesma sequência de atualizar_tela_oled_principal, sem o envio
+    char texto[32];
+    float temperatura = 27.0f + (float)(contador_iteracao & 7) / 10.0f;
+    ssd1306_fill(&display, false);
+    snprintf(texto, sizeof(texto), "Temp: %4.1f °C", temperatura);
+    ssd1306_draw_string(&display, texto, 0, 0, false);
+    snprintf(texto, sizeof(texto), "Set:  %3d °C", 30);
+    ssd1306_draw_string(&display, texto, 0, 16, false);
+    snprintf(texto, sizeof(texto), "Erro: %4.1f °C", 30.0f - temperatura);
+    ssd1306_draw_string(&display, texto, 0, 32, false);
+    snprintf(texto, sizeof(texto), "PWM:  %5u", 40123u + (contador_iteracao & 7));
+    ssd1306_draw_string(&display, texto, 0, 48, false);
+}
+
+static void nucleo_oled_flush(void) {
+    ssd1306_send_data(&display);
+}
+
+static void nucleo_oled_texto(void) {
+    ssd1306_draw_string(&display, "Temp: 27.4 C", 0, (contador_iteracao & 3) * 16, false);
+}
+
+static void nucleo_dht11_decode(void) {
+    float umidade, temperatura;
+    escudo += dht11_decode(pulsos_dht11, &umidade, &temperatura);
+    escudo += (uint32_t)temperatura;
+}
+
+static void nucleo_pi_passo(void) {
+    float erro = (float)((int32_t)(contador_iteracao & 63) - 32) / 8.0f;
+    escudo += controle_pi_passo(&controlador, erro, 1.0f);
+}
+
+//Variantes de controlador.h: sem FPU no RP2040, compara float em software com Q16.16
+static Controlador controlador_pi, controlador_pid, controlador_pi_q16, controlador_pid_q16;
+
+static float erro_controlador(void) {
+    return (float)((int32_t)(contador_iteracao & 63) - 32) / 8.0f;
+}
+
+static void nucleo_controlador_pi(void) {
+    escudo += (uint32_t)controlador_passo(&controlador_pi, erro_controlador(), 0.0f);
+}
+
+static void nucleo_controlador_pid(void) {
+    escudo += (uint32_t)controlador_passo(&controlador_pid, erro_controlador(), 0.0f);
+}
+
+//Mesmo erro já em Q16.16: as variantes em ponto fixo são medidas sem conversão de float
+static int32_t erro_controlador_q16(void) {
+    return ((int32_t)(contador_iteracao & 63) - 32) * (65536 / 8);
+}
+
+static void nucleo_controlador_pi_q16(void) {
+    escudo += (uint32_t)controlador_passo_fixo(&controlador_pi_q16, erro_controlador_q16(), 0);
+}
+
+static void nucleo_controlador_pid_q16(void) {
+    escudo += (uint32_t)controlador_passo_fixo(&controlador_pid_q16, erro_controlador_q16(), 0);
+}
+
+static void nucleo_html(void) {
+    char cabecalho[128];
+    historico_estatisticas(&historico, NIVEL_SEGUNDOS, &resumo.recentes);
+    resumo.ciclo_pwm = 40000 + (contador_iteracao & 255);
+    int tamanho = pagina_web_montar(&resumo, corpo_web, sizeof(corpo_web));
+    escudo += pagina_web_cabecalho(cabecalho, sizeof(cabecalho), "200 OK", "text/html", tamanho);
+}
+
+static void nucleo_ws2812_quadro(void) {
+    //Inclui os 60 µs de latch que matriz_draw_number espera no fim do quadro
+    matriz_draw_number((uint8_t)(contador_iteracao % 10), COR_VERDE);
+}
+
+typedef struct {
+    const char *nome;
+    void (*executar)(void);
+} NucleoBench;
+
+static const NucleoBench nucleos[] = {
+    {"oled_render",         nucleo_oled_render},
+    {"oled_flush",          nucleo_oled_flush},
+    {"oled_texto",          nucleo_oled_texto},
+    {"dht11_decode",        nucleo_dht11_decode},
+    {"pi_passo",            nucleo_pi_passo},
+    {"controlador_pi",      nucleo_controlador_pi},
+    {"controlador_pid",     nucleo_controlador_pid},
+    {"controlador_pi_q16",  nucleo_controlador_pi_q16},
+    {"controlador_pid_q16", nucleo_controlador_pid_q16},
+    {"html",                nucleo_html},
+    {"ws2812_quadro",       nucleo_ws2812_quadro},
+};
+
+/* ---------- Medição ---------- */
+
+static void iniciar_systick(void) {
+    systick_hw->csr = 0;
+    systick_hw->rvr = SYSTICK_MASCARA;
+    systick_hw->cvr = 0;
+    systick_hw->csr = SYSTICK_HABILITAR | SYSTICK_CLOCK_CPU;
+}
+
+static int comparar_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+    return (x > y) - (x < y);
+}
+
+static void medir_nucleo(const NucleoBench *nucleo) {
+    //O SysTick é decrescente e volta a cada 2^24 ciclos (~134 ms a 125 MHz), acima de qualquer núcleo
+    static uint32_t ciclos[ITERACOES];
+    uint32_t ciclos_primeira = 0;
+    uint64_t inicio_lote = time_us_64();
+
+    for (int i = 0; i <= ITERACOES; i++) {
+        contador_iteracao = (uint32_t)i;
+        uint32_t antes = systick_hw->cvr;
+        nucleo->executar();
+        uint32_t depois = systick_hw->cvr;
+        uint32_t decorridos = (antes - depois) & SYSTICK_MASCARA;
+        if (i == 0) {
+            ciclos_primeira = decorridos;
+            inicio_lote = time_us_64();
+        } else {
+            ciclos[i - 1] = decorridos;
+        }
+    }
+    uint64_t us_total = time_us_64() - inicio_lote;
+
+    qsort(ciclos, ITERACOES, sizeof(ciclos[0]), comparar_u32);
+    printf("BENCH,%s,%d,%lu,%lu,%lu,%lu,%llu,%.2f\n", nucleo->nome, ITERACOES,
+           (unsigned long)ciclos_primeira, (unsigned long)ciclos[0],
+           (unsigned long)ciclos[ITERACOES / 2], (unsigned long)ciclos[ITERACOES - 1],
+           (unsigned long long)us_total, (double)us_total / ITERACOES);
+}
+
+static void preparar(void) {
+    i2c_init(PORTA_I2C_OLED, 400000);
+    gpio_set_function(PINO_I2C_SDA, GPIO_FUNC_I2C);
+    gpio_set_function(PINO_I2C_SCL, GPIO_FUNC_I2C);
+    gpio_pull_up(PINO_I2C_SDA);
+    gpio_pull_up(PINO_I2C_SCL);
+    ssd1306_init(&display, 128, 64, false, ENDERECO_OLED, PORTA_I2C_OLED);
+    ssd1306_config(&display);
+
+    inicializar_matriz_led();
+
+    historico_inicializar(&historico);
+    for (uint32_t t = 0; t < 7200; t++) {
+        historico_registrar(&historico, 25.0f + (float)(t % 600) / 100.0f, t);
+    }
+    controle_pi_inicializar(&controlador, 50.0f, 2.0f, 4096.0f);
+    //Mesmos ganhos do pi_passo (dt = 1 s), com derivada filtrada nas variantes PID
+    const ParametrosControlador parametros = {
+        .kp = 50.0f, .ki = 2.0f, .kd = 10.0f, .filtro_s = 2.0f,
+        .limite_integral = 4096.0f, .saida_max = 4096.0f,
+    };
+    controlador_configurar(&controlador_pi, CONTROLADOR_PI, &parametros, 1.0f);
+    controlador_configurar(&controlador_pid, CONTROLADOR_PID, &parametros, 1.0f);
+    controlador_configurar(&controlador_pi_q16, CONTROLADOR_PI_FIXO, &parametros, 1.0f);
+    controlador_configurar(&controlador_pid_q16, CONTROLADOR_PID_FIXO, &parametros, 1.0f);
+
+    //Leitura de 61,0 % e 27,4 °C com checksum válido, em durações típicas (26 µs = 0, 70 µs = 1)
+    const uint8_t bytes[5] = {61, 0, 27, 4, 61 + 0 + 27 + 4};
+    for (int i = 0; i < 40; i++) {
+        pulsos_dht11[i] = (bytes[i / 8] >> (7 - i % 8)) & 1 ? 70 : 26;
+    }
+
+    resumo = (ResumoPagina){
+        .sistema_ligado = true,
+        .setpoint = 30,
+        .setpoint_minimo = 10,
+        .setpoint_maximo = 30,
+        .temperatura = 27.4f,
+        .umidade = 61.0f,
+        .ciclo_pwm = 40123,
+        .rpm = 1412.0f,
+        .kp = 50.0f,
+        .ki = 2.0f,
+        .avaliacao_concluida = true,
+        .tempo_acomodacao_s = 183.0f,
+        .sobressinal = 0.8f,
+    };
+}
+
+int main() {
+    stdio_init_all();
+    //Aguarda o terminal abrir a porta USB para não perder o primeiro relatório
+    for (uint32_t esperado = 0; !stdio_usb_connected() && esperado < ESPERA_USB_MS; esperado += 10) {
+        sleep_ms(10);
+    }
+
+    preparar();
+    iniciar_systick();
+
+    while (true) {
+        printf("# thermoguard_bench_alvo clk_sys_hz=%lu iteracoes=%d\n",
+               (unsigned long)clock_get_hz(clk_sys), ITERACOES);
+        printf("tag,caso,iteracoes,ciclos_primeira,ciclos_min,ciclos_mediana,ciclos_max,us_total,us_op\n");
+        for (size_t i = 0; i < count_of(nucleos); i++) {
+            medir_nucleo(&nucleos[i]);
+        }
+        printf("FIM\n");
+        sleep_ms(PERIODO_RELATORIO_MS);
+    }
+}
@@ -0,0 +1,442 @@
+//Gerador de carga HTTP (Linux) para o servidor do ThermoGuard
+//Uso: carga_http [opções] <ip> [porta]
+//  -c N         clientes simultâneos (padrão 4)
+//  -d S         duração em segundos (padrão 10)
+//  -n N         para após N requisições no total (padrão: sem limite)
+//  -p MS        pausa de cada cliente entre requisições (padrão 0)
+//  -t MS        tempo limite de conexão/resposta (padrão 5000)
+//  -m MISTURA   caminhos e pesos, ex.: "/=4,/api/zona=2,/api/estatisticas=1"
+//  --csv        uma linha CSV com cabeçalho, para comparar builds em scripts
+//  --max-erros P  termina com código 2 se a taxa de erros passar de P %
+//Cada cliente abre uma conexão por requisição (o servidor responde com Connection: close).
+//Latência = do connect() até o fechamento pelo servidor, em ms
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <time.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <poll.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+
+#define MAX_CAMINHOS      16
+#define TAMANHO_RESPOSTA  65536 //Maior resposta guardada; o resto é só contado
+
+typedef enum {
+    RESULTADO_OK,
+    RESULTADO_HTTP,        //Status diferente de 2xx (ex.: 503 por falta de memória no lwIP)
+    RESULTADO_CONEXAO,     //connect() recusado ou sem resposta
+    RESULTADO_RESET,       //ECONNRESET/EPIPE no meio da troca
+    RESULTADO_TEMPO,       //Sem resposta dentro do limite
+    RESULTADO_INCOMPLETO,  //Corpo menor que o Content-Length ou chunked sem o chunk final
+    RESULTADOS
+} Resultado;
+
+static const char *NOMES_RESULTADO[RESULTADOS] = {"ok", "http", "conexao", "reset", "tempo", "incompleto"};
+
+typedef struct {
+    char caminho[128];
+    unsigned peso;
+} Caminho;
+
+static struct {
+    struct sockaddr_storage endereco;
+    socklen_t tamanho_endereco;
+    char host[64];
+    unsigned clientes;
+    double duracao_s;
+    uint64_t limite_requisicoes;
+    unsigned pausa_ms;
+    unsigned tempo_limite_ms;
+    Caminho caminhos[MAX_CAMINHOS];
+    unsigned quantidade_caminhos;
+    unsigned peso_total;
+} config = {
+    .clientes = 4,
+    .duracao_s = 10.0,
+    .tempo_limite_ms = 5000,
+};
+
+typedef struct {
+    pthread_t thread;
+    unsigned indice;
+    uint32_t semente;
+    double *latencias_ms;   //Só de respostas OK
+    size_t quantidade, capacidade;
+    uint64_t resultados[RESULTADOS];
+    uint64_t bytes;
+    uint64_t por_caminho[MAX_CAMINHOS];
+} Cliente;
+
+static volatile bool parar;
+static uint64_t requisicoes_iniciadas; //Acesso atômico
+static double inicio_s;
+
+static double agoraS(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static uint32_t aleatorio(uint32_t *estado) {
+    //xorshift32: basta para sortear caminhos sem disputa entre threads
+    uint32_t x = *estado;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    return *estado = x;
+}
+
+static unsigned sortearCaminho(Cliente *cliente) {
+    unsigned sorteio = aleatorio(&cliente->semente) % config.peso_total;
+    for (unsigned i = 0; i < config.quantidade_caminhos; i++) {
+        if (sorteio < config.caminhos[i].peso) {
+            return i;
+        }
+        sorteio -= config.caminhos[i].peso;
+    }
+    return 0;
+}
+
+// Espera o socket ficar pronto até o prazo; false em tempo esgotado
+static bool aguardar(int soquete, short eventos, double prazo_s) {
+    int restante_ms = (int)((prazo_s - agoraS()) * 1000.0);
+    if (restante_ms <= 0) {
+        return false;
+    }
+    struct pollfd p = {.fd = soquete, .events = eventos};
+    return poll(&p, 1, restante_ms) > 0;
+}
+
+static Resultado erroSocket(int erro) {
+    return erro == ECONNRESET || erro == EPIPE ? RESULTADO_RESET : RESULTADO_CONEXAO;
+}
+
+// Uma requisição completa; devolve o resultado e os bytes recebidos
+static Resultado requisitar(const char *caminho, double *latencia_ms, uint64_t *bytes) {
+    static __thread char resposta[TAMANHO_RESPOSTA];
+    double inicio = agoraS();
+    double prazo = inicio + config.tempo_limite_ms / 1000.0;
+    *bytes = 0;
+
+    int soquete = socket(config.endereco.ss_family, SOCK_STREAM | SOCK_NONBLOCK, 0);
+    if (soquete < 0) {
+        return RESULTADO_CONEXAO;
+    }
+    int sim = 1;
+    setsockopt(soquete, IPPROTO_TCP, TCP_NODELAY, &sim, sizeof(sim));
+
+    Resultado resultado = RESULTADO_OK;
+    if (connect(soquete, (struct sockaddr *)&config.endereco, config.tamanho_endereco) < 0 && errno != EINPROGRESS) {
+        resultado = RESULTADO_CONEXAO;
+        goto fim;
+    }
+    if (!aguardar(soquete, POLLOUT, prazo)) {
+        resultado = RESULTADO_TEMPO;
+        goto fim;
+    }
+    int erro = 0;
+    socklen_t tamanho_erro = sizeof(erro);
+    getsockopt(soquete, SOL_SOCKET, SO_ERROR, &erro, &tamanho_erro);
+    if (erro) {
+        resultado = erro == ECONNREFUSED ? RESULTADO_CONEXAO : erroSocket(erro);
+        goto fim;
+    }
+
+    char pedido[256];
+    int tamanho_pedido = snprintf(pedido, sizeof(pedido), "GET %s HTTP/1.1\r\nHost: %s\r\nConnection: close\r\n\r\n", caminho, config.host);
+    if (send(soquete, pedido, tamanho_pedido, MSG_NOSIGNAL) != tamanho_pedido) {
+        resultado = erroSocket(errno);
+        goto fim;
+    }
+
+    //Lê até o servidor fechar; os últimos bytes confirmam o fim de um corpo chunked maior que o buffer
+    size_t guardado = 0;
+    char cauda[5] = {0};
+    char excedente[4096]; //Depois do buffer cheio: lido e descartado, sem sobrescrever o cabeçalho
+    while (true) {
+        if (!aguardar(soquete, POLLIN, prazo)) {
+            resultado = RESULTADO_TEMPO;
+            goto fim;
+        }
+        char *destino = guardado < sizeof(resposta) ? resposta + guardado : excedente;
+        size_t livre = guardado < sizeof(resposta) ? sizeof(resposta) - guardado : sizeof(excedente);
+        ssize_t lidos = recv(soquete, destino, livre, 0);
+        if (lidos == 0) {
+            break;
+        }
+        if (lidos < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                continue;
+            }
+            resultado = erroSocket(errno);
+            goto fim;
+        }
+        *bytes += (uint64_t)lidos;
+        if ((size_t)lidos >= sizeof(cauda)) {
+            memcpy(cauda, destino + lidos - sizeof(cauda), sizeof(cauda));
+        } else {
+            memmove(cauda, cauda + lidos, sizeof(cauda) - (size_t)lidos);
+            memcpy(cauda + sizeof(cauda) - lidos, destino, (size_t)lidos);
+        }
+        if (guardado < sizeof(resposta)) {
+            guardado += (size_t)lidos;
+        }
+    }
+
+    //Status e, se houver, Content-Length ou Transfer-Encoding: chunked
+    int status = 0;
+    if (guardado < 12 || sscanf(resposta, "HTTP/1.%*d %d", &status) != 1) {
+        resultado = RESULTADO_INCOMPLETO;
+        goto fim;
+    }
+    if (status < 200 || status > 299) {
+        resultado = RESULTADO_HTTP;
+        goto fim;
+    }
+    const char *fim_cabecalho = memmem(resposta, guardado, "\r\n\r\n", 4);
+    const char *comprimento = memmem(resposta, fim_cabecalho ? (size_t)(fim_cabecalho - resposta) : guardado, "Content-Length:", 15);
+    if (!fim_cabecalho) {
+        resultado = RESULTADO_INCOMPLETO;
+    } else if (comprimento) {
+        uint64_t esperado = strtoull(comprimento + 15, NULL, 10);
+        uint64_t corpo = *bytes - (uint64_t)(fim_cabecalho + 4 - resposta);
+        if (corpo < esperado) {
+            resultado = RESULTADO_INCOMPLETO;
+        }
+    } else if (memmem(resposta, (size_t)(fim_cabecalho - resposta), "chunked", 7) &&
+               memcmp(cauda, "0\r\n\r\n", sizeof(cauda)) != 0) {
+        resultado = RESULTADO_INCOMPLETO;
+    }
+
+fim:
+    close(soquete);
+    *latencia_ms = (agoraS() - inicio) * 1000.0;
+    return resultado;
+}
+
+static void *executarCliente(void *argumento) {
+    Cliente *cliente = argumento;
+    double termino = inicio_s + config.duracao_s;
+    while (!parar && agoraS() < termino) {
+        if (config.limite_requisicoes &&
+            __atomic_fetch_add(&requisicoes_iniciadas, 1, __ATOMIC_RELAXED) >= config.limite_requisicoes) {
+            break;
+        }
+        unsigned indice = sortearCaminho(cliente);
+        double latencia;
+        uint64_t bytes;
+        Resultado resultado = requisitar(config.caminhos[indice].caminho, &latencia, &bytes);
+        cliente->resultados[resultado]++;
+        cliente->por_caminho[indice]++;
+        cliente->bytes += bytes;
+        if (resultado == RESULTADO_OK) {
+            if (cliente->quantidade == cliente->capacidade) {
+                cliente->capacidade = cliente->capacidade ? cliente->capacidade * 2 : 1024;
+                cliente->latencias_ms = realloc(cliente->latencias_ms, cliente->capacidade * sizeof(double));
+                if (!cliente->latencias_ms) {
+                    perror("realloc");
+                    exit(1);
+                }
+            }
+            cliente->latencias_ms[cliente->quantidade++] = latencia;
+        }
+        if (config.pausa_ms) {
+            usleep(config.pausa_ms * 1000u);
+        } else if (resultado == RESULTADO_CONEXAO) {
+            usleep(10000); //Sem PCB livre no servidor: não transformar a recusa em laço ocupado
+        }
+    }
+    return NULL;
+}
+
+static int compararDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static double percentil(const double *ordenadas, size_t quantidade, double fracao) {
+    if (!quantidade) {
+        return 0.0;
+    }
+    size_t indice = (size_t)(fracao * (quantidade - 1) + 0.5);
+    return ordenadas[indice];
+}
+
+static bool lerMistura(const char *texto) {
+    char copia[1024];
+    snprintf(copia, sizeof(copia), "%s", texto);
+    config.quantidade_caminhos = 0;
+    config.peso_total = 0;
+    for (char *item = strtok(copia, ","); item; item = strtok(NULL, ",")) {
+        if (config.quantidade_caminhos == MAX_CAMINHOS || item[0] != '/') {
+            return false;
+        }
+        Caminho *caminho = &config.caminhos[config.quantidade_caminhos++];
+        char *igual = strrchr(item, '=');
+        caminho->peso = 1;
+        //Um '=' seguido só de dígitos é o peso; senão faz parte da query string
+        if (igual && igual[1] && strspn(igual + 1, "0123456789") == strlen(igual + 1)) {
+            caminho->peso = (unsigned)atoi(igual + 1);
+            *igual = '\0';
+        }
+        snprintf(caminho->caminho, sizeof(caminho->caminho), "%s", item);
+        config.peso_total += caminho->peso;
+    }
+    return config.quantidade_caminhos && config.peso_total;
+}
+
+static bool resolver(const char *host, const char *porta) {
+    struct addrinfo dicas = {.ai_family = AF_UNSPEC, .ai_socktype = SOCK_STREAM}, *resultado;
+    if (getaddrinfo(host, porta, &dicas, &resultado) != 0) {
+        return false;
+    }
+    memcpy(&config.endereco, resultado->ai_addr, resultado->ai_addrlen);
+    config.tamanho_endereco = resultado->ai_addrlen;
+    freeaddrinfo(resultado);
+    snprintf(config.host, sizeof(config.host), "%s", host);
+    return true;
+}
+
+static void uso(const char *programa) {
+    fprintf(stderr,
+            "Uso: %s [-c clientes] [-d segundos] [-n requisicoes] [-p pausa_ms] [-t limite_ms]\n"
+            "          [-m \"/=4,/api/zona=2,/api/estatisticas=1\"] [--csv] [--max-erros pct] <ip> [porta]\n",
+            programa);
+}
+
+int main(int argc, char **argv) {
+    const char *host = NULL, *porta = "80";
+    bool csv = false;
+    double max_erros = -1.0;
+    lerMistura("/=4,/api/zona=2,/api/estatisticas=1,/api/metricas=1");
+
+    for (int i = 1; i < argc; i++) {
+        const char *opcao = argv[i];
+        bool tem_valor = i + 1 < argc;
+        if (strcmp(opcao, "-c") == 0 && tem_valor) {
+            config.clientes = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(opcao, "-d") == 0 && tem_valor) {
+            config.duracao_s = atof(argv[++i]);
+        } else if (strcmp(opcao, "-n") == 0 && tem_valor) {
+            config.limite_requisicoes = strtoull(argv[++i], NULL, 10);
+        } else if (strcmp(opcao, "-p") == 0 && tem_valor) {
+            config.pausa_ms = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(opcao, "-t") == 0 && tem_valor) {
+            config.tempo_limite_ms = (unsigned)atoi(argv[++i]);
+        } else if (strcmp(opcao, "-m") == 0 && tem_valor) {
+            if (!lerMistura(argv[++i])) {
+                fprintf(stderr, "Mistura invalida: %s\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(opcao, "--csv") == 0) {
+            csv = true;
+        } else if (strcmp(opcao, "--max-erros") == 0 && tem_valor) {
+            max_erros = atof(argv[++i]);
+        } else if (opcao[0] == '-') {
+            uso(argv[0]);
+            return 1;
+        } else if (!host) {
+            host = opcao;
+        } else {
+            porta = opcao;
+        }
+    }
+    if (!host || !config.clientes || config.duracao_s <= 0) {
+        uso(argv[0]);
+        return 1;
+    }
+    if (!resolver(host, porta)) {
+        fprintf(stderr, "Nao foi possivel resolver %s:%s\n", host, porta);
+        return 1;
+    }
+
+    Cliente *clientes = calloc(config.clientes, sizeof(Cliente));
+    if (!clientes) {
+        perror("calloc");
+        return 1;
+    }
+    inicio_s = agoraS();
+    for (unsigned i = 0; i < config.clientes; i++) {
+        clientes[i].indice = i;
+        clientes[i].semente = 0x9E3779B9u ^ (i * 2654435761u) ^ (uint32_t)time(NULL);
+        if (!clientes[i].semente) {
+            clientes[i].semente = 1;
+        }
+        if (pthread_create(&clientes[i].thread, NULL, executarCliente, &clientes[i]) != 0) {
+            perror("pthread_create");
+            parar = true;
+            config.clientes = i;
+            break;
+        }
+    }
+
+    //Junta os resultados de todos os clientes
+    uint64_t resultados[RESULTADOS] = {0}, por_caminho[MAX_CAMINHOS] = {0}, bytes = 0;
+    size_t total_latencias = 0;
+    for (unsigned i = 0; i < config.clientes; i++) {
+        pthread_join(clientes[i].thread, NULL);
+        total_latencias += clientes[i].quantidade;
+    }
+    double decorrido = agoraS() - inicio_s;
+    double *latencias = malloc((total_latencias ? total_latencias : 1) * sizeof(double));
+    size_t posicao = 0;
+    for (unsigned i = 0; i < config.clientes; i++) {
+        for (int r = 0; r < RESULTADOS; r++) resultados[r] += clientes[i].resultados[r];
+        for (unsigned c = 0; c < config.quantidade_caminhos; c++) por_caminho[c] += clientes[i].por_caminho[c];
+        bytes += clientes[i].bytes;
+        memcpy(latencias + posicao, clientes[i].latencias_ms, clientes[i].quantidade * sizeof(double));
+        posicao += clientes[i].quantidade;
+        free(clientes[i].latencias_ms);
+    }
+    qsort(latencias, total_latencias, sizeof(double), compararDouble);
+
+    uint64_t total = 0;
+    for (int r = 0; r < RESULTADOS; r++) total += resultados[r];
+    uint64_t erros = total - resultados[RESULTADO_OK];
+    double taxa_erros = total ? 100.0 * erros / total : 0.0;
+    double vazao = resultados[RESULTADO_OK] / decorrido;
+    double media = 0.0;
+    for (size_t i = 0; i < total_latencias; i++) media += latencias[i];
+    media = total_latencias ? media / total_latencias : 0.0;
+    double p50 = percentil(latencias, total_latencias, 0.50);
+    double p99 = percentil(latencias, total_latencias, 0.99);
+    double p999 = percentil(latencias, total_latencias, 0.999);
+    double maximo = total_latencias ? latencias[total_latencias - 1] : 0.0;
+
+    if (csv) {
+        printf("clientes,duracao_s,requisicoes,ok,req_s,kb_s,lat_media_ms,p50_ms,p99_ms,p999_ms,max_ms");
+        for (int r = 1; r < RESULTADOS; r++) printf(",%s", NOMES_RESULTADO[r]);
+        printf(",taxa_erros_pct\n");
+        printf("%u,%.2f,%llu,%llu,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f,%.3f", config.clientes, decorrido,
+               (unsigned long long)total, (unsigned long long)resultados[RESULTADO_OK], vazao,
+               bytes / 1024.0 / decorrido, media, p50, p99, p999, maximo);
+        for (int r = 1; r < RESULTADOS; r++) printf(",%llu", (unsigned long long)resultados[r]);
+        printf(",%.3f\n", taxa_erros);
+    } else {
+        printf("Alvo %s:%s, %u clientes, %.1f s\n", host, porta, config.clientes, decorrido);
+        printf("Requisicoes: %llu (%llu ok), %.1f req/s, %.1f KB/s\n", (unsigned long long)total,
+               (unsigned long long)resultados[RESULTADO_OK], vazao, bytes / 1024.0 / decorrido);
+        printf("Latencia (ms): media %.2f  p50 %.2f  p99 %.2f  p999 %.2f  max %.2f\n", media, p50, p99, p999, maximo);
+        printf("Erros: %.2f %%", taxa_erros);
+        for (int r = 1; r < RESULTADOS; r++) printf("  %s %llu", NOMES_RESULTADO[r], (unsigned long long)resultados[r]);
+        printf("\nPor caminho:");
+        for (unsigned c = 0; c < config.quantidade_caminhos; c++) {
+            printf("  %s %llu", config.caminhos[c].caminho, (unsigned long long)por_caminho[c]);
+        }
+        printf("\n");
+    }
+
+    free(latencias);
+    free(clientes);
+    return max_erros >= 0 && taxa_erros > max_erros ? 2 : 0;
+}
@@ -0,0 +1,183 @@
+#!/usr/bin/env python3
+"""Compila um modelo HTML em um cabeçalho C para lib/Web/modelo_web.
+
+Uso: compilar_modelo.py <modelo.html> <nome> <saida.h>
+
+Sintaxe do modelo:
+  {{campo:s}}    texto (ValorCampo.texto)
+  {{campo:i}}    inteiro (ValorCampo.numero)
+  {{campo:.N}}   decimal com N casas (1 a 3), ValorCampo.numero escalado por 10^N
+  {{#campo}}...{{/campo}}  seção incluída se o campo for diferente de zero
+  {{^campo}}...{{/campo}}  seção incluída se o campo for zero
+Uma linha que só contém uma marca de seção é removida por inteiro.
+
+Gera um enum <NOME>_<CAMPO> (mais <NOME>_CAMPOS), o texto constante e a lista
+de passos, prontos para modelo_web_renderizar.
+"""
+
+import re
+import sys
+
+MARCA = re.compile(r"\{\{([#^/]?)([a-z_][a-z0-9_]*)(?::([^}]*))?\}\}")
+FORMATOS = {"s": "FORMATO_TEXTO", "i": "FORMATO_INTEIRO",
+            ".1": "FORMATO_DECIMAL_1", ".2": "FORMATO_DECIMAL_2", ".3": "FORMATO_DECIMAL_3"}
+
+
+class ErroModelo(Exception):
+    pass
+
+
+def linha_de(fonte, posicao):
+    return fonte.count("\n", 0, posicao) + 1
+
+
+def remover_linhas_de_secao(fonte):
+    """Remove linhas que contêm apenas uma marca de seção, mantendo a marca."""
+    saida = []
+    for linha in fonte.splitlines(keepends=True):
+        marca = MARCA.fullmatch(linha.strip())
+        if marca and marca.group(1):
+            saida.append(linha.strip())
+        else:
+            saida.append(linha)
+    return "".join(saida)
+
+
+def compilar(fonte):
+    fonte = remover_linhas_de_secao(fonte)
+    texto = bytearray()
+    passos = []          # [tipo, formato, argumento, tamanho]
+    campos = {}          # nome -> índice
+    formatos = {}        # nome -> formato usado em {{campo:fmt}}
+    abertas = []         # (nome, índice do passo de seção)
+    fronteira = [len(passos)]  # Passos antes desta posição não podem crescer (seção já fechada)
+
+    def campo(nome):
+        if nome not in campos:
+            campos[nome] = len(campos)
+        return campos[nome]
+
+    def anexar_texto(trecho):
+        if not trecho:
+            return
+        dados = trecho.encode("utf-8")
+        if len(passos) > fronteira[0] and passos[-1][0] == "PASSO_TEXTO":
+            passos[-1][3] += len(dados)
+        else:
+            passos.append(["PASSO_TEXTO", "FORMATO_TEXTO", len(texto), len(dados)])
+        texto.extend(dados)
+
+    posicao = 0
+    for marca in MARCA.finditer(fonte):
+        anexar_texto(fonte[posicao:marca.start()])
+        posicao = marca.end()
+        tipo, nome, formato = marca.groups()
+        linha = linha_de(fonte, marca.start())
+
+        if tipo in ("#", "^"):
+            passos.append(["PASSO_SECAO" if tipo == "#" else "PASSO_SECAO_INVERSA", "FORMATO_TEXTO", campo(nome), 0])
+            abertas.append((nome, len(passos) - 1))
+        elif tipo == "/":
+            if not abertas or abertas[-1][0] != nome:
+                raise ErroModelo(f"linha {linha}: {{{{/{nome}}}}} sem seção aberta correspondente")
+            _, inicio = abertas.pop()
+            passos[inicio][3] = len(passos) - inicio - 1
+            fronteira[0] = len(passos)
+        else:
+            if formato not in FORMATOS:
+                raise ErroModelo(f"linha {linha}: formato '{formato}' inválido em {{{{{nome}}}}} (use s, i, .1, .2 ou .3)")
+            if formatos.setdefault(nome, formato) != formato:
+                raise ErroModelo(f"linha {linha}: campo '{nome}' usado com formatos diferentes")
+            passos.append(["PASSO_CAMPO", FORMATOS[formato], campo(nome), 0])
+
+    anexar_texto(fonte[posicao:])
+    if abertas:
+        raise ErroModelo(f"seção '{abertas[-1][0]}' não fechada")
+    if len(texto) > 0xFFFF or len(passos) > 0xFFFF:
+        raise ErroModelo("modelo grande demais para posições de 16 bits")
+    return bytes(texto), passos, campos
+
+
+def literal_c(dados):
+    """Literal C com uma linha por linha do HTML; bytes fora do ASCII em octal."""
+    linhas, atual = [], []
+    for byte in dados:
+        if byte == ord("\n"):
+            atual.append("\\n")
+            linhas.append("".join(atual))
+            atual = []
+        elif byte == ord('"'):
+            atual.append('\\"')
+        elif byte == ord("\\"):
+            atual.append("\\\\")
+        elif 0x20 <= byte < 0x7F and byte != ord("?"):
+            atual.append(chr(byte))
+        else:
+            atual.append(f"\\{byte:03o}")
+    if atual:
+        linhas.append("".join(atual))
+    return "\n".join(f'    "{linha}"' for linha in linhas) or '    ""'
+
+
+def gerar(nome, origem, texto, passos, campos):
+    prefixo = nome.upper()
+    guarda = f"MODELO_{prefixo}_H"
+    saida = [
+        f"//Gerado por ferramentas/compilar_modelo.py a partir de {origem}; não editar",
+        f"#ifndef {guarda}",
+        f"#define {guarda}",
+        "",
+        '#include "lib/Web/modelo_web.h"',
+        "",
+        "enum {",
+    ]
+    saida += [f"    {prefixo}_{campo.upper()}," for campo in campos]
+    saida += [
+        f"    {prefixo}_CAMPOS",
+        "};",
+        "",
+        f"static const char modelo_{nome}_texto[] =",
+        literal_c(texto) + ";",
+        "",
+        f"static const PassoModelo modelo_{nome}_passos[] = {{",
+    ]
+    saida += [f"    {{{tipo}, {formato}, {argumento}, {tamanho}}}," for tipo, formato, argumento, tamanho in passos]
+    saida += [
+        "};",
+        "",
+        f"static const ModeloWeb modelo_{nome} = {{",
+        f"    modelo_{nome}_texto,",
+        f"    modelo_{nome}_passos,",
+        f"    sizeof(modelo_{nome}_passos) / sizeof(modelo_{nome}_passos[0]),",
+        f"    {prefixo}_CAMPOS,",
+        "};",
+        "",
+        f"#endif // {guarda}",
+        "",
+    ]
+    return "\n".join(saida)
+
+
+def main():
+    if len(sys.argv) != 4:
+        print(__doc__, file=sys.stderr)
+        return 1
+    caminho, nome, destino = sys.argv[1:]
+    if not re.fullmatch(r"[a-z_][a-z0-9_]*", nome):
+        print(f"nome '{nome}' inválido", file=sys.stderr)
+        return 1
+    with open(caminho, encoding="utf-8") as arquivo:
+        fonte = arquivo.read()
+    try:
+        texto, passos, campos = compilar(fonte)
+    except ErroModelo as erro:
+        print(f"{caminho}: {erro}", file=sys.stderr)
+        return 1
+    cabecalho = gerar(nome, caminho.replace("\\", "/").split("/")[-1], texto, passos, campos)
+    with open(destino, "w", encoding="utf-8", newline="\n") as arquivo:
+        arquivo.write(cabecalho)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
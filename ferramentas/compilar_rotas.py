@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Compila a lista de rotas HTTP em um cabeçalho C para lib/Web/rotas.
+
+Uso: compilar_rotas.py <rotas.txt> <saida.h>
+
+Cada linha não vazia (fora os comentários com #) tem MÉTODO, caminho e ROTA.
+Várias linhas podem apontar para a mesma ROTA (ex.: PUT e POST do mesmo recurso).
+
+Gera o enum RotaHttp (ROTA_INEXISTENTE, ROTA_METODO_INVALIDO e uma ROTA_<NOME>
+por rota, na ordem do arquivo) e uma tabela endereçada por hash perfeito: a
+semente do FNV-1a é procurada aqui até que "MÉTODO caminho" de todas as linhas
+caia em posições distintas, então o firmware resolve uma requisição com um hash
+e uma única comparação. A função de hash precisa ser idêntica à de rotas.c.
+"""
+
+import re
+import sys
+
+LINHA = re.compile(r"([A-Z]+)\s+(/\S*)\s+([A-Z][A-Z0-9_]*)")
+FNV_PRIMO = 16777619
+TENTATIVAS_POR_TAMANHO = 1 << 16
+
+
+class ErroRotas(Exception):
+    pass
+
+
+def ler(fonte):
+    rotas = []     # (método, caminho, nome)
+    vistas = set()
+    for numero, linha in enumerate(fonte.splitlines(), 1):
+        linha = linha.split("#", 1)[0].strip()
+        if not linha:
+            continue
+        campos = LINHA.fullmatch(linha)
+        if not campos:
+            raise ErroRotas(f"linha {numero}: esperado 'MÉTODO /caminho ROTA'")
+        metodo, caminho, nome = campos.groups()
+        if "?" in caminho or len(metodo) + 1 + len(caminho) > 0xFF:
+            raise ErroRotas(f"linha {numero}: caminho inválido")
+        if (metodo, caminho) in vistas:
+            raise ErroRotas(f"linha {numero}: {metodo} {caminho} repetido")
+        vistas.add((metodo, caminho))
+        rotas.append((metodo, caminho, nome))
+    if not rotas:
+        raise ErroRotas("nenhuma rota")
+    return rotas
+
+
+def hash_rota(semente, chave):
+    valor = semente
+    for byte in chave:
+        valor = ((valor ^ byte) * FNV_PRIMO) & 0xFFFFFFFF
+    return valor ^ (valor >> 16)
+
+
+def procurar_semente(chaves):
+    """Menor tabela (potência de 2, ao menos o dobro das rotas) com semente sem colisão."""
+    posicoes = 1
+    while posicoes < 2 * len(chaves):
+        posicoes *= 2
+    while posicoes <= 1 << 12:
+        for tentativa in range(TENTATIVAS_POR_TAMANHO):
+            semente = (2166136261 + tentativa * 0x9E3779B9) & 0xFFFFFFFF  # Parte da base do FNV-1a
+            indices = {hash_rota(semente, chave) & (posicoes - 1) for chave in chaves}
+            if len(indices) == len(chaves):
+                return semente, posicoes
+        posicoes *= 2
+    raise ErroRotas("nenhuma semente sem colisão encontrada")
+
+
+def gerar(origem, rotas):
+    chaves = [f"{metodo} {caminho}".encode("ascii") for metodo, caminho, _ in rotas]
+    semente, posicoes = procurar_semente(chaves)
+    nomes = list(dict.fromkeys(nome for _, _, nome in rotas))
+    metodos = list(dict.fromkeys(metodo for metodo, _, _ in rotas))
+
+    tabela = {}
+    for (metodo, caminho, nome), chave in zip(rotas, chaves):
+        tabela[hash_rota(semente, chave) & (posicoes - 1)] = (metodo, caminho, nome)
+
+    saida = [
+        f"//Gerado por ferramentas/compilar_rotas.py a partir de {origem}; não editar",
+        "#ifndef ROTAS_GERADAS_H",
+        "#define ROTAS_GERADAS_H",
+        "",
+        "typedef enum {",
+        "    ROTA_INEXISTENTE,",
+        "    ROTA_METODO_INVALIDO, //O caminho existe com outro método",
+    ]
+    saida += [f"    ROTA_{nome}," for nome in nomes]
+    saida += [
+        "    ROTAS",
+        "} RotaHttp;",
+        "",
+        f"#define ROTAS_SEMENTE  0x{semente:08X}u",
+        f"#define ROTAS_POSICOES {posicoes}",
+        f"#define ROTAS_METODOS  {len(metodos)}",
+        "",
+        "#ifdef ROTAS_TABELA",
+        "static const EntradaRota TABELA_ROTAS[ROTAS_POSICOES] = {",
+    ]
+    for indice in sorted(tabela):
+        metodo, caminho, nome = tabela[indice]
+        saida.append(f'    [{indice}] = {{"{metodo} {caminho}", {len(metodo)}, {len(metodo) + 1 + len(caminho)}, ROTA_{nome}}},')
+    saida += [
+        "};",
+        "",
+        "static const char *const METODOS_ROTAS[ROTAS_METODOS] = {" + ", ".join(f'"{m}"' for m in metodos) + "};",
+        "#endif",
+        "",
+        "#endif // ROTAS_GERADAS_H",
+        "",
+    ]
+    return "\n".join(saida)
+
+
+def main():
+    if len(sys.argv) != 3:
+        print(__doc__, file=sys.stderr)
+        return 1
+    caminho, destino = sys.argv[1:]
+    with open(caminho, encoding="utf-8") as arquivo:
+        fonte = arquivo.read()
+    try:
+        cabecalho = gerar(caminho.replace("\\", "/").split("/")[-1], ler(fonte))
+    except ErroRotas as erro:
+        print(f"{caminho}: {erro}", file=sys.stderr)
+        return 1
+    with open(destino, "w", encoding="utf-8", newline="\n") as arquivo:
+        arquivo.write(cabecalho)
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
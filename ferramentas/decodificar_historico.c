@@ -0,0 +1,57 @@
+//Decodificador no host da exportação binária do histórico
+//Uso: curl -o historico.bin "http://<ip>/api/history?format=bin&from=-3600"
+//     decodificar_historico historico.bin > historico.csv
+//Sem arquivo, lê da entrada padrão. O resumo de compressão vai para stderr
+
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include "codec_amostras.h"
+
+#define TAMANHO_MAXIMO_BLOCO 4096 //Maior bloco aceito (o firmware usa 512 bytes)
+
+int main(int argc, char **argv) {
+    FILE *entrada = argc > 1 ? fopen(argv[1], "rb") : stdin;
+    if (!entrada) {
+        perror(argv[1]);
+        return 1;
+    }
+
+    char assinatura[4];
+    if (fread(assinatura, 1, sizeof(assinatura), entrada) != sizeof(assinatura) || memcmp(assinatura, "TGH1", 4) != 0) {
+        fprintf(stderr, "Formato desconhecido: esperado cabecalho TGH1\n");
+        return 1;
+    }
+
+    printf("tempo,temperatura,umidade,pwm,setpoint,ligado\n");
+    static uint8_t bloco[TAMANHO_MAXIMO_BLOCO];
+    unsigned long amostras = 0, blocos = 0, bytes = sizeof(assinatura);
+    uint8_t tamanhos[4];
+    while (fread(tamanhos, 1, sizeof(tamanhos), entrada) == sizeof(tamanhos)) {
+        uint16_t quantidade = tamanhos[0] | tamanhos[1] << 8;
+        uint16_t tamanho = tamanhos[2] | tamanhos[3] << 8;
+        if (tamanho > sizeof(bloco) || fread(bloco, 1, tamanho, entrada) != tamanho) {
+            fprintf(stderr, "Bloco %lu truncado\n", blocos);
+            return 1;
+        }
+
+        DecodificadorAmostras decodificador;
+        Amostra amostra;
+        codec_iniciar_decodificador(&decodificador, bloco, tamanho, quantidade);
+        while (codec_decodificar(&decodificador, &amostra)) {
+            printf("%lu,%.2f,%.1f,%u,%.1f,%u\n", (unsigned long)amostra.tempo_s, amostra.temperatura_centi / 100.0,
+                   amostra.umidade_deci / 10.0, amostra.ciclo_pwm, amostra.setpoint_deci / 10.0, amostra.ligado);
+            amostras++;
+        }
+        if (decodificador.decodificadas != quantidade) {
+            fprintf(stderr, "Bloco %lu corrompido\n", blocos);
+            return 1;
+        }
+        blocos++;
+        bytes += sizeof(tamanhos) + tamanho;
+    }
+
+    fprintf(stderr, "%lu amostras em %lu blocos, %lu bytes (%.2f bytes/amostra)\n",
+            amostras, blocos, bytes, amostras ? (double)bytes / amostras : 0.0);
+    return 0;
+}
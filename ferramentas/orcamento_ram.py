@@ -0,0 +1,175 @@
+#!/usr/bin/env python3
+"""Orçamento de RAM por módulo a partir do mapa do linker (.elf.map).
+
+Uso: orcamento_ram.py <firmware.elf.map> [--simbolos N] [--ram INICIO FIM]
+
+Soma as seções de entrada que caem na SRAM (por padrão a do RP2040,
+0x20000000 a 0x20042000) e agrupa por módulo: cada diretório de lib/, o
+main.c, FreeRTOS, lwIP, cyw43, TinyUSB, Pico SDK e a biblioteca C. O heap da newlib e
+as pilhas dos núcleos aparecem em linhas próprias. Com --simbolos N lista os
+N maiores objetos estáticos de cada módulo.
+"""
+
+import re
+import sys
+
+RAM_RP2040 = (0x20000000, 0x20042000)
+
+SECAO_SAIDA = re.compile(r"^(\.[\w.]+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)")
+SECAO_ENTRADA = re.compile(r"^ (\S+)\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+)$")
+NOME_SOZINHO = re.compile(r"^ (\.\S+|COMMON)$")
+CONTINUACAO = re.compile(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)\s+(.+)$")
+PREENCHIMENTO = re.compile(r"^ \*fill\*\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)")
+
+#Seções de saída com significado próprio no linker script do Pico SDK
+SECOES_ESPECIAIS = {
+    ".heap": "heap da newlib (malloc)",
+    ".stack_dummy": "pilha do núcleo 0 (main e interrupções)",
+    ".stack1_dummy": "pilha do núcleo 1",
+}
+
+
+def modulo_de(objeto):
+    caminho = objeto.replace("\\", "/")
+    minusculo = caminho.lower()
+    #Módulos do projeto primeiro, pelo caminho relativo logo após o .dir/ (lib/Metricas/metricas_lwip.c
+    #é do projeto); as fontes do SDK entram com o caminho absoluto e caem nas palavras-chave abaixo
+    projeto = re.search(r"\.dir/(lib/[^/]+)/[^/]+$", caminho)
+    if projeto:
+        return projeto.group(1)
+    for chave, nome in (("freertos", "FreeRTOS"), ("lwip", "lwIP"), ("cyw43", "cyw43"),
+                        ("btstack", "btstack"), ("tinyusb", "TinyUSB"), ("mbedtls", "mbedTLS")):
+        if chave in minusculo:
+            return nome
+    if re.search(r"\.dir/[^/]+\.c\.o(bj)?$", caminho):
+        return caminho.rsplit("/", 1)[-1].split(".c.o")[0] + ".c"
+    if re.search(r"lib(c|g|m|gcc|nosys|stdc\+\+)(_nano)?\.a", caminho):
+        return "biblioteca C"
+    if "pico" in minusculo or "rp2_common" in minusculo or "rp2040" in minusculo:
+        return "Pico SDK"
+    return "outros"
+
+
+def simbolo_de(secao):
+    for prefixo in (".bss.", ".data.", ".sbss.", ".sdata.", ".uninitialized_data.",
+                    ".scratch_x.", ".scratch_y.", ".time_critical."):
+        if secao.startswith(prefixo):
+            return secao[len(prefixo):]
+    return secao
+
+
+def ler_mapa(linhas, inicio_ram, fim_ram):
+    """Devolve {módulo: {símbolo: bytes}} das seções alocadas na RAM."""
+    modulos = {}
+    saida_na_ram = False
+    saida_especial = None
+    pendente = None
+    no_mapa = False
+
+    def somar(modulo, simbolo, tamanho):
+        if tamanho:
+            simbolos = modulos.setdefault(modulo, {})
+            simbolos[simbolo] = simbolos.get(simbolo, 0) + tamanho
+
+    for linha in linhas:
+        linha = linha.rstrip("\n")
+        if not no_mapa:
+            no_mapa = linha.startswith("Linker script and memory map")
+            continue
+        saida = SECAO_SAIDA.match(linha)
+        if saida:
+            nome, endereco, tamanho = saida.group(1), int(saida.group(2), 16), int(saida.group(3), 16)
+            saida_na_ram = inicio_ram <= endereco < fim_ram
+            saida_especial = SECOES_ESPECIAIS.get(nome)
+            pendente = None
+            if saida_na_ram and saida_especial:
+                somar(saida_especial, nome, tamanho)
+            continue
+        if re.match(r"^\.[\w.]+$", linha):
+            #Seção de saída com nome longo: endereço e tamanho vêm na linha seguinte
+            saida_na_ram, saida_especial, pendente = False, SECOES_ESPECIAIS.get(linha), ("saida", linha)
+            continue
+        if pendente and pendente[0] == "saida":
+            continuacao = re.match(r"^\s+(0x[0-9a-fA-F]+)\s+(0x[0-9a-fA-F]+)", linha)
+            pendente_nome = pendente[1]
+            pendente = None
+            if continuacao:
+                endereco, tamanho = int(continuacao.group(1), 16), int(continuacao.group(2), 16)
+                saida_na_ram = inicio_ram <= endereco < fim_ram
+                if saida_na_ram and saida_especial:
+                    somar(saida_especial, pendente_nome, tamanho)
+                continue
+        if not saida_na_ram or saida_especial:
+            continue
+
+        entrada = SECAO_ENTRADA.match(linha)
+        if entrada and entrada.group(1) != "*fill*":
+            secao, endereco, tamanho, objeto = entrada.groups()
+            if inicio_ram <= int(endereco, 16) < fim_ram:
+                somar(modulo_de(objeto), simbolo_de(secao), int(tamanho, 16))
+            pendente = None
+            continue
+        sozinho = NOME_SOZINHO.match(linha)
+        if sozinho:
+            pendente = ("entrada", sozinho.group(1))
+            continue
+        if pendente and pendente[0] == "entrada":
+            continuacao = CONTINUACAO.match(linha)
+            if continuacao:
+                endereco, tamanho, objeto = continuacao.groups()
+                if inicio_ram <= int(endereco, 16) < fim_ram:
+                    somar(modulo_de(objeto), simbolo_de(pendente[1]), int(tamanho, 16))
+            pendente = None
+            continue
+        preenchimento = PREENCHIMENTO.match(linha)
+        if preenchimento and inicio_ram <= int(preenchimento.group(1), 16) < fim_ram:
+            somar("alinhamento", "*fill*", int(preenchimento.group(2), 16))
+    return modulos
+
+
+def main():
+    argumentos = sys.argv[1:]
+    quantidade_simbolos = 0
+    inicio_ram, fim_ram = RAM_RP2040
+    caminho = None
+    try:
+        while argumentos:
+            argumento = argumentos.pop(0)
+            if argumento == "--simbolos":
+                quantidade_simbolos = int(argumentos.pop(0))
+            elif argumento == "--ram":
+                inicio_ram, fim_ram = int(argumentos.pop(0), 0), int(argumentos.pop(0), 0)
+            elif caminho is None and not argumento.startswith("-"):
+                caminho = argumento
+            else:
+                raise ValueError(argumento)
+    except (IndexError, ValueError):
+        caminho = None
+    if caminho is None:
+        print(__doc__, file=sys.stderr)
+        return 1
+
+    with open(caminho, encoding="utf-8", errors="replace") as arquivo:
+        modulos = ler_mapa(arquivo, inicio_ram, fim_ram)
+    if not modulos:
+        print(f"{caminho}: nenhuma seção na RAM 0x{inicio_ram:08x}-0x{fim_ram:08x}", file=sys.stderr)
+        return 1
+
+    capacidade = fim_ram - inicio_ram
+    totais = sorted(((sum(s.values()), m) for m, s in modulos.items()), reverse=True)
+    total = sum(t for t, _ in totais)
+    print(f"Orçamento de RAM ({caminho.replace(chr(92), '/').split('/')[-1]})")
+    print(f"{'módulo':<42}{'bytes':>9}{'%RAM':>7}")
+    for tamanho, modulo in totais:
+        print(f"{modulo:<42}{tamanho:>9}{100.0 * tamanho / capacidade:>6.1f}%")
+        if quantidade_simbolos:
+            maiores = sorted(modulos[modulo].items(), key=lambda item: item[1], reverse=True)
+            for simbolo, bytes_simbolo in maiores[:quantidade_simbolos]:
+                print(f"    {simbolo:<38}{bytes_simbolo:>9}")
+    print(f"{'total':<42}{total:>9}{100.0 * total / capacidade:>6.1f}%")
+    print(f"{'livre':<42}{capacidade - total:>9}{100.0 * (capacidade - total) / capacidade:>6.1f}%")
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
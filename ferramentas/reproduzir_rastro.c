@@ -0,0 +1,107 @@
+//Reprodução de rastros gravados pelo firmware (PUT /api/rastro?gravar=1)
+//Uso: reproduzir_rastro [--tolerancia n] [arquivo]
+//Lê a saída serial (arquivo ou stdin), usa só as linhas "rastro <hex>" e
+//executa cada período com o mesmo passo de controle do firmware, comparando o
+//PWM de todas as zonas e o alarme com os valores gravados. Termina com 0 se
+//tudo coincidiu, 1 se houve divergência e 2 se o rastro estiver malformado
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lib/Rastro/rastro.h"
+
+#define PREFIXO_RASTRO "rastro "
+
+static double agoraS(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static int valorHex(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    return -1;
+}
+
+//Decodifica o hex da linha; retorna o número de bytes ou -1 se inválido
+static long decodificarLinha(const char *texto, uint8_t *destino, size_t capacidade) {
+    size_t bytes = 0;
+    while (texto[0] && texto[0] != '\n' && texto[0] != '\r') {
+        int alto = valorHex(texto[0]);
+        int baixo = alto < 0 ? -1 : valorHex(texto[1]);
+        if (baixo < 0 || bytes >= capacidade) {
+            return -1;
+        }
+        destino[bytes++] = (uint8_t)(alto << 4 | baixo);
+        texto += 2;
+    }
+    return (long)bytes;
+}
+
+int main(int argc, char **argv) {
+    long tolerancia = 0;
+    const char *caminho = NULL;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--tolerancia") == 0 && i + 1 < argc) {
+            tolerancia = strtol(argv[++i], NULL, 10);
+        } else if (argv[i][0] != '-' && !caminho) {
+            caminho = argv[i];
+        } else {
+            caminho = NULL;
+            tolerancia = -1;
+            break;
+        }
+    }
+    if (tolerancia < 0 || tolerancia > UINT16_MAX) {
+        fprintf(stderr, "Uso: %s [--tolerancia n] [arquivo]\n", argv[0]);
+        return 2;
+    }
+
+    FILE *entrada = caminho ? fopen(caminho, "r") : stdin;
+    if (!entrada) {
+        perror(caminho);
+        return 2;
+    }
+
+    static ReprodutorRastro reprodutor;
+    rastro_reprodutor_iniciar(&reprodutor, (uint16_t)tolerancia);
+
+    //Uma linha carrega no máximo um bloco do gravador (dois dígitos por byte)
+    static char linha[2 * RASTRO_BLOCO_MAX + sizeof(PREFIXO_RASTRO) + 2];
+    static uint8_t bloco[RASTRO_BLOCO_MAX];
+    unsigned long numero = 0, linhas_rastro = 0, bytes = 0;
+    double inicio = agoraS();
+    while (fgets(linha, sizeof(linha), entrada)) {
+        numero++;
+        const char *dados = strstr(linha, PREFIXO_RASTRO);
+        if (!dados) {
+            continue;
+        }
+        long tamanho = decodificarLinha(dados + strlen(PREFIXO_RASTRO), bloco, sizeof(bloco));
+        if (tamanho < 0 || !rastro_reproduzir(&reprodutor, bloco, (size_t)tamanho)) {
+            fprintf(stderr, "Linha %lu: rastro malformado\n", numero);
+            return 2;
+        }
+        linhas_rastro++;
+        bytes += (unsigned long)tamanho;
+    }
+    rastro_reprodutor_concluir(&reprodutor);
+    double decorrido = agoraS() - inicio;
+    if (caminho) {
+        fclose(entrada);
+    }
+
+    printf("Passos:       %lu (%lu linhas, %lu bytes, %.1f bytes/passo)\n", (unsigned long)reprodutor.passos,
+           linhas_rastro, bytes, reprodutor.passos ? (double)bytes / reprodutor.passos : 0.0);
+    printf("Divergencias: %lu\n", (unsigned long)reprodutor.divergencias);
+    if (reprodutor.divergencias) {
+        printf("Primeira:     %.3f s\n", reprodutor.primeira_divergencia_ms / 1000.0);
+    }
+    printf("Maior dPWM:   %u\n", reprodutor.maior_diferenca_pwm);
+    fprintf(stderr, "%.0f s gravados reproduzidos em %.3f s (%.0f ns/passo)\n", reprodutor.tempo_ms / 1000.0,
+            decorrido, reprodutor.passos ? decorrido * 1e9 / reprodutor.passos : 0.0);
+    return reprodutor.divergencias ? 1 : 0;
+}
@@ -0,0 +1,13 @@
+#ifndef SDK_SIMULADO_HARDWARE_CLOCKS_H
+#define SDK_SIMULADO_HARDWARE_CLOCKS_H
+
+#include "pico/stdlib.h"
+
+enum clock_index { clk_sys };
+
+static inline uint32_t clock_get_hz(enum clock_index relogio) {
+    (void)relogio;
+    return 125000000u;
+}
+
+#endif
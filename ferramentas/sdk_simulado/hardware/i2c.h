@@ -0,0 +1,24 @@
+#ifndef SDK_SIMULADO_HARDWARE_I2C_H
+#define SDK_SIMULADO_HARDWARE_I2C_H
+
+#include "pico/stdlib.h"
+
+typedef struct i2c_inst i2c_inst_t;
+
+//Sumidouro das escritas, definido por quem usa o SDK simulado; encerra indica o STOP
+//(uma escrita em burst continua a mesma transação na chamada seguinte)
+void sdk_simulado_i2c_escrita(uint8_t endereco, const uint8_t *dados, size_t tamanho, bool encerra);
+
+static inline int i2c_write_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t tamanho, bool sem_parada) {
+    (void)i2c;
+    sdk_simulado_i2c_escrita(endereco, dados, tamanho, !sem_parada);
+    return (int)tamanho;
+}
+
+static inline int i2c_write_burst_blocking(i2c_inst_t *i2c, uint8_t endereco, const uint8_t *dados, size_t tamanho) {
+    (void)i2c;
+    sdk_simulado_i2c_escrita(endereco, dados, tamanho, false);
+    return (int)tamanho;
+}
+
+#endif
@@ -0,0 +1,43 @@
+#ifndef SDK_SIMULADO_HARDWARE_PIO_H
+#define SDK_SIMULADO_HARDWARE_PIO_H
+
+#include "pico/stdlib.h"
+
+typedef struct pio_simulado *PIO;
+#define pio0 ((PIO)0)
+
+struct pio_program {
+    const uint16_t *instructions;
+    uint8_t length;
+    int8_t origin;
+    uint8_t pio_version;
+};
+
+typedef struct {
+    uint32_t reservado;
+} pio_sm_config;
+
+enum pio_fifo_join { PIO_FIFO_JOIN_NONE, PIO_FIFO_JOIN_TX, PIO_FIFO_JOIN_RX };
+
+//Sumidouro das palavras enviadas à máquina de estados
+void sdk_simulado_pio_palavra(uint sm, uint32_t palavra);
+
+static inline void pio_sm_put_blocking(PIO pio, uint sm, uint32_t palavra) {
+    (void)pio;
+    sdk_simulado_pio_palavra(sm, palavra);
+}
+
+static inline uint pio_add_program(PIO pio, const struct pio_program *programa) { (void)pio; (void)programa; return 0; }
+static inline pio_sm_config pio_get_default_sm_config(void) { pio_sm_config c = {0}; return c; }
+static inline void sm_config_set_wrap(pio_sm_config *c, uint alvo, uint fim) { (void)c; (void)alvo; (void)fim; }
+static inline void sm_config_set_sideset(pio_sm_config *c, uint bits, bool opcional, bool pindirs) { (void)c; (void)bits; (void)opcional; (void)pindirs; }
+static inline void sm_config_set_sideset_pins(pio_sm_config *c, uint pino) { (void)c; (void)pino; }
+static inline void sm_config_set_out_shift(pio_sm_config *c, bool direita, bool autopull, uint limite) { (void)c; (void)direita; (void)autopull; (void)limite; }
+static inline void sm_config_set_fifo_join(pio_sm_config *c, enum pio_fifo_join juncao) { (void)c; (void)juncao; }
+static inline void sm_config_set_clkdiv(pio_sm_config *c, float divisor) { (void)c; (void)divisor; }
+static inline void pio_gpio_init(PIO pio, uint pino) { (void)pio; (void)pino; }
+static inline int pio_sm_set_consecutive_pindirs(PIO pio, uint sm, uint pino, uint quantidade, bool saida) { (void)pio; (void)sm; (void)pino; (void)quantidade; (void)saida; return 0; }
+static inline int pio_sm_init(PIO pio, uint sm, uint offset, const pio_sm_config *c) { (void)pio; (void)sm; (void)offset; (void)c; return 0; }
+static inline void pio_sm_set_enabled(PIO pio, uint sm, bool ativo) { (void)pio; (void)sm; (void)ativo; }
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef SDK_SIMULADO_PICO_STDLIB_H
+#define SDK_SIMULADO_PICO_STDLIB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef unsigned int uint;
+
+//As esperas do firmware não fazem parte do custo medido no computador
+static inline void sleep_us(uint64_t us) { (void)us; }
+static inline void sleep_ms(uint32_t ms) { (void)ms; }
+
+#endif
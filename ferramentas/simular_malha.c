@@ -0,0 +1,127 @@
+//Ensaios do PI contra a planta térmica simulada, muito mais rápidos que o tempo real
+//Uso: simular_malha [--kp v] [--ki v] [--setpoint v] [--duracao s] [planta...] [--curva | --varrer n]
+//Um ensaio imprime IAE, ISE, sobressinal e acomodação; --curva grava a
+//resposta passo a passo em CSV e --varrer n testa uma grade n x n de ganhos
+//(de 1/4 a 4 vezes os informados, em escala logarítmica) e imprime um CSV.
+//O resumo com a aceleração em relação ao tempo real vai para stderr
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <time.h>
+#include "lib/Simulacao/malha_simulada.h"
+
+static double agoraS(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + t.tv_nsec / 1e9;
+}
+
+static void imprimirPasso(float tempo_s, float medida, float temperatura, uint16_t ciclo_pwm, void *contexto) {
+    (void)contexto;
+    printf("%.0f,%.3f,%.3f,%u\n", tempo_s, medida, temperatura, ciclo_pwm);
+}
+
+static void uso(const char *programa) {
+    fprintf(stderr,
+            "Uso: %s [--kp v] [--ki v] [--setpoint c] [--duracao s] [--passo s] [--semente n]\n"
+            "          [--ambiente c] [--ganho c] [--tau s] [--atraso s] [--ruido c] [--resolucao c]\n"
+            "          [--curva | --varrer n]\n",
+            programa);
+}
+
+int main(int argc, char **argv) {
+    //Padrões do firmware: ganhos iniciais, período de 1 s e critério de acomodação do avaliador
+    EnsaioMalha ensaio = {
+        .kp = 120.0f, .ki = 8.0f, .limite_integral = 4096.0f,
+        .setpoint = 20.0f, .intervalo_s = 1.0f, .duracao_s = 3600.0f,
+        .banda = 0.5f, .janela_estavel_s = 60.0f, .semente = 1,
+    };
+    ParametrosPlanta planta = PLANTA_PADRAO;
+    bool curva = false;
+    int grade = 0;
+
+    for (int i = 1; i < argc; i++) {
+        const char *opcao = argv[i];
+        bool tem_valor = i + 1 < argc;
+        float *campo = NULL;
+        if (strcmp(opcao, "--kp") == 0) campo = &ensaio.kp;
+        else if (strcmp(opcao, "--ki") == 0) campo = &ensaio.ki;
+        else if (strcmp(opcao, "--setpoint") == 0) campo = &ensaio.setpoint;
+        else if (strcmp(opcao, "--duracao") == 0) campo = &ensaio.duracao_s;
+        else if (strcmp(opcao, "--passo") == 0) campo = &ensaio.intervalo_s;
+        else if (strcmp(opcao, "--ambiente") == 0) campo = &planta.ambiente_c;
+        else if (strcmp(opcao, "--ganho") == 0) campo = &planta.ganho_c;
+        else if (strcmp(opcao, "--tau") == 0) campo = &planta.constante_tempo_s;
+        else if (strcmp(opcao, "--atraso") == 0) campo = &planta.atraso_s;
+        else if (strcmp(opcao, "--ruido") == 0) campo = &planta.ruido_c;
+        else if (strcmp(opcao, "--resolucao") == 0) campo = &planta.resolucao_c;
+
+        if (campo && tem_valor) {
+            *campo = strtof(argv[++i], NULL);
+        } else if (strcmp(opcao, "--semente") == 0 && tem_valor) {
+            ensaio.semente = (uint32_t)strtoul(argv[++i], NULL, 10);
+        } else if (strcmp(opcao, "--curva") == 0) {
+            curva = true;
+        } else if (strcmp(opcao, "--varrer") == 0 && tem_valor) {
+            grade = atoi(argv[++i]);
+        } else {
+            uso(argv[0]);
+            return 1;
+        }
+    }
+    if (ensaio.intervalo_s <= 0.0f || ensaio.duracao_s < ensaio.intervalo_s || planta.constante_tempo_s <= 0.0f ||
+        grade < 0 || (curva && grade)) {
+        uso(argv[0]);
+        return 1;
+    }
+
+    ResultadoMalha resultado;
+    unsigned long ensaios = 0, passos = 0;
+    double inicio = agoraS();
+
+    if (grade) {
+        printf("kp,ki,iae,ise,sobressinal,acomodou,tempo_acomodacao_s\n");
+        float kp_base = ensaio.kp, ki_base = ensaio.ki;
+        for (int a = 0; a < grade; a++) {
+            for (int b = 0; b < grade; b++) {
+                float fator_kp = grade > 1 ? (float)a / (grade - 1) : 0.5f;
+                float fator_ki = grade > 1 ? (float)b / (grade - 1) : 0.5f;
+                ensaio.kp = kp_base * powf(16.0f, fator_kp) / 4.0f;
+                ensaio.ki = ki_base * powf(16.0f, fator_ki) / 4.0f;
+                malha_simulada_executar(&planta, &ensaio, &resultado, NULL, NULL);
+                printf("%.3f,%.4f,%.2f,%.2f,%.3f,%d,%.0f\n", ensaio.kp, ensaio.ki, resultado.iae, resultado.ise,
+                       resultado.sobressinal, resultado.acomodou, resultado.tempo_acomodacao_s);
+                ensaios++;
+                passos += resultado.passos;
+            }
+        }
+    } else {
+        if (curva) {
+            printf("tempo,medida,temperatura,pwm\n");
+        }
+        malha_simulada_executar(&planta, &ensaio, &resultado, curva ? imprimirPasso : NULL, NULL);
+        ensaios = 1;
+        passos = resultado.passos;
+        if (!curva) {
+            printf("IAE:         %.2f °C·s\n", resultado.iae);
+            printf("ISE:         %.2f °C²·s\n", resultado.ise);
+            printf("Sobressinal: %.2f °C\n", resultado.sobressinal);
+            if (resultado.acomodou) {
+                printf("Acomodacao:  %.0f s (faixa de %.1f °C por %.0f s)\n", resultado.tempo_acomodacao_s,
+                       ensaio.banda, ensaio.janela_estavel_s);
+            } else {
+                printf("Acomodacao:  nao acomodou em %.0f s\n", ensaio.duracao_s);
+            }
+            printf("Final:       %.2f °C\n", resultado.temperatura_final);
+        }
+    }
+
+    double decorrido = agoraS() - inicio;
+    double simulado = (double)passos * ensaio.intervalo_s;
+    fprintf(stderr, "%lu ensaio(s), %.0f s simulados em %.3f s: %.0fx o tempo real (%.0f ns/passo)\n",
+            ensaios, simulado, decorrido, decorrido > 0 ? simulado / decorrido : 0.0,
+            passos ? decorrido * 1e9 / passos : 0.0);
+    return 0;
+}
@@ -0,0 +1,441 @@
+//Micro-benchmarks no host dos caminhos quentes de display, web, controle e sensores
+//Uso: thermoguard_bench [filtro] [--csv]
+//Cada caso roda em lotes calibrados para ~10 ms; o resultado é a mediana de
+//AMOSTRAS_POR_CASO lotes, com mínimo, p90 e dispersão (desvio absoluto mediano).
+//As bibliotecas de lib/ são compiladas contra o SDK simulado (ferramentas/sdk_simulado):
+//I2C e PIO vão para sumidouros que só contam bytes, e sleep_us não espera.
+//Com BENCH_CONTAR_ALOCACOES (ligação com --wrap no Linux) malloc/calloc/realloc/free
+//chamados pelo código do projeto são contados por operação
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "lib/Display_Bibliotecas/ssd1306.h"
+#include "lib/Display_Bibliotecas/grafico_tendencia.h"
+#include "lib/Matriz_Bibliotecas/matriz_led.h"
+#include "lib/Controle/controle_pi.h"
+#include "lib/Controle/controlador.h"
+#include "lib/Historico/historico.h"
+#include "lib/Web/pagina_web.h"
+#include "lib/Web/cache_respostas.h"
+#include "lib/Web/rotas.h"
+#include "lib/Sensores/sensor_analogico.h"
+
+#define AMOSTRAS_POR_CASO 21
+#define TEMPO_LOTE_NS     10000000ull //Duração mínima de um lote após a calibração
+#define ITERACOES_MAXIMAS (1u << 30)
+
+/* ---------- Sumidouros do SDK simulado ---------- */
+
+static uint64_t bytes_barramento; //Bytes enviados por I2C e palavras do PIO (4 bytes cada)
+static uint64_t transacoes_i2c;   //START/endereço/STOP completos
+static volatile uint32_t ultimo_dado;
+
+void sdk_simulado_i2c_escrita(uint8_t endereco, const uint8_t *dados, size_t tamanho, bool encerra) {
+    bytes_barramento += tamanho;
+    transacoes_i2c += encerra;
+    ultimo_dado = endereco ^ (tamanho ? dados[tamanho - 1] : 0);
+}
+
+void sdk_simulado_pio_palavra(uint sm, uint32_t palavra) {
+    bytes_barramento += sizeof(palavra);
+    ultimo_dado = sm ^ palavra;
+}
+
+/* ---------- Contagem de alocações ---------- */
+
+static uint64_t alocacoes;
+static uint64_t bytes_alocados;
+
+#ifdef BENCH_CONTAR_ALOCACOES
+void *__real_malloc(size_t tamanho);
+void *__real_calloc(size_t quantidade, size_t tamanho);
+void *__real_realloc(void *ponteiro, size_t tamanho);
+
+void *__wrap_malloc(size_t tamanho) {
+    alocacoes++;
+    bytes_alocados += tamanho;
+    return __real_malloc(tamanho);
+}
+
+void *__wrap_calloc(size_t quantidade, size_t tamanho) {
+    alocacoes++;
+    bytes_alocados += quantidade * tamanho;
+    return __real_calloc(quantidade, tamanho);
+}
+
+void *__wrap_realloc(void *ponteiro, size_t tamanho) {
+    alocacoes++;
+    bytes_alocados += tamanho;
+    return __real_realloc(ponteiro, tamanho);
+}
+#endif
+
+/* ---------- Estado compartilhado pelos casos ---------- */
+
+static ssd1306_t display;
+static GraficoTendencia tendencia;
+static Historico historico;
+static ControladorPI controlador;
+static Controlador controladores[CONTROLADOR_TIPOS]; //Variantes de controlador.hpp pela API em C
+static SensorAnalogico sensor_ntc;
+static ResumoPagina resumo;
+static char corpo_web[3072];
+static char buffers_cache[CACHE_RESPOSTA_COPIAS][CACHE_RESPOSTA_CABECALHO + 3072];
+static RespostaCache cache_web;
+static volatile uint32_t escudo; //Impede que o compilador descarte os resultados
+
+static int montar_corpo_cache(char *corpo, size_t tamanho) {
+    historico_estatisticas(&historico, NIVEL_SEGUNDOS, &resumo.recentes);
+    return pagina_web_montar(&resumo, corpo, tamanho);
+}
+
+static void preparar(void) {
+    ssd1306_init(&display, 128, 64, false, 0x3C, NULL);
+    historico_inicializar(&historico);
+    //Um dia de amostras preenche todos os níveis
+    for (uint32_t t = 0; t < 86400; t++) {
+        historico_registrar(&historico, 25.0f + (float)(t % 600) / 100.0f, t);
+    }
+    controle_pi_inicializar(&controlador, 50.0f, 2.0f, 4096.0f);
+    const ParametrosControlador parametros = {
+        .kp = 50.0f, .ki = 2.0f, .kd = 20.0f, .filtro_s = 5.0f, .kff = 1.0f,
+        .limite_integral = 4096.0f, .saida_max = 4096.0f, .ganho_retrocalculo = 0.5f,
+    };
+    for (int tipo = 0; tipo < CONTROLADOR_TIPOS; tipo++) {
+        controlador_configurar(&controladores[tipo], (TipoControlador)tipo, &parametros, 1.0f);
+    }
+    ParametrosNtc ntc = SENSOR_NTC_10K;
+    sensor_analogico_ntc(&sensor_ntc, &ntc);
+    grafico_tendencia_inicializar(&tendencia, 2);
+    cache_resposta_iniciar(&cache_web, "text/html", montar_corpo_cache, buffers_cache[0], sizeof(buffers_cache[0]));
+    for (uint32_t t = 0; t < GRAFICO_TENDENCIA_LARGURA; t++) {
+        grafico_tendencia_adicionar(&tendencia, 27.0f + (float)(t % 50) / 100.0f);
+    }
+    resumo = (ResumoPagina){
+        .sistema_ligado = true,
+        .setpoint = 30,
+        .setpoint_minimo = 10,
+        .setpoint_maximo = 30,
+        .temperatura = 27.4f,
+        .umidade = 61.0f,
+        .ciclo_pwm = 40123,
+        .rpm = 1412.0f,
+        .kp = 50.0f,
+        .ki = 2.0f,
+        .avaliacao_concluida = true,
+        .tempo_acomodacao_s = 183.0f,
+        .sobressinal = 0.8f,
+    };
+}
+
+/* ---------- Casos ---------- */
+
+static void caso_oled_fill(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        ssd1306_fill(&display, i & 1);
+    }
+    escudo += display.ram_buffer[1];
+}
+
+static void caso_oled_config(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        ssd1306_config(&display);
+    }
+}
+
+static void caso_oled_draw_string(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        ssd1306_draw_string(&display, "Temp: 27.4 C", 0, (i & 3) * 16, false);
+    }
+    escudo += display.ram_buffer[1];
+}
+
+static void caso_oled_send_data(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        ssd1306_send_data(&display);
+    }
+}
+
+static void caso_oled_tela_principal(uint32_t iteracoes) {
+    //Mesma sequência de atualizar_tela_oled_principal em main.c
+    char texto[32];
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        float temperatura = 27.0f + (float)(i & 7) / 10.0f;
+        ssd1306_fill(&display, false);
+        snprintf(texto, sizeof(texto), "Temp: %4.1f °C", temperatura);
+        ssd1306_draw_string(&display, texto, 0, 0, false);
+        snprintf(texto, sizeof(texto), "Set:  %3d °C", 30);
+        ssd1306_draw_string(&display, texto, 0, 16, false);
+        snprintf(texto, sizeof(texto), "Erro: %4.1f °C", 30.0f - temperatura);
+        ssd1306_draw_string(&display, texto, 0, 32, false);
+        snprintf(texto, sizeof(texto), "PWM:  %5u", 40123u + (i & 7));
+        ssd1306_draw_string(&display, texto, 0, 48, false);
+        ssd1306_send_data(&display);
+    }
+}
+
+static void caso_oled_tendencia(uint32_t iteracoes) {
+    //Uma amostra nova por atualização, dentro do mesmo grau: só rolagem e uma coluna
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        grafico_tendencia_adicionar(&tendencia, 27.0f + (float)(i % 50) / 100.0f);
+        grafico_tendencia_desenhar(&tendencia, &display);
+        ssd1306_send_pages(&display, 2, 7);
+    }
+}
+
+static void caso_oled_tendencia_completa(uint32_t iteracoes) {
+    //Referência: o gráfico inteiro refeito a cada amostra
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        grafico_tendencia_adicionar(&tendencia, 27.0f + (float)(i % 50) / 100.0f);
+        grafico_tendencia_invalidar(&tendencia);
+        grafico_tendencia_desenhar(&tendencia, &display);
+        ssd1306_send_pages(&display, 2, 7);
+    }
+}
+
+static void caso_web_resposta(uint32_t iteracoes) {
+    //Estatísticas, corpo HTML e cabeçalho, como em callback_recepcao_web
+    char cabecalho[128];
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        historico_estatisticas(&historico, NIVEL_SEGUNDOS, &resumo.recentes);
+        resumo.ciclo_pwm = 40000 + (i & 255);
+        int tamanho = pagina_web_montar(&resumo, corpo_web, sizeof(corpo_web));
+        escudo += pagina_web_cabecalho(cabecalho, sizeof(cabecalho), "200 OK", "text/html", tamanho);
+    }
+}
+
+static void caso_web_resposta_cache(uint32_t iteracoes) {
+    //Oito clientes por versão do estado: um monta, os demais recebem o mesmo buffer
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        resumo.ciclo_pwm = 40000 + ((i >> 3) & 255);
+        CopiaResposta *copia = cache_resposta_obter(&cache_web, i >> 3);
+        escudo += copia->tamanho;
+        cache_resposta_liberar(copia);
+    }
+}
+
+static void caso_web_rota(uint32_t iteracoes) {
+    //Linha de requisição e cabeçalhos até a rota, como em callback_recepcao_web (inclui uma falha)
+    static const char *const REQUISICOES[] = {
+        "GET / HTTP/1.1\r\nHost: 192.168.0.50\r\nAccept: text/html,application/xhtml+xml\r\n\r\n",
+        "GET /api/zona HTTP/1.1\r\nHost: 192.168.0.50\r\n\r\n",
+        "GET /api/estatisticas HTTP/1.1\r\nHost: 192.168.0.50\r\n\r\n",
+        "PUT /api/controle?setpoint=22&kp=95.5&ki=4.2 HTTP/1.1\r\nHost: 192.168.0.50\r\n\r\n",
+        "POST /api/controle HTTP/1.1\r\nHost: 192.168.0.50\r\nContent-Length: 8\r\n\r\nligado=1",
+        "GET /favicon.ico HTTP/1.1\r\nHost: 192.168.0.50\r\n\r\n",
+    };
+    enum { QUANTIDADE = sizeof(REQUISICOES) / sizeof(REQUISICOES[0]) };
+    static size_t tamanhos[QUANTIDADE];
+    if (!tamanhos[0]) {
+        for (size_t i = 0; i < QUANTIDADE; i++) {
+            tamanhos[i] = strlen(REQUISICOES[i]);
+        }
+    }
+    RequisicaoHttp requisicao;
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        uint32_t indice = i % QUANTIDADE;
+        rotas_interpretar(REQUISICOES[indice], tamanhos[indice], &requisicao);
+        escudo += rotas_resolver(&requisicao);
+    }
+}
+
+static void caso_historico_registrar(uint32_t iteracoes) {
+    static uint32_t tempo = 86400;
+    for (uint32_t i = 0; i < iteracoes; i++, tempo++) {
+        historico_registrar(&historico, 25.0f + (float)(tempo % 600) / 100.0f, tempo);
+    }
+}
+
+static void caso_historico_media(uint32_t iteracoes) {
+    //Substitui calcular_media_temperaturas: média, mínimo, máximo e variância da janela
+    EstatisticasHistorico estatisticas;
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        historico_estatisticas(&historico, (NivelHistorico)(i % HISTORICO_NIVEIS), &estatisticas);
+        escudo += (uint32_t)estatisticas.media;
+    }
+}
+
+static void caso_matriz_draw_number(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        matriz_draw_number((uint8_t)(i % 10), COR_VERDE);
+    }
+}
+
+static void caso_controle_pi_passo(uint32_t iteracoes) {
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        float erro = (float)((int32_t)(i & 63) - 32) / 8.0f;
+        escudo += controle_pi_passo(&controlador, erro, 1.0f);
+    }
+}
+
+//Mesmo erro do caso controle_pi_passo; o sinal vai para o PWM como no firmware
+static void passos_controlador(TipoControlador tipo, uint32_t iteracoes) {
+    Controlador *variante = &controladores[tipo];
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        float erro = (float)((int32_t)(i & 63) - 32) / 8.0f;
+        escudo += controle_pi_sinal_para_pwm(controlador_passo(variante, erro, 0.25f));
+    }
+}
+
+static void caso_controlador_p(uint32_t iteracoes) { passos_controlador(CONTROLADOR_P, iteracoes); }
+static void caso_controlador_pi(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PI, iteracoes); }
+static void caso_controlador_pi_condicional(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PI_CONDICIONAL, iteracoes); }
+static void caso_controlador_pi_retrocalculo(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PI_RETROCALCULO, iteracoes); }
+static void caso_controlador_pid(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PID, iteracoes); }
+static void caso_controlador_pid_alimentacao(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PID_ALIMENTACAO, iteracoes); }
+static void caso_controlador_pi_fixo(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PI_FIXO, iteracoes); }
+static void caso_controlador_pid_fixo(uint32_t iteracoes) { passos_controlador(CONTROLADOR_PID_FIXO, iteracoes); }
+
+static void caso_sensor_analogico_bloco(uint32_t iteracoes) {
+    //Um bloco do DMA com 21 conversões da entrada (3 entradas em blocos de 64)
+    for (uint32_t i = 0; i < iteracoes; i++) {
+        sensor_analogico_consumir(21u * (2000u + (i & 127)), 21, &sensor_ntc);
+    }
+    escudo += (uint32_t)sensor_ntc.centesimos;
+}
+
+typedef struct {
+    const char *nome;
+    void (*executar)(uint32_t iteracoes);
+} CasoBench;
+
+static const CasoBench casos[] = {
+    {"oled_fill",            caso_oled_fill},
+    {"oled_config",          caso_oled_config},
+    {"oled_draw_string",     caso_oled_draw_string},
+    {"oled_send_data",       caso_oled_send_data},
+    {"oled_tela_principal",  caso_oled_tela_principal},
+    {"oled_tendencia",       caso_oled_tendencia},
+    {"oled_tendencia_completa", caso_oled_tendencia_completa},
+    {"web_resposta",         caso_web_resposta},
+    {"web_resposta_cache",   caso_web_resposta_cache},
+    {"web_rota",             caso_web_rota},
+    {"historico_registrar",  caso_historico_registrar},
+    {"historico_media",      caso_historico_media},
+    {"matriz_draw_number",   caso_matriz_draw_number},
+    {"controle_pi_passo",    caso_controle_pi_passo},
+    {"controlador_p",        caso_controlador_p},
+    {"controlador_pi",       caso_controlador_pi},
+    {"controlador_pi_cond",  caso_controlador_pi_condicional},
+    {"controlador_pi_retro", caso_controlador_pi_retrocalculo},
+    {"controlador_pid",      caso_controlador_pid},
+    {"controlador_pid_ff",   caso_controlador_pid_alimentacao},
+    {"controlador_pi_q16",   caso_controlador_pi_fixo},
+    {"controlador_pid_q16",  caso_controlador_pid_fixo},
+    {"sensor_analogico_bloco", caso_sensor_analogico_bloco},
+};
+
+/* ---------- Medição ---------- */
+
+typedef struct {
+    double mediana_ns, minimo_ns, p90_ns, dispersao;
+    double alocacoes_op, bytes_alocados_op, bytes_barramento_op, transacoes_i2c_op;
+    uint32_t iteracoes;
+} ResultadoBench;
+
+static uint64_t agoraNs(void) {
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (uint64_t)t.tv_sec * 1000000000ull + (uint64_t)t.tv_nsec;
+}
+
+static int compararDouble(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+static uint64_t medirLote(const CasoBench *caso, uint32_t iteracoes) {
+    uint64_t inicio = agoraNs();
+    caso->executar(iteracoes);
+    return agoraNs() - inicio;
+}
+
+static void medirCaso(const CasoBench *caso, ResultadoBench *resultado) {
+    //Calibração: dobra as iterações até o lote durar TEMPO_LOTE_NS (também aquece caches)
+    uint32_t iteracoes = 1;
+    while (medirLote(caso, iteracoes) < TEMPO_LOTE_NS && iteracoes < ITERACOES_MAXIMAS) {
+        iteracoes *= 2;
+    }
+
+    double por_operacao[AMOSTRAS_POR_CASO];
+    uint64_t alocacoes_inicio = alocacoes, bytes_inicio = bytes_alocados, barramento_inicio = bytes_barramento;
+    uint64_t transacoes_inicio = transacoes_i2c;
+    for (int i = 0; i < AMOSTRAS_POR_CASO; i++) {
+        por_operacao[i] = (double)medirLote(caso, iteracoes) / iteracoes;
+    }
+    double operacoes = (double)iteracoes * AMOSTRAS_POR_CASO;
+
+    qsort(por_operacao, AMOSTRAS_POR_CASO, sizeof(double), compararDouble);
+    resultado->iteracoes = iteracoes;
+    resultado->minimo_ns = por_operacao[0];
+    resultado->mediana_ns = por_operacao[AMOSTRAS_POR_CASO / 2];
+    resultado->p90_ns = por_operacao[(AMOSTRAS_POR_CASO * 9) / 10];
+
+    //Desvio absoluto mediano relativo à mediana
+    double desvios[AMOSTRAS_POR_CASO];
+    for (int i = 0; i < AMOSTRAS_POR_CASO; i++) {
+        double d = por_operacao[i] - resultado->mediana_ns;
+        desvios[i] = d < 0 ? -d : d;
+    }
+    qsort(desvios, AMOSTRAS_POR_CASO, sizeof(double), compararDouble);
+    resultado->dispersao = resultado->mediana_ns > 0 ? desvios[AMOSTRAS_POR_CASO / 2] / resultado->mediana_ns : 0;
+
+    resultado->alocacoes_op = (alocacoes - alocacoes_inicio) / operacoes;
+    resultado->bytes_alocados_op = (bytes_alocados - bytes_inicio) / operacoes;
+    resultado->bytes_barramento_op = (bytes_barramento - barramento_inicio) / operacoes;
+    resultado->transacoes_i2c_op = (transacoes_i2c - transacoes_inicio) / operacoes;
+}
+
+int main(int argc, char **argv) {
+    const char *filtro = NULL;
+    bool csv = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Uso: %s [filtro] [--csv]\n", argv[0]);
+            return 1;
+        } else {
+            filtro = argv[i];
+        }
+    }
+
+    preparar();
+
+    if (csv) {
+        printf("caso,iteracoes,ns_op_mediana,ns_op_min,ns_op_p90,dispersao,alocacoes_op,bytes_alocados_op,bytes_barramento_op,transacoes_i2c_op\n");
+    } else {
+        printf("%-24s %12s %12s %12s %7s %9s %11s %11s %9s\n",
+               "caso", "ns/op", "min", "p90", "MAD", "aloc/op", "B aloc/op", "B E/S/op", "I2C tr/op");
+    }
+
+    int executados = 0;
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); i++) {
+        if (filtro && !strstr(casos[i].nome, filtro)) {
+            continue;
+        }
+        ResultadoBench r;
+        medirCaso(&casos[i], &r);
+        executados++;
+        if (csv) {
+            printf("%s,%u,%.2f,%.2f,%.2f,%.4f,%.3f,%.1f,%.1f,%.2f\n", casos[i].nome, r.iteracoes,
+                   r.mediana_ns, r.minimo_ns, r.p90_ns, r.dispersao,
+                   r.alocacoes_op, r.bytes_alocados_op, r.bytes_barramento_op, r.transacoes_i2c_op);
+        } else {
+            printf("%-24s %12.1f %12.1f %12.1f %6.1f%% %9.3f %11.1f %11.1f %9.2f\n", casos[i].nome,
+                   r.mediana_ns, r.minimo_ns, r.p90_ns, r.dispersao * 100.0,
+                   r.alocacoes_op, r.bytes_alocados_op, r.bytes_barramento_op, r.transacoes_i2c_op);
+        }
+        fflush(stdout);
+    }
+
+#ifndef BENCH_CONTAR_ALOCACOES
+    if (!csv) {
+        printf("(alocações não contadas: compilado sem BENCH_CONTAR_ALOCACOES)\n");
+    }
+#endif
+    return executados ? 0 : 1;
+}
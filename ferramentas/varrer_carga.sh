@@ -0,0 +1,26 @@
+#!/bin/sh
+# Varre a quantidade de clientes simultâneos e gera um CSV por build
+# Uso: ferramentas/varrer_carga.sh <ip> [duracao_s] [clientes...] > resultado.csv
+# Ex.: ferramentas/varrer_carga.sh 192.168.0.50 20 1 2 4 8 16 32
+# Variáveis: CARGA (executável carga_http) e PORTA (padrão 80)
+set -e
+
+CARGA=${CARGA:-build_ferramentas/carga_http}
+PORTA=${PORTA:-80}
+ALVO=$1
+DURACAO=${2:-10}
+[ -n "$ALVO" ] || { echo "Uso: $0 <ip> [duracao_s] [clientes...]" >&2; exit 1; }
+shift
+[ $# -gt 0 ] && shift
+[ $# -gt 0 ] || set -- 1 2 4 8 16
+
+CABECALHO=1
+for CLIENTES in "$@"; do
+    if [ $CABECALHO -eq 1 ]; then
+        "$CARGA" -c "$CLIENTES" -d "$DURACAO" --csv "$ALVO" "$PORTA"
+        CABECALHO=0
+    else
+        "$CARGA" -c "$CLIENTES" -d "$DURACAO" --csv "$ALVO" "$PORTA" | tail -n 1
+    fi
+    sleep 2 # Deixa as conexões em TIME_WAIT do servidor expirarem entre as rodadas
+done
@@ -0,0 +1,197 @@
+#include "codec_amostras.h"
+#include <string.h>
+
+//Classes de tamanho do delta em zig-zag: prefixo e bits de conteúdo
+#define BITS_CLASSE_CURTA  6
+#define BITS_CLASSE_MEDIA  12
+#define BITS_CLASSE_LONGA  32
+#define CAMPOS_POR_AMOSTRA 5   //Tempo, temperatura, umidade, PWM e estado (setpoint + ligado)
+
+// Zig-zag: mapeia inteiros com sinal próximos de zero em valores pequenos sem sinal
+static uint32_t zigzag(int32_t valor) {
+    return ((uint32_t)valor << 1) ^ (uint32_t)(valor >> 31);
+}
+
+static int32_t desfazerZigzag(uint32_t valor) {
+    return (int32_t)(valor >> 1) ^ -(int32_t)(valor & 1);
+}
+
+// Bits ocupados por um delta já em zig-zag, incluindo o prefixo
+static uint32_t bitsDelta(uint32_t valor) {
+    if (valor == 0) return 1;
+    if (valor < (1u << BITS_CLASSE_CURTA)) return 2 + BITS_CLASSE_CURTA;
+    if (valor < (1u << BITS_CLASSE_MEDIA)) return 3 + BITS_CLASSE_MEDIA;
+    return 3 + BITS_CLASSE_LONGA;
+}
+
+// Escreve os 'quantidade' bits menos significativos, do mais significativo para o menos
+static void escreverBits(CodificadorAmostras *codificador, uint32_t valor, uint8_t quantidade) {
+    while (quantidade--) {
+        if ((valor >> quantidade) & 1) {
+            codificador->buffer[codificador->bits >> 3] |= 0x80 >> (codificador->bits & 7);
+        }
+        codificador->bits++;
+    }
+}
+
+static bool lerBits(DecodificadorAmostras *decodificador, uint8_t quantidade, uint32_t *valor) {
+    if (decodificador->bits + quantidade > (uint32_t)decodificador->tamanho * 8) {
+        return false;
+    }
+    uint32_t lido = 0;
+    while (quantidade--) {
+        uint8_t byte = decodificador->buffer[decodificador->bits >> 3];
+        lido = (lido << 1) | ((byte >> (7 - (decodificador->bits & 7))) & 1);
+        decodificador->bits++;
+    }
+    *valor = lido;
+    return true;
+}
+
+static void escreverDelta(CodificadorAmostras *codificador, uint32_t valor) {
+    if (valor == 0) {
+        escreverBits(codificador, 0x0, 1);
+    } else if (valor < (1u << BITS_CLASSE_CURTA)) {
+        escreverBits(codificador, 0x2, 2);
+        escreverBits(codificador, valor, BITS_CLASSE_CURTA);
+    } else if (valor < (1u << BITS_CLASSE_MEDIA)) {
+        escreverBits(codificador, 0x6, 3);
+        escreverBits(codificador, valor, BITS_CLASSE_MEDIA);
+    } else {
+        escreverBits(codificador, 0x7, 3);
+        escreverBits(codificador, valor, BITS_CLASSE_LONGA);
+    }
+}
+
+static bool lerDelta(DecodificadorAmostras *decodificador, uint32_t *valor) {
+    //Conta os bits 1 do prefixo (no máximo três)
+    uint32_t bit;
+    uint8_t prefixo = 0;
+    while (prefixo < 3) {
+        if (!lerBits(decodificador, 1, &bit)) return false;
+        if (!bit) break;
+        prefixo++;
+    }
+    static const uint8_t bits_por_prefixo[] = {0, BITS_CLASSE_CURTA, BITS_CLASSE_MEDIA, BITS_CLASSE_LONGA};
+    if (prefixo == 0) {
+        *valor = 0;
+        return true;
+    }
+    return lerBits(decodificador, bits_por_prefixo[prefixo], valor);
+}
+
+// Setpoint e estado ligado mudam juntos e raramente: viajam em um único campo
+static int32_t estadoAmostra(const Amostra *amostra) {
+    return (int32_t)amostra->setpoint_deci * 2 + (amostra->ligado ? 1 : 0);
+}
+
+// Deltas em zig-zag de cada campo em relação à amostra anterior
+static void calcularDeltas(const CodificadorAmostras *codificador, const Amostra *amostra, uint32_t deltas[CAMPOS_POR_AMOSTRA]) {
+    const Amostra *anterior = &codificador->anterior;
+    int32_t delta_tempo = (int32_t)(amostra->tempo_s - anterior->tempo_s);
+    deltas[0] = zigzag(delta_tempo - codificador->delta_tempo_anterior);
+    deltas[1] = zigzag(amostra->temperatura_centi - anterior->temperatura_centi);
+    deltas[2] = zigzag(amostra->umidade_deci - anterior->umidade_deci);
+    deltas[3] = zigzag(amostra->ciclo_pwm - anterior->ciclo_pwm);
+    deltas[4] = zigzag(estadoAmostra(amostra) - estadoAmostra(anterior));
+}
+
+void codec_iniciar_codificador(CodificadorAmostras *codificador, uint8_t *buffer, uint16_t capacidade) {
+    memset(codificador, 0, sizeof(*codificador));
+    memset(buffer, 0, capacidade);
+    codificador->buffer = buffer;
+    codificador->capacidade = capacidade;
+}
+
+bool codec_codificar(CodificadorAmostras *codificador, const Amostra *amostra) {
+    uint32_t limite = (uint32_t)codificador->capacidade * 8;
+
+    //Amostra-chave: valores completos
+    if (codificador->amostras == 0) {
+        if (codificador->bits + 32 + 4 * 16 > limite) {
+            return false;
+        }
+        escreverBits(codificador, amostra->tempo_s, 32);
+        escreverBits(codificador, (uint16_t)amostra->temperatura_centi, 16);
+        escreverBits(codificador, amostra->umidade_deci, 16);
+        escreverBits(codificador, amostra->ciclo_pwm, 16);
+        escreverBits(codificador, (uint16_t)estadoAmostra(amostra), 16);
+        codificador->delta_tempo_anterior = 0;
+    } else {
+        uint32_t deltas[CAMPOS_POR_AMOSTRA];
+        calcularDeltas(codificador, amostra, deltas);
+        uint32_t necessarios = 0;
+        for (int i = 0; i < CAMPOS_POR_AMOSTRA; i++) {
+            necessarios += bitsDelta(deltas[i]);
+        }
+        if (codificador->bits + necessarios > limite) {
+            return false;
+        }
+        for (int i = 0; i < CAMPOS_POR_AMOSTRA; i++) {
+            escreverDelta(codificador, deltas[i]);
+        }
+        codificador->delta_tempo_anterior = (int32_t)(amostra->tempo_s - codificador->anterior.tempo_s);
+    }
+
+    codificador->anterior = *amostra;
+    codificador->anterior.ligado = amostra->ligado ? 1 : 0;
+    codificador->amostras++;
+    return true;
+}
+
+uint16_t codec_bytes_usados(const CodificadorAmostras *codificador) {
+    return (uint16_t)((codificador->bits + 7) / 8);
+}
+
+void codec_iniciar_decodificador(DecodificadorAmostras *decodificador, const uint8_t *buffer, uint16_t tamanho, uint16_t amostras) {
+    memset(decodificador, 0, sizeof(*decodificador));
+    decodificador->buffer = buffer;
+    decodificador->tamanho = tamanho;
+    decodificador->restantes = amostras;
+}
+
+bool codec_decodificar(DecodificadorAmostras *decodificador, Amostra *amostra) {
+    if (!decodificador->restantes) {
+        return false;
+    }
+
+    Amostra *anterior = &decodificador->anterior;
+    int32_t estado;
+    if (decodificador->decodificadas == 0) {
+        uint32_t tempo, temperatura, umidade, pwm, campo_estado;
+        if (!lerBits(decodificador, 32, &tempo) || !lerBits(decodificador, 16, &temperatura) ||
+            !lerBits(decodificador, 16, &umidade) || !lerBits(decodificador, 16, &pwm) ||
+            !lerBits(decodificador, 16, &campo_estado)) {
+            decodificador->restantes = 0;
+            return false;
+        }
+        anterior->tempo_s = tempo;
+        anterior->temperatura_centi = (int16_t)temperatura;
+        anterior->umidade_deci = (uint16_t)umidade;
+        anterior->ciclo_pwm = (uint16_t)pwm;
+        estado = (int16_t)campo_estado;
+    } else {
+        uint32_t deltas[CAMPOS_POR_AMOSTRA];
+        for (int i = 0; i < CAMPOS_POR_AMOSTRA; i++) {
+            if (!lerDelta(decodificador, &deltas[i])) {
+                decodificador->restantes = 0;
+                return false;
+            }
+        }
+        decodificador->delta_tempo_anterior += desfazerZigzag(deltas[0]);
+        anterior->tempo_s += (uint32_t)decodificador->delta_tempo_anterior;
+        anterior->temperatura_centi += (int16_t)desfazerZigzag(deltas[1]);
+        anterior->umidade_deci += (uint16_t)desfazerZigzag(deltas[2]);
+        anterior->ciclo_pwm += (uint16_t)desfazerZigzag(deltas[3]);
+        estado = estadoAmostra(anterior) + desfazerZigzag(deltas[4]);
+    }
+
+    //Divisão inteira com piso para recuperar setpoints negativos
+    anterior->ligado = (uint8_t)(estado & 1);
+    anterior->setpoint_deci = (int16_t)((estado - anterior->ligado) / 2);
+
+    *amostra = *anterior;
+    decodificador->restantes--;
+    decodificador->decodificadas++;
+    return true;
+}
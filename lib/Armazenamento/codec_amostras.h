@@ -0,0 +1,57 @@
+#ifndef CODEC_AMOSTRAS_H
+#define CODEC_AMOSTRAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Codificação compacta de amostras em fluxo de bits (estilo Gorilla):
+//o tempo usa delta-do-delta e cada valor usa o delta para a amostra anterior,
+//em zig-zag, com prefixo de classe de tamanho ('0' = sem mudança, '10' + 6 bits,
+//'110' + 12 bits, '111' + 32 bits). A primeira amostra de cada bloco é completa,
+//então blocos são decodificáveis de forma independente.
+//Não depende do SDK: o mesmo arquivo compila no firmware e nas ferramentas do host
+
+typedef struct {
+    uint32_t tempo_s;          //Tempo do log em segundos
+    int16_t temperatura_centi; //Temperatura em centésimos de grau
+    uint16_t umidade_deci;     //Umidade em décimos de %
+    uint16_t ciclo_pwm;        //Saída da zona principal
+    int16_t setpoint_deci;     //Setpoint em décimos de grau
+    uint8_t ligado;            //Sistema de controle ativo
+} Amostra;
+
+typedef struct {
+    uint8_t *buffer;
+    uint16_t capacidade;       //Bytes disponíveis
+    uint32_t bits;             //Bits já escritos
+    uint16_t amostras;
+    Amostra anterior;
+    int32_t delta_tempo_anterior;
+} CodificadorAmostras;
+
+typedef struct {
+    const uint8_t *buffer;
+    uint16_t tamanho;
+    uint32_t bits;             //Bits já lidos
+    uint16_t restantes;        //Amostras ainda não decodificadas
+    uint16_t decodificadas;
+    Amostra anterior;
+    int32_t delta_tempo_anterior;
+} DecodificadorAmostras;
+
+//Inicia um bloco vazio; o buffer é zerado
+void codec_iniciar_codificador(CodificadorAmostras *codificador, uint8_t *buffer, uint16_t capacidade);
+
+//Anexa uma amostra ao bloco; retorna false (sem alterar o bloco) se ela não couber
+bool codec_codificar(CodificadorAmostras *codificador, const Amostra *amostra);
+
+//Bytes ocupados pelo bloco até agora
+uint16_t codec_bytes_usados(const CodificadorAmostras *codificador);
+
+//Prepara a leitura de um bloco com a quantidade de amostras indicada
+void codec_iniciar_decodificador(DecodificadorAmostras *decodificador, const uint8_t *buffer, uint16_t tamanho, uint16_t amostras);
+
+//Decodifica a próxima amostra; retorna false ao fim do bloco ou se os dados estiverem truncados
+bool codec_decodificar(DecodificadorAmostras *decodificador, Amostra *amostra);
+
+#endif // CODEC_AMOSTRAS_H
@@ -0,0 +1,97 @@
+#include "config_persistente.h"
+#include <string.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "mapa_flash.h"
+#include "flash_seguro.h"
+#include "crc.h"
+
+#define MAGICO_CONFIG 0x47464354u //"TCFG"
+#define COPIAS_CONFIG 2
+
+//Na flash: cabeçalho, 'tamanho' bytes de ConfiguracaoPersistente e o CRC-16 de tudo que vem antes
+typedef struct {
+    uint32_t magico;
+    uint16_t versao;
+    uint16_t tamanho;          //sizeof(ConfiguracaoPersistente) na versão gravada
+    uint32_t geracao;          //Cresce a cada gravação: a maior geração válida vence
+} CabecalhoConfig;
+
+_Static_assert(sizeof(CabecalhoConfig) + sizeof(ConfiguracaoPersistente) + sizeof(uint16_t) <= FLASH_PAGE_SIZE,
+               "Registro de configuração deve caber em uma página");
+
+static uint32_t geracao_atual;
+static uint8_t copia_atual = COPIAS_CONFIG - 1; //Sem cópia válida, a primeira gravação vai para a cópia 0
+
+// Deslocamento na flash de uma cópia
+static uint32_t deslocamentoCopia(uint8_t copia) {
+    return CONFIG_FLASH_INICIO + copia * FLASH_SECTOR_SIZE;
+}
+
+// Lê e valida uma cópia, completando com zeros os campos que a versão gravada não tinha
+static bool lerCopia(uint8_t copia, CabecalhoConfig *cabecalho, ConfiguracaoPersistente *config) {
+    const uint8_t *dados = FLASH_PONTEIRO(deslocamentoCopia(copia));
+    memcpy(cabecalho, dados, sizeof(*cabecalho));
+    if (cabecalho->magico != MAGICO_CONFIG || cabecalho->versao == 0 || cabecalho->versao > CONFIG_VERSAO ||
+        cabecalho->tamanho > sizeof(ConfiguracaoPersistente)) {
+        return false;
+    }
+    size_t tamanho = sizeof(*cabecalho) + cabecalho->tamanho;
+    uint16_t crc;
+    memcpy(&crc, dados + tamanho, sizeof(crc));
+    if (crc != crc16_calcular(dados, tamanho)) {
+        return false;
+    }
+    memset(config, 0, sizeof(*config));
+    memcpy(config, dados + sizeof(*cabecalho), cabecalho->tamanho);
+    return true;
+}
+
+// Carrega a cópia válida de maior geração
+bool config_carregar(ConfiguracaoPersistente *config) {
+    bool encontrada = false;
+    for (uint8_t copia = 0; copia < COPIAS_CONFIG; copia++) {
+        CabecalhoConfig cabecalho;
+        ConfiguracaoPersistente lida;
+        if (lerCopia(copia, &cabecalho, &lida) && (!encontrada || cabecalho.geracao > geracao_atual)) {
+            encontrada = true;
+            geracao_atual = cabecalho.geracao;
+            copia_atual = copia;
+            *config = lida;
+        }
+    }
+    return encontrada;
+}
+
+// Grava sobre a cópia mais antiga; a cópia atual só deixa de valer depois que a nova está completa
+bool config_salvar(const ConfiguracaoPersistente *config) {
+    static uint8_t pagina[FLASH_PAGE_SIZE] __attribute__((aligned(4)));
+    CabecalhoConfig cabecalho = {
+        .magico = MAGICO_CONFIG,
+        .versao = CONFIG_VERSAO,
+        .tamanho = sizeof(ConfiguracaoPersistente),
+        .geracao = geracao_atual + 1
+    };
+    size_t tamanho = sizeof(cabecalho) + sizeof(*config);
+    memset(pagina, 0xFF, sizeof(pagina));
+    memcpy(pagina, &cabecalho, sizeof(cabecalho));
+    memcpy(pagina + sizeof(cabecalho), config, sizeof(*config));
+    uint16_t crc = crc16_calcular(pagina, tamanho);
+    memcpy(pagina + tamanho, &crc, sizeof(crc));
+
+    uint8_t destino = (copia_atual + 1) % COPIAS_CONFIG;
+    if (!flash_seguro_apagar(deslocamentoCopia(destino), FLASH_SECTOR_SIZE) ||
+        !flash_seguro_programar(deslocamentoCopia(destino), pagina, sizeof(pagina))) {
+        return false;
+    }
+
+    //Confere a gravação antes de adotar a nova cópia
+    CabecalhoConfig lido;
+    ConfiguracaoPersistente conferida;
+    if (!lerCopia(destino, &lido, &conferida) || lido.geracao != cabecalho.geracao) {
+        return false;
+    }
+    geracao_atual = cabecalho.geracao;
+    copia_atual = destino;
+    return true;
+}
@@ -0,0 +1,36 @@
+#ifndef CONFIG_PERSISTENTE_H
+#define CONFIG_PERSISTENTE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Configuração do controle preservada entre reinicializações. Há duas cópias,
+//uma por setor: cada gravação apaga e escreve a cópia mais antiga com um contador
+//de geração maior, então uma queda de energia no meio da escrita mantém a outra.
+//O registro leva assinatura, versão, tamanho e CRC. Campos novos entram sempre no
+//fim da estrutura: registros de versões anteriores são lidos até o tamanho gravado
+//e os campos ausentes ficam zerados; versões futuras são ignoradas
+
+#define CONFIG_VERSAO 2 //2: cache de associação Wi-Fi
+
+typedef struct {
+    int16_t setpoint;          //Setpoint da zona principal (°C)
+    int16_t setpoint_minimo;   //Limites aceitos para o setpoint (°C)
+    int16_t setpoint_maximo;
+    uint8_t ligado;            //Sistema de controle em operação
+    uint8_t reservado;
+    float kp;
+    float ki;
+    float limite_integral;
+    uint8_t wifi_bssid[6];     //Último ponto de acesso associado (versão 2)
+    uint8_t wifi_canal;        //Canal desse ponto de acesso; 0 = sem cache
+    uint8_t reservado_wifi;
+} ConfiguracaoPersistente;
+
+//Carrega a cópia válida mais recente; retorna false se não houver nenhuma
+bool config_carregar(ConfiguracaoPersistente *config);
+
+//Grava a configuração sobre a cópia mais antiga (apaga um setor: chamar fora da task de controle)
+bool config_salvar(const ConfiguracaoPersistente *config);
+
+#endif // CONFIG_PERSISTENTE_H
@@ -0,0 +1,18 @@
+#include "crc.h"
+
+// Calcula o CRC-16/CCITT bit a bit (sem tabela, para economizar flash)
+uint16_t crc16_calcular(const void *dados, size_t tamanho) {
+    return crc16_continuar(0xFFFF, dados, tamanho);
+}
+
+// Acumula mais bytes sobre um CRC parcial
+uint16_t crc16_continuar(uint16_t crc, const void *dados, size_t tamanho) {
+    const uint8_t *bytes = dados;
+    for (size_t i = 0; i < tamanho; i++) {
+        crc ^= (uint16_t)bytes[i] << 8;
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+        }
+    }
+    return crc;
+}
@@ -0,0 +1,13 @@
+#ifndef CRC_H
+#define CRC_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//CRC-16/CCITT-FALSE (polinômio 0x1021, valor inicial 0xFFFF)
+uint16_t crc16_calcular(const void *dados, size_t tamanho);
+
+//Continua um CRC parcial com mais bytes (regiões não contíguas)
+uint16_t crc16_continuar(uint16_t crc, const void *dados, size_t tamanho);
+
+#endif // CRC_H
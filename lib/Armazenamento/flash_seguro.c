@@ -0,0 +1,44 @@
+#include "flash_seguro.h"
+#include "pico/stdlib.h"
+#include "pico/flash.h"
+#include "hardware/flash.h"
+
+#define TEMPO_LIMITE_FLASH_MS 100 //Espera máxima para pausar o outro núcleo/escalonador
+
+typedef struct {
+    uint32_t deslocamento;
+    const uint8_t *dados;
+    size_t tamanho;
+} OperacaoFlash;
+
+//Fim do binário definido pelo linker script do SDK
+extern char __flash_binary_end;
+
+// Executa o apagamento com o XIP pausado
+static void apagarSemXip(void *parametro) {
+    const OperacaoFlash *operacao = parametro;
+    flash_range_erase(operacao->deslocamento, operacao->tamanho);
+}
+
+// Executa a gravação com o XIP pausado
+static void programarSemXip(void *parametro) {
+    const OperacaoFlash *operacao = parametro;
+    flash_range_program(operacao->deslocamento, operacao->dados, operacao->tamanho);
+}
+
+// Apaga setores inteiros
+bool flash_seguro_apagar(uint32_t deslocamento, size_t tamanho) {
+    OperacaoFlash operacao = {deslocamento, NULL, tamanho};
+    return flash_safe_execute(apagarSemXip, &operacao, TEMPO_LIMITE_FLASH_MS) == PICO_OK;
+}
+
+// Grava páginas inteiras
+bool flash_seguro_programar(uint32_t deslocamento, const uint8_t *dados, size_t tamanho) {
+    OperacaoFlash operacao = {deslocamento, dados, tamanho};
+    return flash_safe_execute(programarSemXip, &operacao, TEMPO_LIMITE_FLASH_MS) == PICO_OK;
+}
+
+// Verifica se o firmware termina antes da região reservada
+bool flash_seguro_regiao_livre(uint32_t deslocamento) {
+    return (uintptr_t)&__flash_binary_end <= XIP_BASE + deslocamento;
+}
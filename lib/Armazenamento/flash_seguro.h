@@ -0,0 +1,20 @@
+#ifndef FLASH_SEGURO_H
+#define FLASH_SEGURO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//Apagar e gravar a flash pausa o XIP: as operações rodam via flash_safe_execute,
+//que desabilita interrupções e garante que nada execute da flash durante a escrita
+
+//Apaga setores inteiros (deslocamento e tamanho múltiplos de 4 KB)
+bool flash_seguro_apagar(uint32_t deslocamento, size_t tamanho);
+
+//Grava páginas inteiras (deslocamento e tamanho múltiplos de 256 bytes)
+bool flash_seguro_programar(uint32_t deslocamento, const uint8_t *dados, size_t tamanho);
+
+//Verifica se o firmware termina antes do deslocamento indicado
+bool flash_seguro_regiao_livre(uint32_t deslocamento);
+
+#endif // FLASH_SEGURO_H
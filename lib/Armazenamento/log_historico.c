@@ -0,0 +1,385 @@
+#include "log_historico.h"
+#include <string.h>
+#include <stddef.h>
+#include "pico/stdlib.h"
+#include "mapa_flash.h"
+#include "flash_seguro.h"
+#include "crc.h"
+
+#define MAGICO_PAGINA       0x4754u //"TG"
+#define PAGINAS_POR_SETOR   (FLASH_SECTOR_SIZE / FLASH_PAGE_SIZE)
+#define MAGICO_APAGADO      0xFFFFu
+
+//Cabeçalho no início de cada página
+typedef struct {
+    uint16_t magico;
+    uint16_t amostras;
+    uint32_t sequencia;       //Sequência do setor: a página 0 identifica o setor em escrita
+    uint16_t bytes;           //Tamanho do fluxo comprimido
+    uint16_t crc;             //CRC-16 do cabeçalho anterior ao campo e do fluxo
+} CabecalhoPagina;
+
+#define BYTES_FLUXO (FLASH_PAGE_SIZE - sizeof(CabecalhoPagina))
+
+_Static_assert(sizeof(CabecalhoPagina) == 12, "CabecalhoPagina deve ocupar 12 bytes");
+
+static struct {
+    bool ativo;
+    uint32_t setor_atual;     //Setor em escrita (índice dentro da região)
+    uint32_t sequencia_atual;
+    uint8_t pagina;           //Próxima página livre no setor atual
+    uint32_t tempo_base_s;
+    uint32_t gravados;
+    uint32_t paginas_gravadas;
+    uint32_t setor_gravado;   //Onde foi parar a última página gravada (o bloco em RAM pode abrir um setor novo)
+    uint8_t pagina_gravada;
+    uint32_t amostras_gravadas; //Só as páginas já gravadas ('gravados' inclui o bloco em RAM)
+    uint32_t bytes_gravados;
+    uint32_t falhas;
+    bool possui_ultimo;
+    Amostra ultimo;           //Última amostra gravada antes da reinicialização
+    uint8_t buffer[FLASH_PAGE_SIZE] __attribute__((aligned(4))); //Página em formação, ainda não gravada
+    CodificadorAmostras codificador;
+} log_estado;
+
+// Deslocamento na flash de uma página
+static uint32_t deslocamentoPagina(uint32_t setor, uint8_t pagina) {
+    return LOG_FLASH_INICIO + setor * FLASH_SECTOR_SIZE + pagina * FLASH_PAGE_SIZE;
+}
+
+static const uint8_t *ponteiroPagina(uint32_t setor, uint8_t pagina) {
+    return FLASH_PONTEIRO(deslocamentoPagina(setor, pagina));
+}
+
+// Lê e valida o cabeçalho e o CRC de uma página gravada
+static bool lerPagina(uint32_t setor, uint8_t pagina, CabecalhoPagina *cabecalho) {
+    const uint8_t *dados = ponteiroPagina(setor, pagina);
+    memcpy(cabecalho, dados, sizeof(*cabecalho));
+    if (cabecalho->magico != MAGICO_PAGINA || cabecalho->bytes > BYTES_FLUXO || !cabecalho->amostras) {
+        return false;
+    }
+    uint16_t crc = crc16_calcular(dados, offsetof(CabecalhoPagina, crc));
+    return cabecalho->crc == crc16_continuar(crc, dados + sizeof(*cabecalho), cabecalho->bytes);
+}
+
+// Lê a sequência do setor a partir da sua primeira página
+static bool lerSequenciaSetor(uint32_t setor, uint32_t *sequencia) {
+    CabecalhoPagina cabecalho;
+    if (!lerPagina(setor, 0, &cabecalho)) {
+        return false;
+    }
+    *sequencia = cabecalho.sequencia;
+    return true;
+}
+
+// Tempo da primeira amostra de uma página (a amostra-chave abre o fluxo)
+static bool primeiroTempo(uint32_t setor, uint8_t pagina, uint32_t *tempo_s) {
+    CabecalhoPagina cabecalho;
+    if (!lerPagina(setor, pagina, &cabecalho)) {
+        return false;
+    }
+    DecodificadorAmostras decodificador;
+    Amostra amostra;
+    codec_iniciar_decodificador(&decodificador, ponteiroPagina(setor, pagina) + sizeof(cabecalho), cabecalho.bytes, 1);
+    if (!codec_decodificar(&decodificador, &amostra)) {
+        return false;
+    }
+    *tempo_s = amostra.tempo_s;
+    return true;
+}
+
+// Última amostra de uma página
+static bool ultimaAmostra(uint32_t setor, uint8_t pagina, Amostra *ultima) {
+    CabecalhoPagina cabecalho;
+    if (!lerPagina(setor, pagina, &cabecalho)) {
+        return false;
+    }
+    DecodificadorAmostras decodificador;
+    bool encontrado = false;
+    codec_iniciar_decodificador(&decodificador, ponteiroPagina(setor, pagina) + sizeof(cabecalho), cabecalho.bytes, cabecalho.amostras);
+    while (codec_decodificar(&decodificador, ultima)) {
+        encontrado = true;
+    }
+    return encontrado;
+}
+
+// Recomeça o bloco em RAM
+static void iniciarBloco(void) {
+    memset(log_estado.buffer, 0xFF, sizeof(CabecalhoPagina));
+    codec_iniciar_codificador(&log_estado.codificador, log_estado.buffer + sizeof(CabecalhoPagina), BYTES_FLUXO);
+}
+
+// Fecha o cabeçalho, grava a página pendente e recomeça o bloco
+static void gravarPagina(void) {
+    CabecalhoPagina cabecalho = {
+        .magico = MAGICO_PAGINA,
+        .amostras = log_estado.codificador.amostras,
+        .sequencia = log_estado.sequencia_atual,
+        .bytes = codec_bytes_usados(&log_estado.codificador)
+    };
+    memcpy(log_estado.buffer, &cabecalho, sizeof(cabecalho));
+    //Bytes após o fluxo ficam apagados para não gastar bits da flash
+    memset(log_estado.buffer + sizeof(cabecalho) + cabecalho.bytes, 0xFF, BYTES_FLUXO - cabecalho.bytes);
+    uint16_t crc = crc16_calcular(log_estado.buffer, offsetof(CabecalhoPagina, crc));
+    cabecalho.crc = crc16_continuar(crc, log_estado.buffer + sizeof(cabecalho), cabecalho.bytes);
+    memcpy(log_estado.buffer, &cabecalho, sizeof(cabecalho));
+
+    if (!flash_seguro_programar(deslocamentoPagina(log_estado.setor_atual, log_estado.pagina), log_estado.buffer, FLASH_PAGE_SIZE)) {
+        log_estado.falhas++;
+    }
+    //Cursores lendo a página em RAM passam a lê-la da flash a partir daqui
+    log_estado.paginas_gravadas++;
+    log_estado.setor_gravado = log_estado.setor_atual;
+    log_estado.pagina_gravada = log_estado.pagina;
+    log_estado.amostras_gravadas += cabecalho.amostras;
+    log_estado.bytes_gravados += cabecalho.bytes;
+    log_estado.pagina++;
+    iniciarBloco();
+}
+
+// Avança para o próximo setor do anel, apagando-o
+static void avancarSetor(void) {
+    log_estado.setor_atual = (log_estado.setor_atual + 1) % LOG_FLASH_SETORES;
+    log_estado.sequencia_atual++;
+    if (!flash_seguro_apagar(LOG_FLASH_INICIO + log_estado.setor_atual * FLASH_SECTOR_SIZE, FLASH_SECTOR_SIZE)) {
+        log_estado.falhas++;
+    }
+    log_estado.pagina = 0;
+}
+
+// Localiza o fim do log e retoma a contagem de tempo
+bool log_inicializar(void) {
+    memset(&log_estado, 0, sizeof(log_estado));
+    iniciarBloco();
+    if (!flash_seguro_regiao_livre(LOG_FLASH_INICIO)) {
+        return false;
+    }
+    log_estado.ativo = true;
+
+    //O setor com maior sequência válida é o setor em escrita
+    bool encontrado = false;
+    for (uint32_t setor = 0; setor < LOG_FLASH_SETORES; setor++) {
+        uint32_t sequencia;
+        if (lerSequenciaSetor(setor, &sequencia) && (!encontrado || sequencia > log_estado.sequencia_atual)) {
+            encontrado = true;
+            log_estado.setor_atual = setor;
+            log_estado.sequencia_atual = sequencia;
+        }
+    }
+    if (!encontrado) {
+        //Log vazio: o primeiro bloco cheio apaga e inicia o setor 0
+        log_estado.setor_atual = LOG_FLASH_SETORES - 1;
+        log_estado.pagina = PAGINAS_POR_SETOR;
+        log_estado.tempo_base_s = 0;
+        return true;
+    }
+
+    //Páginas são gravadas em ordem: a primeira apagada marca o fim do log
+    uint8_t pagina = 1;
+    while (pagina < PAGINAS_POR_SETOR) {
+        const CabecalhoPagina *cabecalho = (const CabecalhoPagina *)ponteiroPagina(log_estado.setor_atual, pagina);
+        if (cabecalho->magico == MAGICO_APAGADO) break;
+        pagina++;
+    }
+    log_estado.pagina = pagina;
+
+    //O tempo continua a partir da última amostra válida (no setor atual ou no anterior)
+    bool achado = false;
+    for (int s = 0; s < 2 && !achado; s++) {
+        uint32_t setor = (log_estado.setor_atual + LOG_FLASH_SETORES - s) % LOG_FLASH_SETORES;
+        uint8_t limite = s == 0 ? pagina : PAGINAS_POR_SETOR;
+        for (int i = limite - 1; i >= 0 && !achado; i--) {
+            achado = ultimaAmostra(setor, i, &log_estado.ultimo);
+        }
+    }
+    log_estado.possui_ultimo = achado;
+    log_estado.tempo_base_s = achado ? log_estado.ultimo.tempo_s + 1 : 0;
+    return true;
+}
+
+// Tempo atual do log
+uint32_t log_tempo_atual(void) {
+    return log_estado.tempo_base_s + to_ms_since_boot(get_absolute_time()) / 1000;
+}
+
+// Última amostra que chegou à flash antes da reinicialização
+bool log_ultimo_registro(RegistroLog *registro) {
+    if (log_estado.possui_ultimo) {
+        *registro = log_estado.ultimo;
+    }
+    return log_estado.possui_ultimo;
+}
+
+// Comprime um registro no bloco em RAM e grava a página quando ela enche
+void log_adicionar(const RegistroLog *registro) {
+    if (!log_estado.ativo) {
+        return;
+    }
+    if (codec_codificar(&log_estado.codificador, registro)) {
+        log_estado.gravados++;
+        return;
+    }
+
+    //Bloco cheio: grava e recomeça com este registro como amostra-chave
+    if (log_estado.pagina >= PAGINAS_POR_SETOR) {
+        avancarSetor();
+    }
+    gravarPagina();
+    if (codec_codificar(&log_estado.codificador, registro)) {
+        log_estado.gravados++;
+    }
+}
+
+// Abre um cursor por faixa de tempo
+void log_cursor_abrir(CursorLog *cursor, uint32_t de_s, uint32_t ate_s, uint32_t passo_s) {
+    memset(cursor, 0, sizeof(*cursor));
+    cursor->de_s = de_s;
+    cursor->ate_s = ate_s;
+    cursor->passo_s = passo_s ? passo_s : 1;
+    cursor->proximo_s = de_s;
+    //Começa pelo setor mais antigo: o seguinte ao setor em escrita
+    cursor->setor = (log_estado.setor_atual + 1) % LOG_FLASH_SETORES;
+    cursor->fim = !log_estado.ativo;
+}
+
+// Passa para o próximo setor do anel
+static void avancarCursor(CursorLog *cursor) {
+    cursor->setor = (cursor->setor + 1) % LOG_FLASH_SETORES;
+    cursor->pagina = 0;
+    cursor->setores_visitados++;
+}
+
+// Verifica se o setor pode ser ignorado porque o seguinte já começa antes da faixa
+static bool setorAnteriorAFaixa(const CursorLog *cursor) {
+    if (cursor->setor == log_estado.setor_atual) {
+        return false;
+    }
+    uint32_t seguinte = (cursor->setor + 1) % LOG_FLASH_SETORES;
+    uint32_t tempo_s;
+    return primeiroTempo(seguinte, 0, &tempo_s) && tempo_s <= cursor->de_s;
+}
+
+// Abre a próxima página do setor (ou o bloco em RAM, no setor em escrita)
+static bool abrirPagina(CursorLog *cursor) {
+    bool setor_atual = cursor->setor == log_estado.setor_atual;
+    uint8_t gravadas = setor_atual ? log_estado.pagina : PAGINAS_POR_SETOR;
+
+    while (cursor->pagina < gravadas) {
+        uint8_t pagina = cursor->pagina++;
+        //Pula a página se a seguinte ainda começa antes da faixa
+        uint32_t tempo_s;
+        if (cursor->pagina < gravadas && primeiroTempo(cursor->setor, cursor->pagina, &tempo_s) && tempo_s <= cursor->de_s) {
+            continue;
+        }
+        CabecalhoPagina cabecalho;
+        if (lerPagina(cursor->setor, pagina, &cabecalho)) {
+            codec_iniciar_decodificador(&cursor->decodificador, ponteiroPagina(cursor->setor, pagina) + sizeof(cabecalho),
+                                        cabecalho.bytes, cabecalho.amostras);
+            cursor->pagina_pendente = false;
+            return true;
+        }
+    }
+
+    if (setor_atual && cursor->pagina == gravadas && log_estado.codificador.amostras) {
+        cursor->pagina++;
+        codec_iniciar_decodificador(&cursor->decodificador, log_estado.codificador.buffer, BYTES_FLUXO,
+                                    log_estado.codificador.amostras);
+        cursor->pagina_pendente = true;
+        cursor->geracao = log_estado.paginas_gravadas;
+        return true;
+    }
+    return false;
+}
+
+// Próxima amostra da página aberta; o bloco em RAM pode crescer ou ir para a flash durante a leitura
+static bool decodificarAmostra(CursorLog *cursor, Amostra *amostra) {
+    DecodificadorAmostras *decodificador = &cursor->decodificador;
+    if (cursor->pagina_pendente) {
+        if (cursor->geracao != log_estado.paginas_gravadas) {
+            //O bloco foi gravado na mesma disposição: continua a leitura a partir da flash,
+            //no setor em que ele foi parar (o seguinte, se o setor do cursor estava cheio)
+            uint32_t setor = log_estado.setor_gravado;
+            uint8_t pagina = log_estado.pagina_gravada;
+            CabecalhoPagina cabecalho;
+            cursor->pagina_pendente = false;
+            if (cursor->geracao + 1 != log_estado.paginas_gravadas || !lerPagina(setor, pagina, &cabecalho)) {
+                return false;
+            }
+            cursor->setor = setor;
+            cursor->pagina = pagina + 1;
+            decodificador->buffer = ponteiroPagina(setor, pagina) + sizeof(cabecalho);
+            decodificador->tamanho = cabecalho.bytes;
+            decodificador->restantes = cabecalho.amostras - decodificador->decodificadas;
+        } else {
+            decodificador->restantes = log_estado.codificador.amostras - decodificador->decodificadas;
+        }
+    }
+    return codec_decodificar(decodificador, amostra);
+}
+
+// Obtém o próximo registro da faixa
+bool log_cursor_proximo(CursorLog *cursor, RegistroLog *registro) {
+    while (!cursor->fim) {
+        if (cursor->setores_visitados >= LOG_FLASH_SETORES) {
+            cursor->fim = true;
+            break;
+        }
+
+        //Ao entrar em um setor, descarta setores vazios ou inteiramente antes da faixa
+        if (cursor->pagina == 0 && !cursor->pagina_aberta) {
+            uint32_t sequencia;
+            bool valido = cursor->setor == log_estado.setor_atual || lerSequenciaSetor(cursor->setor, &sequencia);
+            if (!valido || setorAnteriorAFaixa(cursor)) {
+                avancarCursor(cursor);
+                continue;
+            }
+        }
+
+        if (!cursor->pagina_aberta) {
+            if (!abrirPagina(cursor)) {
+                if (cursor->setor == log_estado.setor_atual) {
+                    //O setor em escrita é o último do anel
+                    cursor->fim = true;
+                    break;
+                }
+                avancarCursor(cursor);
+                continue;
+            }
+            cursor->pagina_aberta = true;
+        }
+
+        RegistroLog lido;
+        if (!decodificarAmostra(cursor, &lido)) {
+            cursor->pagina_aberta = false;
+            continue;
+        }
+        if (lido.tempo_s > cursor->ate_s) {
+            cursor->fim = true;
+            break;
+        }
+        if (lido.tempo_s < cursor->proximo_s) {
+            continue;
+        }
+        *registro = lido;
+        cursor->proximo_s = lido.tempo_s + cursor->passo_s;
+        return true;
+    }
+    return false;
+}
+
+// Estatísticas para diagnóstico
+uint32_t log_registros_gravados(void) {
+    return log_estado.gravados;
+}
+
+uint32_t log_falhas_gravacao(void) {
+    return log_estado.falhas;
+}
+
+uint32_t log_amostras_gravadas(void) {
+    return log_estado.amostras_gravadas;
+}
+
+uint32_t log_bytes_gravados(void) {
+    return log_estado.bytes_gravados;
+}
@@ -0,0 +1,58 @@
+#ifndef LOG_HISTORICO_H
+#define LOG_HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "codec_amostras.h"
+
+//Log circular somente-anexação na flash. Cada página de 256 bytes guarda um
+//bloco comprimido (codec_amostras) com cabeçalho próprio: sequência do setor,
+//quantidade de amostras e CRC. Os registros são comprimidos em RAM e a página é
+//gravada quando enche; o anel percorre todos os setores da região, distribuindo
+//o desgaste. Amostras ainda em RAM se perdem em uma reinicialização
+
+//Tempo do log é contínuo entre reinicializações
+typedef Amostra RegistroLog;
+
+//Cursor de leitura por faixa de tempo, sem carregar a faixa em RAM
+typedef struct {
+    uint32_t de_s;
+    uint32_t ate_s;
+    uint32_t passo_s;
+    uint32_t proximo_s;       //Menor tempo aceito para o próximo registro
+    uint32_t setores_visitados;
+    uint32_t setor;
+    uint8_t pagina;           //Próxima página a abrir no setor; 0 indica setor não validado
+    bool pagina_aberta;
+    bool pagina_pendente;     //Decodificando a página ainda em RAM
+    uint32_t geracao;         //Páginas gravadas quando a página em RAM foi aberta
+    DecodificadorAmostras decodificador;
+    bool fim;
+} CursorLog;
+
+//Localiza o fim do log na flash e retoma a contagem de tempo; retorna false
+//se a região reservada colide com o firmware (log desativado)
+bool log_inicializar(void);
+
+//Tempo atual do log em segundos
+uint32_t log_tempo_atual(void);
+
+//Última amostra gravada na flash antes desta inicialização; false se o log estiver vazio
+bool log_ultimo_registro(RegistroLog *registro);
+
+//Anexa um registro; grava a página quando ela enche (chamar fora da task de controle)
+void log_adicionar(const RegistroLog *registro);
+
+//Abre um cursor para [de_s, ate_s] devolvendo no máximo um registro a cada passo_s
+void log_cursor_abrir(CursorLog *cursor, uint32_t de_s, uint32_t ate_s, uint32_t passo_s);
+
+//Obtém o próximo registro da faixa; retorna false ao terminar
+bool log_cursor_proximo(CursorLog *cursor, RegistroLog *registro);
+
+//Estatísticas para diagnóstico
+uint32_t log_registros_gravados(void);  //Inclui as amostras do bloco ainda em RAM
+uint32_t log_falhas_gravacao(void);
+uint32_t log_amostras_gravadas(void);   //Amostras nas páginas já gravadas na flash
+uint32_t log_bytes_gravados(void);      //Bytes de fluxo comprimido dessas páginas: com log_amostras_gravadas, a taxa de compressão
+
+#endif // LOG_HISTORICO_H
@@ -0,0 +1,20 @@
+#ifndef MAPA_FLASH_H
+#define MAPA_FLASH_H
+
+#include "pico/stdlib.h"
+#include "hardware/flash.h"
+
+//Mapa da flash QSPI: o firmware ocupa o início; o log de histórico e as duas
+//cópias da configuração ficam reservados no final, alinhados a setores de 4 KB
+
+#define CONFIG_FLASH_TAMANHO (2u * FLASH_SECTOR_SIZE) //Duas cópias da configuração, um setor cada
+#define CONFIG_FLASH_INICIO  (PICO_FLASH_SIZE_BYTES - CONFIG_FLASH_TAMANHO)
+
+#define LOG_FLASH_TAMANHO  (1024u * 1024u) //1 MB para o log de histórico
+#define LOG_FLASH_INICIO   (CONFIG_FLASH_INICIO - LOG_FLASH_TAMANHO)
+#define LOG_FLASH_SETORES  (LOG_FLASH_TAMANHO / FLASH_SECTOR_SIZE)
+
+//Endereço mapeado (XIP) para leitura direta de um deslocamento na flash
+#define FLASH_PONTEIRO(deslocamento) ((const uint8_t *)(XIP_BASE + (deslocamento)))
+
+#endif // MAPA_FLASH_H
@@ -0,0 +1,141 @@
+#include "barramento_i2c.h"
+#include <stdio.h>
+#include "pico/stdlib.h"
+
+//Nó da fila, na pilha da task que espera
+struct EsperaBarramentoI2C {
+    TaskHandle_t tarefa;
+    uint8_t prioridade;
+    EsperaBarramentoI2C *proxima;
+};
+
+void barramento_i2c_inicializar(BarramentoI2C *barramento, i2c_inst_t *porta) {
+    *barramento = (BarramentoI2C){0};
+    barramento->porta = porta;
+}
+
+void barramento_i2c_dispositivo(DispositivoI2C *dispositivo, BarramentoI2C *barramento,
+                                uint8_t endereco, uint8_t prioridade) {
+    dispositivo->barramento = barramento;
+    dispositivo->endereco = endereco;
+    dispositivo->prioridade = prioridade;
+}
+
+static bool escalonador_ativo(void) {
+    return xTaskGetSchedulerState() == taskSCHEDULER_RUNNING;
+}
+
+static void adquirir(BarramentoI2C *barramento, uint8_t prioridade) {
+    if (!escalonador_ativo()) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    if (!barramento->ocupado) {
+        barramento->ocupado = true;
+        taskEXIT_CRITICAL();
+        return;
+    }
+
+    //Entra depois de todos com prioridade maior ou igual
+    EsperaBarramentoI2C espera = {xTaskGetCurrentTaskHandle(), prioridade, NULL};
+    EsperaBarramentoI2C **posicao = &barramento->fila;
+    uint32_t na_fila = 1;
+    while (*posicao && (*posicao)->prioridade >= prioridade) {
+        posicao = &(*posicao)->proxima;
+        na_fila++;
+    }
+    espera.proxima = *posicao;
+    *posicao = &espera;
+    for (EsperaBarramentoI2C *depois = espera.proxima; depois; depois = depois->proxima) {
+        na_fila++;
+    }
+    barramento->esperas++;
+    if (na_fila > barramento->fila_maxima) {
+        barramento->fila_maxima = na_fila;
+    }
+    taskEXIT_CRITICAL();
+
+    //Quem libera mantém 'ocupado' e passa o barramento direto para esta task
+    uint64_t inicio = time_us_64();
+    ulTaskNotifyTakeIndexed(BARRAMENTO_I2C_NOTIFICACAO, pdTRUE, portMAX_DELAY);
+    uint32_t esperado = (uint32_t)(time_us_64() - inicio);
+    if (esperado > barramento->espera_maxima_us) {
+        barramento->espera_maxima_us = esperado;
+    }
+}
+
+static void liberar(BarramentoI2C *barramento) {
+    if (!escalonador_ativo()) {
+        return;
+    }
+
+    taskENTER_CRITICAL();
+    EsperaBarramentoI2C *proxima = barramento->fila;
+    if (proxima) {
+        barramento->fila = proxima->proxima;
+    } else {
+        barramento->ocupado = false;
+    }
+    taskEXIT_CRITICAL();
+
+    if (proxima) {
+        xTaskNotifyGiveIndexed(proxima->tarefa, BARRAMENTO_I2C_NOTIFICACAO);
+    }
+}
+
+int barramento_i2c_escrever(DispositivoI2C *dispositivo, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                            const uint8_t *dados, size_t tamanho_dados) {
+    BarramentoI2C *barramento = dispositivo->barramento;
+    adquirir(barramento, dispositivo->prioridade);
+
+    int resultado;
+    if (tamanho_dados) {
+        //Burst: o controlador segura o SCL entre as duas partes, sem STOP nem novo endereço
+        resultado = i2c_write_burst_blocking(barramento->porta, dispositivo->endereco, cabecalho, tamanho_cabecalho);
+        if (resultado >= 0) {
+            int restante = i2c_write_blocking(barramento->porta, dispositivo->endereco, dados, tamanho_dados, false);
+            resultado = restante >= 0 ? resultado + restante : restante;
+        }
+    } else {
+        resultado = i2c_write_blocking(barramento->porta, dispositivo->endereco, cabecalho, tamanho_cabecalho, false);
+    }
+
+    barramento->transacoes++;
+    if (resultado > 0) {
+        barramento->bytes += (uint32_t)resultado;
+    }
+    liberar(barramento);
+    return resultado;
+}
+
+int barramento_i2c_escrever_ler(DispositivoI2C *dispositivo, const uint8_t *escrita, size_t tamanho_escrita,
+                                uint8_t *leitura, size_t tamanho_leitura) {
+    BarramentoI2C *barramento = dispositivo->barramento;
+    adquirir(barramento, dispositivo->prioridade);
+
+    int resultado = i2c_write_blocking(barramento->porta, dispositivo->endereco, escrita, tamanho_escrita, true);
+    if (resultado >= 0) {
+        resultado = i2c_read_blocking(barramento->porta, dispositivo->endereco, leitura, tamanho_leitura, false);
+    }
+
+    barramento->transacoes++;
+    if (resultado > 0) {
+        barramento->bytes += tamanho_escrita + (uint32_t)resultado;
+    }
+    liberar(barramento);
+    return resultado;
+}
+
+void barramento_i2c_transporte(void *contexto, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                               const uint8_t *dados, size_t tamanho_dados) {
+    barramento_i2c_escrever((DispositivoI2C *)contexto, cabecalho, tamanho_cabecalho, dados, tamanho_dados);
+}
+
+int barramento_i2c_json(const BarramentoI2C *barramento, char *buffer, size_t tamanho) {
+    return snprintf(buffer, tamanho,
+                    "{\"transacoes\":%lu,\"esperas\":%lu,\"fila_maxima\":%lu,\"espera_maxima_us\":%lu,\"bytes\":%llu}",
+                    (unsigned long)barramento->transacoes, (unsigned long)barramento->esperas,
+                    (unsigned long)barramento->fila_maxima, (unsigned long)barramento->espera_maxima_us,
+                    (unsigned long long)barramento->bytes);
+}
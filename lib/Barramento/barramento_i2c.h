@@ -0,0 +1,68 @@
+#ifndef BARRAMENTO_I2C_H
+#define BARRAMENTO_I2C_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "hardware/i2c.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+//Árbitro de um barramento I2C compartilhado por vários dispositivos (displays
+//SSD1306 ou outros) sem uma task dedicada. Quem transfere com o barramento
+//livre segue direto; com o barramento ocupado a task entra em uma fila
+//ordenada pela prioridade da transferência (FIFO dentro da mesma prioridade)
+//e dorme até quem está transferindo lhe passar o barramento.
+//Antes do escalonador iniciar as transferências rodam direto, sem fila
+
+#define BARRAMENTO_I2C_NOTIFICACAO 1 //Índice da notificação de task usado para passar o barramento
+
+//Prioridades sugeridas; qualquer valor de 0 a 255 vale (maior passa na frente)
+#define BARRAMENTO_I2C_PRIORIDADE_BAIXA  0
+#define BARRAMENTO_I2C_PRIORIDADE_NORMAL 128
+#define BARRAMENTO_I2C_PRIORIDADE_ALTA   255
+
+typedef struct EsperaBarramentoI2C EsperaBarramentoI2C;
+
+typedef struct {
+    i2c_inst_t *porta;
+    bool ocupado;
+    EsperaBarramentoI2C *fila;     //Tasks aguardando, em ordem de atendimento
+
+    //Métricas
+    uint32_t transacoes;
+    uint32_t esperas;              //Transações que encontraram o barramento ocupado
+    uint32_t fila_maxima;
+    uint32_t espera_maxima_us;
+    uint64_t bytes;
+} BarramentoI2C;
+
+//Um endereço no barramento com a prioridade de suas transferências
+typedef struct {
+    BarramentoI2C *barramento;
+    uint8_t endereco;
+    uint8_t prioridade;
+} DispositivoI2C;
+
+void barramento_i2c_inicializar(BarramentoI2C *barramento, i2c_inst_t *porta);
+
+void barramento_i2c_dispositivo(DispositivoI2C *dispositivo, BarramentoI2C *barramento,
+                                uint8_t endereco, uint8_t prioridade);
+
+//Uma transação de escrita: cabeçalho e dados (opcional) sem STOP entre eles.
+//Retorna o número de bytes escritos ou um código de erro do SDK
+int barramento_i2c_escrever(DispositivoI2C *dispositivo, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                            const uint8_t *dados, size_t tamanho_dados);
+
+//Escrita seguida de leitura com repeated start (ex.: registrador de um sensor)
+int barramento_i2c_escrever_ler(DispositivoI2C *dispositivo, const uint8_t *escrita, size_t tamanho_escrita,
+                                uint8_t *leitura, size_t tamanho_leitura);
+
+//Adaptador para ssd1306_set_transporte; contexto é um DispositivoI2C
+void barramento_i2c_transporte(void *contexto, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                               const uint8_t *dados, size_t tamanho_dados);
+
+//Serializa as métricas como objeto JSON; retorna o número de caracteres escritos
+int barramento_i2c_json(const BarramentoI2C *barramento, char *buffer, size_t tamanho);
+
+#endif // BARRAMENTO_I2C_H
@@ -0,0 +1,97 @@
+#include "sequenciador_tons.h"
+#include "hardware/pwm.h"
+#include "hardware/clocks.h"
+
+#define DIVISOR_MINIMO_16  16   //Divisor 1.0 em unidades de 1/16 (formato 8.4 do PWM)
+#define DIVISOR_MAXIMO_16  4095 //Divisor 255 + 15/16
+
+//Valores de registrador prontos para uma nota
+typedef struct {
+    uint8_t divisor_inteiro;
+    uint8_t divisor_fracao;
+    uint16_t topo;
+    uint16_t nivel;           //0 em silêncio
+    uint32_t duracao_us;
+} RegistrosNota;
+
+static struct {
+    uint fatia;
+    uint canal;
+    RegistrosNota notas[SEQUENCIADOR_MAX_NOTAS];
+    uint8_t quantidade;
+    volatile uint8_t indice;  //Próxima nota a tocar (avançado pelo alarme)
+    alarm_id_t alarme;        //0 = nenhum padrão tocando
+} sequenciador;
+
+// Converte frequência em divisor e topo com a maior resolução possível (onda quadrada 50%)
+static void calcularRegistros(const NotaTom *nota, RegistrosNota *registros) {
+    registros->duracao_us = (uint32_t)nota->duracao_ms * 1000u;
+    if (!nota->frequencia_hz) {
+        registros->divisor_inteiro = 1;
+        registros->divisor_fracao = 0;
+        registros->topo = 0xFFFF;
+        registros->nivel = 0;
+        return;
+    }
+
+    uint64_t base = (uint64_t)clock_get_hz(clk_sys) * 16u;
+    uint64_t divisor = (base + (uint64_t)nota->frequencia_hz * 65536u - 1) / ((uint64_t)nota->frequencia_hz * 65536u);
+    if (divisor < DIVISOR_MINIMO_16) divisor = DIVISOR_MINIMO_16;
+    if (divisor > DIVISOR_MAXIMO_16) divisor = DIVISOR_MAXIMO_16;
+    uint64_t contagens = base / (divisor * nota->frequencia_hz);
+    if (contagens > 65536u) contagens = 65536u;
+    if (contagens < 2u) contagens = 2u;
+
+    registros->divisor_inteiro = (uint8_t)(divisor >> 4);
+    registros->divisor_fracao = (uint8_t)(divisor & 0xF);
+    registros->topo = (uint16_t)(contagens - 1);
+    registros->nivel = (uint16_t)(contagens / 2);
+}
+
+// Alarme: aplica a nota atual e se reagenda para o fim dela
+static int64_t tocarNota(alarm_id_t id, void *dados) {
+    const RegistrosNota *nota = &sequenciador.notas[sequenciador.indice];
+    if (nota->nivel) {
+        pwm_set_clkdiv_int_frac(sequenciador.fatia, nota->divisor_inteiro, nota->divisor_fracao);
+        pwm_set_wrap(sequenciador.fatia, nota->topo);
+    }
+    pwm_set_chan_level(sequenciador.fatia, sequenciador.canal, nota->nivel);
+    sequenciador.indice = (sequenciador.indice + 1) % sequenciador.quantidade;
+
+    //Valor positivo reagenda a partir do instante previsto deste disparo, sem deriva
+    return nota->duracao_us ? (int64_t)nota->duracao_us : 1000;
+}
+
+void sequenciador_tons_inicializar(uint pino) {
+    gpio_set_function(pino, GPIO_FUNC_PWM);
+    sequenciador.fatia = pwm_gpio_to_slice_num(pino);
+    sequenciador.canal = pwm_gpio_to_channel(pino);
+    sequenciador.alarme = 0;
+    pwm_set_chan_level(sequenciador.fatia, sequenciador.canal, 0);
+    pwm_set_enabled(sequenciador.fatia, true);
+}
+
+void sequenciador_tons_parar(void) {
+    if (sequenciador.alarme > 0) {
+        cancel_alarm(sequenciador.alarme);
+    }
+    sequenciador.alarme = 0;
+    pwm_set_chan_level(sequenciador.fatia, sequenciador.canal, 0);
+}
+
+void sequenciador_tons_tocar(const NotaTom *notas, uint8_t quantidade) {
+    //Com o alarme cancelado a tabela pode ser reescrita sem disputa com a interrupção
+    sequenciador_tons_parar();
+    if (!notas || !quantidade) {
+        return;
+    }
+    if (quantidade > SEQUENCIADOR_MAX_NOTAS) {
+        quantidade = SEQUENCIADOR_MAX_NOTAS;
+    }
+    for (uint8_t i = 0; i < quantidade; i++) {
+        calcularRegistros(&notas[i], &sequenciador.notas[i]);
+    }
+    sequenciador.quantidade = quantidade;
+    sequenciador.indice = 0;
+    sequenciador.alarme = add_alarm_in_us(10, tocarNota, NULL, true);
+}
@@ -0,0 +1,31 @@
+#ifndef SEQUENCIADOR_TONS_H
+#define SEQUENCIADOR_TONS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+
+//Sequenciador de tons para o buzzer: um padrão é uma tabela de notas
+//(frequência, duração) tocada em laço por um alarme de hardware que escreve
+//direto nos registradores do PWM. Os valores de divisor, topo e nível são
+//calculados uma vez ao trocar de padrão; o alarme só copia registradores e
+//se reagenda relativo ao instante previsto, então as durações não acumulam atraso
+
+#define SEQUENCIADOR_MAX_NOTAS 16
+
+typedef struct {
+    uint16_t frequencia_hz; //0 = silêncio
+    uint16_t duracao_ms;
+} NotaTom;
+
+//Configura o pino do buzzer como saída PWM, em silêncio
+void sequenciador_tons_inicializar(uint pino);
+
+//Toca o padrão em laço a partir da primeira nota; quantidade 0 silencia.
+//Chamar apenas ao trocar de padrão (não de dentro de interrupções)
+void sequenciador_tons_tocar(const NotaTom *notas, uint8_t quantidade);
+
+//Interrompe o padrão atual e silencia o buzzer
+void sequenciador_tons_parar(void);
+
+#endif // SEQUENCIADOR_TONS_H
@@ -0,0 +1,155 @@
+#include "autotune.h"
+#include "controle_pi.h"
+#include <math.h>
+
+#define PI_F 3.14159265f
+
+// Calcula Ku, Pu e os ganhos do PI a partir das médias medidas
+static void calcularGanhos(Autotune *autotune) {
+    uint8_t medidos = autotune->ciclos - 1;
+    float amplitude_oscilacao = autotune->soma_amplitudes / medidos;
+    float periodo = autotune->soma_periodos / medidos;
+
+    //Corrige a amplitude pela histerese do relé (função descritiva com banda morta)
+    float quadrado = amplitude_oscilacao * amplitude_oscilacao - autotune->histerese * autotune->histerese;
+    float amplitude_efetiva = quadrado > 0.0f ? sqrtf(quadrado) : amplitude_oscilacao;
+    if (amplitude_efetiva <= 0.0f || periodo <= 0.0f) {
+        autotune->estado = AUTOTUNE_FALHOU;
+        return;
+    }
+
+    autotune->ganho_critico = 4.0f * autotune->amplitude / (PI_F * amplitude_efetiva);
+    autotune->periodo_critico_s = periodo;
+
+    float tempo_integral;
+    if (autotune->regra == REGRA_TYREUS_LUYBEN) {
+        autotune->kp = autotune->ganho_critico / 3.2f;
+        tempo_integral = 2.2f * periodo;
+    } else {
+        autotune->kp = 0.45f * autotune->ganho_critico;
+        tempo_integral = periodo / 1.2f;
+    }
+    autotune->ki = autotune->kp / tempo_integral;
+    autotune->estado = AUTOTUNE_CONCLUIDO;
+}
+
+// Inicia o ensaio do relé
+void autotune_iniciar(Autotune *autotune, float setpoint, float histerese, float amplitude, RegraSintonia regra) {
+    autotune->setpoint = setpoint;
+    autotune->histerese = histerese;
+    autotune->amplitude = amplitude;
+    autotune->tempo_limite_s = 1800.0f;
+    autotune->ciclos_desejados = 3;
+    autotune->regra = regra;
+
+    autotune->estado = AUTOTUNE_EXECUTANDO;
+    autotune->saida_alta = false;
+    autotune->tempo_s = 0.0f;
+    autotune->temperatura_max = -1000.0f;
+    autotune->temperatura_min = 1000.0f;
+    autotune->inicio_ciclo_s = -1.0f;
+    autotune->ciclos = 0;
+    autotune->soma_amplitudes = 0.0f;
+    autotune->soma_periodos = 0.0f;
+
+    autotune->ganho_critico = 0.0f;
+    autotune->periodo_critico_s = 0.0f;
+    autotune->kp = 0.0f;
+    autotune->ki = 0.0f;
+}
+
+// Executa um passo do ensaio do relé
+uint16_t autotune_passo(Autotune *autotune, float temperatura, float intervalo_s) {
+    if (autotune->estado != AUTOTUNE_EXECUTANDO) {
+        return 0;
+    }
+
+    autotune->tempo_s += intervalo_s;
+    autotune->temperatura_max = fmaxf(autotune->temperatura_max, temperatura);
+    autotune->temperatura_min = fminf(autotune->temperatura_min, temperatura);
+
+    //Relé com histerese: acima da banda resfria ao máximo, abaixo desliga
+    if (autotune->saida_alta && temperatura < autotune->setpoint - autotune->histerese) {
+        autotune->saida_alta = false;
+    } else if (!autotune->saida_alta && temperatura > autotune->setpoint + autotune->histerese) {
+        autotune->saida_alta = true;
+
+        //Cada comutação para o nível alto fecha um ciclo completo
+        if (autotune->inicio_ciclo_s >= 0.0f) {
+            autotune->ciclos++;
+            //O primeiro ciclo é transitório e não entra nas médias
+            if (autotune->ciclos > 1) {
+                autotune->soma_amplitudes += (autotune->temperatura_max - autotune->temperatura_min) / 2.0f;
+                autotune->soma_periodos += autotune->tempo_s - autotune->inicio_ciclo_s;
+            }
+            autotune->temperatura_max = temperatura;
+            autotune->temperatura_min = temperatura;
+        }
+        autotune->inicio_ciclo_s = autotune->tempo_s;
+
+        if (autotune->ciclos > autotune->ciclos_desejados) {
+            calcularGanhos(autotune);
+            return 0;
+        }
+    }
+
+    if (autotune->tempo_s > autotune->tempo_limite_s) {
+        autotune->estado = AUTOTUNE_FALHOU;
+        return 0;
+    }
+
+    return controle_pi_sinal_para_pwm(autotune->saida_alta ? autotune->amplitude : -autotune->amplitude);
+}
+
+// Interrompe o ensaio
+void autotune_cancelar(Autotune *autotune) {
+    if (autotune->estado == AUTOTUNE_EXECUTANDO) {
+        autotune->estado = AUTOTUNE_INATIVO;
+    }
+}
+
+// Inicia a medição da resposta em malha fechada
+void avaliador_iniciar(AvaliadorResposta *avaliador, float setpoint, float temperatura, float banda, float janela_estavel_s) {
+    avaliador->ativo = true;
+    avaliador->concluido = false;
+    avaliador->setpoint = setpoint;
+    avaliador->banda = banda;
+    avaliador->janela_estavel_s = janela_estavel_s;
+    avaliador->tempo_s = 0.0f;
+    avaliador->ultimo_fora_s = 0.0f;
+    avaliador->erro_inicial = temperatura - setpoint;
+    avaliador->sobressinal = 0.0f;
+    avaliador->tempo_acomodacao_s = 0.0f;
+}
+
+// Registra uma amostra da resposta
+void avaliador_passo(AvaliadorResposta *avaliador, float temperatura, float intervalo_s) {
+    if (!avaliador->ativo) {
+        return;
+    }
+
+    avaliador->tempo_s += intervalo_s;
+    float desvio = temperatura - avaliador->setpoint;
+
+    //Sobressinal é a ultrapassagem no sentido oposto ao erro inicial
+    float ultrapassagem;
+    if (avaliador->erro_inicial > 0.0f) {
+        ultrapassagem = -desvio;
+    } else if (avaliador->erro_inicial < 0.0f) {
+        ultrapassagem = desvio;
+    } else {
+        ultrapassagem = fabsf(desvio);
+    }
+    avaliador->sobressinal = fmaxf(avaliador->sobressinal, ultrapassagem);
+
+    if (fabsf(desvio) > avaliador->banda) {
+        avaliador->ultimo_fora_s = avaliador->tempo_s;
+    }
+
+    //Acomodado quando permanece na faixa durante toda a janela
+    if (avaliador->tempo_s - avaliador->ultimo_fora_s >= avaliador->janela_estavel_s) {
+        avaliador->tempo_acomodacao_s = avaliador->ultimo_fora_s;
+        avaliador->concluido = true;
+        avaliador->ativo = false;
+    }
+}
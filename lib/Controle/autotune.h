@@ -0,0 +1,79 @@
+#ifndef AUTOTUNE_H
+#define AUTOTUNE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Ensaio de realimentação por relé (Åström–Hägglund) para identificar
+//o ganho e o período críticos da planta e calcular os ganhos do PI
+
+//Regras de sintonia disponíveis a partir de (Ku, Pu)
+typedef enum {
+    REGRA_ZIEGLER_NICHOLS, //Kp = 0,45 Ku, Ti = Pu / 1,2 (resposta rápida)
+    REGRA_TYREUS_LUYBEN    //Kp = Ku / 3,2, Ti = 2,2 Pu (menos sobressinal)
+} RegraSintonia;
+
+typedef enum {
+    AUTOTUNE_INATIVO,
+    AUTOTUNE_EXECUTANDO,
+    AUTOTUNE_CONCLUIDO,
+    AUTOTUNE_FALHOU
+} EstadoAutotune;
+
+typedef struct {
+    //Configuração do ensaio
+    float setpoint;           //Temperatura em torno da qual o relé oscila (°C)
+    float histerese;          //Banda morta do relé (°C), acima do ruído do sensor
+    float amplitude;          //Amplitude do relé no sinal de controle (0 a 4096)
+    float tempo_limite_s;     //Desiste se não houver oscilação sustentada
+    uint8_t ciclos_desejados; //Ciclos medidos após o transitório inicial
+    RegraSintonia regra;
+
+    //Estado do ensaio
+    EstadoAutotune estado;
+    bool saida_alta;          //Relé no nível alto (resfriamento máximo)
+    float tempo_s;            //Tempo decorrido desde o início
+    float temperatura_max;    //Extremos do ciclo atual
+    float temperatura_min;
+    float inicio_ciclo_s;     //Instante da última comutação para o nível alto
+    uint8_t ciclos;           //Ciclos completos (inclui o transitório)
+    float soma_amplitudes;
+    float soma_periodos;
+
+    //Resultados
+    float ganho_critico;      //Ku
+    float periodo_critico_s;  //Pu
+    float kp;
+    float ki;
+} Autotune;
+
+//Métricas da resposta em malha fechada após aplicar novos ganhos
+typedef struct {
+    bool ativo;
+    bool concluido;
+    float setpoint;
+    float banda;              //Faixa de acomodação (°C)
+    float janela_estavel_s;   //Tempo dentro da faixa para declarar acomodação
+    float tempo_s;
+    float ultimo_fora_s;      //Último instante fora da faixa
+    float erro_inicial;       //Sinal do erro no início (define o sentido do sobressinal)
+    float sobressinal;        //Maior ultrapassagem do setpoint (°C)
+    float tempo_acomodacao_s; //Tempo até entrar definitivamente na faixa
+} AvaliadorResposta;
+
+//Inicia o ensaio do relé em torno do setpoint
+void autotune_iniciar(Autotune *autotune, float setpoint, float histerese, float amplitude, RegraSintonia regra);
+
+//Executa um passo do ensaio e retorna o ciclo de trabalho PWM a aplicar
+uint16_t autotune_passo(Autotune *autotune, float temperatura, float intervalo_s);
+
+//Interrompe o ensaio sem produzir ganhos
+void autotune_cancelar(Autotune *autotune);
+
+//Inicia a medição de acomodação e sobressinal para um novo setpoint
+void avaliador_iniciar(AvaliadorResposta *avaliador, float setpoint, float temperatura, float banda, float janela_estavel_s);
+
+//Registra uma amostra da resposta em malha fechada
+void avaliador_passo(AvaliadorResposta *avaliador, float temperatura, float intervalo_s);
+
+#endif // AUTOTUNE_H
@@ -0,0 +1,110 @@
+#include "controlador.h"
+#include "controlador.hpp"
+#include <math.h>
+#include <new>
+#include <type_traits>
+
+//Instâncias expostas ao C, na ordem de TipoControlador (o Controlador do C é a
+//estrutura opaca; o template fica qualificado por controle::)
+using controle::AntiWindup;
+using controle::ControladorP;
+using controle::ControladorPI;
+using controle::ControladorPID;
+using controle::ParametrosControle;
+using controle::Q16;
+
+using VarianteP = ControladorP<float>;
+using VariantePI = ControladorPI<float, AntiWindup::Saturacao>;
+using VariantePICondicional = ControladorPI<float, AntiWindup::Condicional>;
+using VariantePIRetroCalculo = ControladorPI<float, AntiWindup::RetroCalculo>;
+using VariantePID = ControladorPID<float, AntiWindup::Saturacao>;
+using VariantePIDAlimentacao = controle::Controlador<float, controle::TERMO_P | controle::TERMO_I | controle::TERMO_D |
+                                                               controle::TERMO_FILTRO | controle::TERMO_ALIMENTACAO>;
+using VariantePIFixo = ControladorPI<Q16, AntiWindup::Saturacao>;
+using VariantePIDFixo = ControladorPID<Q16, AntiWindup::Saturacao>;
+
+static_assert(sizeof(VariantePIDAlimentacao) <= sizeof(Controlador::estado), "Aumente CONTROLADOR_PALAVRAS");
+static_assert(sizeof(VariantePIDFixo) <= sizeof(Controlador::estado), "Aumente CONTROLADOR_PALAVRAS");
+static_assert(sizeof(VarianteP) == 2 * sizeof(float), "Termos desligados não devem ocupar espaço");
+
+//Chama a função com a instância do tipo guardado
+template <typename F>
+static auto visitar(Controlador *controlador, F &&funcao) {
+    void *estado = controlador->estado;
+    switch (controlador->tipo) {
+    case CONTROLADOR_PI: return funcao(*static_cast<VariantePI *>(estado));
+    case CONTROLADOR_PI_CONDICIONAL: return funcao(*static_cast<VariantePICondicional *>(estado));
+    case CONTROLADOR_PI_RETROCALCULO: return funcao(*static_cast<VariantePIRetroCalculo *>(estado));
+    case CONTROLADOR_PID: return funcao(*static_cast<VariantePID *>(estado));
+    case CONTROLADOR_PID_ALIMENTACAO: return funcao(*static_cast<VariantePIDAlimentacao *>(estado));
+    case CONTROLADOR_PI_FIXO: return funcao(*static_cast<VariantePIFixo *>(estado));
+    case CONTROLADOR_PID_FIXO: return funcao(*static_cast<VariantePIDFixo *>(estado));
+    default: return funcao(*static_cast<VarianteP *>(estado));
+    }
+}
+
+template <typename V>
+static void construir(Controlador *controlador, const ParametrosControle &parametros, float intervalo_s) {
+    V *instancia = new (controlador->estado) V();
+    instancia->configurar(parametros, intervalo_s);
+}
+
+// Configura a variante
+bool controlador_configurar(Controlador *controlador, TipoControlador tipo,
+                            const ParametrosControlador *parametros, float intervalo_s) {
+    if ((unsigned)tipo >= CONTROLADOR_TIPOS || !(intervalo_s > 0.0f) ||
+        !(parametros->saida_max > 0.0f) || !(parametros->filtro_s >= 0.0f) ||
+        !isfinite(parametros->kp) || !isfinite(parametros->ki) || !isfinite(parametros->kd) ||
+        !isfinite(parametros->kff) || !isfinite(parametros->limite_integral) ||
+        !isfinite(parametros->ganho_retrocalculo)) {
+        return false;
+    }
+    const ParametrosControle continuos = {
+        parametros->kp, parametros->ki, parametros->kd, parametros->filtro_s, parametros->kff,
+        parametros->limite_integral, parametros->saida_max, parametros->ganho_retrocalculo,
+    };
+    controlador->tipo = tipo;
+    switch (tipo) {
+    case CONTROLADOR_PI: construir<VariantePI>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PI_CONDICIONAL: construir<VariantePICondicional>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PI_RETROCALCULO: construir<VariantePIRetroCalculo>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PID: construir<VariantePID>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PID_ALIMENTACAO: construir<VariantePIDAlimentacao>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PI_FIXO: construir<VariantePIFixo>(controlador, continuos, intervalo_s); break;
+    case CONTROLADOR_PID_FIXO: construir<VariantePIDFixo>(controlador, continuos, intervalo_s); break;
+    default: construir<VarianteP>(controlador, continuos, intervalo_s); break;
+    }
+    return true;
+}
+
+// Zera o estado
+void controlador_resetar(Controlador *controlador) {
+    visitar(controlador, [](auto &instancia) { instancia.resetar(); });
+}
+
+// Executa um período
+float controlador_passo(Controlador *controlador, float erro, float alimentacao) {
+    return visitar(controlador, [erro, alimentacao](auto &instancia) {
+        using Numero = decltype(instancia.passo(erro));
+        return float(instancia.passo(Numero(erro), Numero(alimentacao)));
+    });
+}
+
+int32_t controlador_passo_fixo(Controlador *controlador, int32_t erro_q16, int32_t alimentacao_q16) {
+    return visitar(controlador, [erro_q16, alimentacao_q16](auto &instancia) {
+        using Numero = decltype(instancia.integral_atual());
+        if constexpr (std::is_same_v<Numero, Q16>) {
+            return instancia.passo(Q16::de_bruto(erro_q16), Q16::de_bruto(alimentacao_q16)).bruto;
+        } else {
+            float escala = 1.0f / float(Q16::UM);
+            return Q16(float(instancia.passo(erro_q16 * escala, alimentacao_q16 * escala))).bruto;
+        }
+    });
+}
+
+const char *controlador_nome(TipoControlador tipo) {
+    static const char *const NOMES[CONTROLADOR_TIPOS] = {
+        "p", "pi", "pi_condicional", "pi_retrocalculo", "pid", "pid_alimentacao", "pi_fixo", "pid_fixo",
+    };
+    return (unsigned)tipo < CONTROLADOR_TIPOS ? NOMES[tipo] : "?";
+}
@@ -0,0 +1,66 @@
+#ifndef CONTROLADOR_H
+#define CONTROLADOR_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//API em C para as variantes de controlador.hpp: cada tipo é uma instância do
+//template compilada com apenas os seus termos; o custo extra é um switch por passo
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef enum {
+    CONTROLADOR_P,
+    CONTROLADOR_PI,              //Integrador limitado a ±limite_integral (como controle_pi)
+    CONTROLADOR_PI_CONDICIONAL,  //Integração condicional
+    CONTROLADOR_PI_RETROCALCULO, //Retrocálculo com ganho_retrocalculo
+    CONTROLADOR_PID,             //Derivada filtrada, integrador limitado
+    CONTROLADOR_PID_ALIMENTACAO, //PID filtrado com feedforward
+    CONTROLADOR_PI_FIXO,         //PI em ponto fixo Q16.16 (sem ponto flutuante no passo)
+    CONTROLADOR_PID_FIXO,        //PID filtrado em Q16.16
+    CONTROLADOR_TIPOS
+} TipoControlador;
+
+//Ganhos em unidades contínuas (ki por segundo, kd em segundos)
+typedef struct {
+    float kp, ki, kd;
+    float filtro_s;           //Constante de tempo do filtro da derivada
+    float kff;                //Ganho do feedforward
+    float limite_integral;
+    float saida_max;          //Limite simétrico da saída
+    float ganho_retrocalculo; //kt do retrocálculo (por segundo)
+} ParametrosControlador;
+
+#define CONTROLADOR_PALAVRAS 12 //Maior variante (PID filtrado em float)
+
+typedef struct {
+    TipoControlador tipo;
+    uint32_t estado[CONTROLADOR_PALAVRAS]; //Instância do template, opaca para o C
+} Controlador;
+
+//Configura a variante para um período fixo e zera o estado; retorna false
+//se o tipo ou os parâmetros forem inválidos
+bool controlador_configurar(Controlador *controlador, TipoControlador tipo,
+                            const ParametrosControlador *parametros, float intervalo_s);
+
+//Zera integrador e derivada mantendo os ganhos
+void controlador_resetar(Controlador *controlador);
+
+//Um período: erro = medida - setpoint; alimentacao só é usada pelas variantes
+//com feedforward. Retorna o sinal limitado a ±saida_max
+float controlador_passo(Controlador *controlador, float erro, float alimentacao);
+
+//O mesmo período com erro, alimentação e retorno em Q16.16 (valor * 65536). As
+//variantes _FIXO não tocam em ponto flutuante, que no RP2040 é emulado; as em
+//float convertem na entrada e na saída
+int32_t controlador_passo_fixo(Controlador *controlador, int32_t erro_q16, int32_t alimentacao_q16);
+
+const char *controlador_nome(TipoControlador tipo);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // CONTROLADOR_H
@@ -0,0 +1,252 @@
+#ifndef CONTROLADOR_HPP
+#define CONTROLADOR_HPP
+
+#include <stdint.h>
+
+//Controladores P, PI e PID montados em tempo de compilação: os termos ativos,
+//o anti-windup e o tipo numérico (float ou ponto fixo) são parâmetros do
+//template, então um termo desligado não ocupa memória nem gera instrução.
+//Os coeficientes são discretizados uma vez em configurar() para o período
+//fixo, e o passo só soma e multiplica.
+//Convenção do projeto: erro = medida - setpoint, saída simétrica em ±saida_max.
+//Para o código em C há uma API com variantes prontas em controlador.h
+
+namespace controle {
+
+//Ponto fixo com sinal em 32 bits (Fracao bits fracionários), produtos em 64
+//bits e saturação em vez de estouro
+template <int Fracao>
+class Fixo {
+public:
+    static_assert(Fracao > 0 && Fracao < 31, "Fracao fora da faixa");
+    static constexpr int64_t UM = int64_t(1) << Fracao;
+
+    constexpr Fixo() : bruto(0) {}
+    constexpr Fixo(float valor) : bruto(converter(valor)) {}
+    //UM é potência de dois: multiplicar pelo inverso é exato e evita a divisão
+    explicit constexpr operator float() const { return float(bruto) * (1.0f / float(UM)); }
+
+    static constexpr Fixo de_bruto(int64_t valor) {
+        Fixo resultado;
+        resultado.bruto = saturar(valor);
+        return resultado;
+    }
+
+    friend constexpr Fixo operator+(Fixo a, Fixo b) { return de_bruto(int64_t(a.bruto) + b.bruto); }
+    friend constexpr Fixo operator-(Fixo a, Fixo b) { return de_bruto(int64_t(a.bruto) - b.bruto); }
+    friend constexpr Fixo operator*(Fixo a, Fixo b) {
+        //Arredonda para o mais próximo, empates para o par: truncar ou arredondar os
+        //empates sempre para cima deixaria um viés que o integrador acumula
+        int64_t produto = int64_t(a.bruto) * b.bruto;
+        int64_t quociente = produto >> Fracao;
+        int64_t resto = produto & (UM - 1);
+        if (resto > (UM >> 1) || (resto == (UM >> 1) && (quociente & 1))) {
+            quociente++;
+        }
+        return de_bruto(quociente);
+    }
+    constexpr Fixo operator-() const { return de_bruto(-int64_t(bruto)); }
+    constexpr Fixo &operator+=(Fixo outro) { return *this = *this + outro; }
+    friend constexpr bool operator<(Fixo a, Fixo b) { return a.bruto < b.bruto; }
+    friend constexpr bool operator>(Fixo a, Fixo b) { return a.bruto > b.bruto; }
+
+    int32_t bruto;
+
+private:
+    static constexpr int32_t saturar(int64_t valor) {
+        return valor > INT32_MAX ? INT32_MAX : (valor < INT32_MIN ? INT32_MIN : int32_t(valor));
+    }
+
+    //Em float (o escalonamento por potência de dois é exato) e saturado antes da
+    //conversão para inteiro, que seria indefinida fora da faixa; NaN vira zero
+    static constexpr int32_t converter(float valor) {
+        float escalado = valor * float(UM);
+        if (!(escalado == escalado)) {
+            return 0;
+        }
+        if (escalado >= 2147483648.0f) {
+            return INT32_MAX;
+        }
+        if (escalado <= -2147483648.0f) {
+            return INT32_MIN;
+        }
+        return saturar(int64_t(escalado + (escalado < 0.0f ? -0.5f : 0.5f)));
+    }
+};
+
+using Q16 = Fixo<16>; //±32768 com resolução de 1/65536: cobre ±4096 do sinal de controle
+
+//Termos selecionáveis
+enum Termos : unsigned {
+    TERMO_P           = 1u << 0,
+    TERMO_I           = 1u << 1,
+    TERMO_D           = 1u << 2, //Derivada do erro
+    TERMO_FILTRO      = 1u << 3, //Filtro de primeira ordem na derivada (requer TERMO_D)
+    TERMO_ALIMENTACAO = 1u << 4, //Feedforward: kff vezes o sinal informado a cada passo
+};
+
+//Tratamento do integrador quando a saída satura
+enum class AntiWindup {
+    Nenhum,       //Integra sempre
+    Saturacao,    //Limita o integrador a ±limite_integral (como controle_pi)
+    Condicional,  //Não integra enquanto a saída estiver saturada no sentido do erro
+    RetroCalculo, //Descarrega o integrador pelo excesso da saída, com ganho kt
+};
+
+//Parâmetros em unidades contínuas; convertidos para o tipo numérico em configurar()
+struct ParametrosControle {
+    float kp, ki, kd;
+    float filtro_s;          //Constante de tempo do filtro da derivada
+    float kff;
+    float limite_integral;
+    float saida_max;
+    float ganho_retrocalculo; //kt (por segundo)
+};
+
+template <typename N>
+constexpr N limitar(N valor, N minimo, N maximo) {
+    return valor < minimo ? minimo : (valor > maximo ? maximo : valor);
+}
+
+//Estado e coeficientes de cada termo; a especialização desligada é vazia e,
+//como base, não ocupa espaço
+template <typename N, bool Ativo>
+struct TermoProporcional { N kp; };
+template <typename N>
+struct TermoProporcional<N, false> {};
+
+template <typename N, bool Ativo>
+struct TermoIntegral { N ki_dt, limite_integral, kt_dt, integral; };
+template <typename N>
+struct TermoIntegral<N, false> {};
+
+template <typename N, bool Ativo, bool Filtrado>
+struct TermoDerivativo { N kd_dt, erro_anterior; };
+template <typename N>
+struct TermoDerivativo<N, true, true> { N kd_dt, alfa, erro_anterior, derivada; };
+template <typename N, bool Filtrado>
+struct TermoDerivativo<N, false, Filtrado> {};
+
+template <typename N, bool Ativo>
+struct TermoAlimentacao { N kff; };
+template <typename N>
+struct TermoAlimentacao<N, false> {};
+
+template <typename N, unsigned T, AntiWindup W = AntiWindup::Saturacao>
+class Controlador : TermoProporcional<N, (T & TERMO_P) != 0>,
+                    TermoIntegral<N, (T & TERMO_I) != 0>,
+                    TermoDerivativo<N, (T & TERMO_D) != 0, (T & TERMO_FILTRO) != 0>,
+                    TermoAlimentacao<N, (T & TERMO_ALIMENTACAO) != 0> {
+public:
+    static constexpr bool P = (T & TERMO_P) != 0;
+    static constexpr bool I = (T & TERMO_I) != 0;
+    static constexpr bool D = (T & TERMO_D) != 0;
+    static constexpr bool FILTRO = (T & TERMO_FILTRO) != 0;
+    static constexpr bool ALIMENTACAO = (T & TERMO_ALIMENTACAO) != 0;
+    static_assert(P || I || D, "Controlador sem termos");
+    static_assert(!FILTRO || D, "TERMO_FILTRO requer TERMO_D");
+
+    //Discretiza os ganhos para o período e zera o estado
+    void configurar(const ParametrosControle &parametros, float intervalo_s) {
+        saida_max = N(parametros.saida_max);
+        if constexpr (P) {
+            this->kp = N(parametros.kp);
+        }
+        if constexpr (I) {
+            this->ki_dt = N(parametros.ki * intervalo_s);
+            this->limite_integral = N(parametros.limite_integral);
+            this->kt_dt = N(parametros.ganho_retrocalculo * intervalo_s);
+        }
+        if constexpr (D && FILTRO) {
+            //Euler implícito: D[k] = alfa D[k-1] + (1 - alfa) kd Δe / dt
+            float alfa = parametros.filtro_s / (parametros.filtro_s + intervalo_s);
+            this->alfa = N(alfa);
+            this->kd_dt = N((1.0f - alfa) * parametros.kd / intervalo_s);
+        } else if constexpr (D) {
+            this->kd_dt = N(parametros.kd / intervalo_s);
+        }
+        if constexpr (ALIMENTACAO) {
+            this->kff = N(parametros.kff);
+        }
+        resetar();
+    }
+
+    void resetar() {
+        if constexpr (I) {
+            this->integral = N();
+        }
+        if constexpr (D) {
+            this->erro_anterior = N();
+        }
+        if constexpr (D && FILTRO) {
+            this->derivada = N();
+        }
+    }
+
+    //Um período: retorna o sinal de controle limitado a ±saida_max
+    N passo(N erro, N alimentacao = N()) {
+        N saida = N();
+        if constexpr (P) {
+            saida = this->kp * erro;
+        }
+        if constexpr (D) {
+            N variacao = erro - this->erro_anterior;
+            this->erro_anterior = erro;
+            if constexpr (FILTRO) {
+                this->derivada = this->alfa * this->derivada + this->kd_dt * variacao;
+                saida += this->derivada;
+            } else {
+                saida += this->kd_dt * variacao;
+            }
+        }
+        if constexpr (ALIMENTACAO) {
+            saida += this->kff * alimentacao;
+        }
+        if constexpr (I) {
+            N incremento = this->ki_dt * erro;
+            if constexpr (W == AntiWindup::RetroCalculo) {
+                N bruta = saida + this->integral;
+                N limitada = limitar(bruta, -saida_max, saida_max);
+                this->integral += incremento + this->kt_dt * (limitada - bruta);
+                return limitada;
+            } else if constexpr (W == AntiWindup::Condicional) {
+                N tentativa = this->integral + incremento;
+                N bruta = saida + tentativa;
+                bool satura_acima = saida_max < bruta && N() < incremento;
+                bool satura_abaixo = bruta < -saida_max && incremento < N();
+                if (!satura_acima && !satura_abaixo) {
+                    this->integral = tentativa;
+                }
+            } else if constexpr (W == AntiWindup::Saturacao) {
+                this->integral = limitar(this->integral + incremento, -this->limite_integral, this->limite_integral);
+            } else {
+                this->integral += incremento;
+            }
+            saida += this->integral;
+        }
+        return limitar(saida, -saida_max, saida_max);
+    }
+
+    N integral_atual() const {
+        if constexpr (I) {
+            return this->integral;
+        } else {
+            return N();
+        }
+    }
+
+private:
+    N saida_max;
+};
+
+//Combinações usuais
+template <typename N = float>
+using ControladorP = Controlador<N, TERMO_P>;
+template <typename N = float, AntiWindup W = AntiWindup::Saturacao>
+using ControladorPI = Controlador<N, TERMO_P | TERMO_I, W>;
+template <typename N = float, AntiWindup W = AntiWindup::Saturacao>
+using ControladorPID = Controlador<N, TERMO_P | TERMO_I | TERMO_D | TERMO_FILTRO, W>;
+
+} // namespace controle
+
+#endif // CONTROLADOR_HPP
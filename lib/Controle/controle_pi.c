@@ -0,0 +1,27 @@
+#include "controle_pi.h"
+
+// Configura os ganhos e zera o termo integral
+void controle_pi_inicializar(ControladorPI *controlador, float kp, float ki, float limite_integral) {
+    controlador->kp = kp;
+    controlador->ki = ki;
+    controlador->limite_integral = limite_integral;
+    controlador->integral = 0.0f;
+}
+
+// Zera o termo integral
+void controle_pi_resetar(ControladorPI *controlador) {
+    controlador->integral = 0.0f;
+}
+
+// Converte o sinal de controle simétrico para ciclo de trabalho PWM
+uint16_t controle_pi_sinal_para_pwm(float sinal_controle) {
+    int32_t ciclo = (int32_t)((sinal_controle + CONTROLE_PI_SAIDA_MAX) * (CONTROLE_PI_PWM_MAX / (2.0f * CONTROLE_PI_SAIDA_MAX)));
+    return (uint16_t)(ciclo < 0 ? 0 : (ciclo > CONTROLE_PI_PWM_MAX ? CONTROLE_PI_PWM_MAX : ciclo));
+}
+
+// Executa um passo do controlador PI
+uint16_t controle_pi_passo(ControladorPI *controlador, float erro, float intervalo_s) {
+    float sinal_controle = controle_pi_calcular(&controlador->integral, controlador->kp, controlador->ki,
+                                                controlador->limite_integral, erro, intervalo_s);
+    return controle_pi_sinal_para_pwm(sinal_controle);
+}
@@ -0,0 +1,39 @@
+#ifndef CONTROLE_PI_H
+#define CONTROLE_PI_H
+
+#include <stdint.h>
+#include <math.h>
+
+//Faixa simétrica do sinal de controle antes da conversão para PWM
+#define CONTROLE_PI_SAIDA_MAX  4096.0f
+#define CONTROLE_PI_PWM_MAX    65535
+
+//Estado e parâmetros de um controlador PI
+typedef struct {
+    float kp;              //Ganho proporcional
+    float ki;              //Ganho integral (por segundo)
+    float limite_integral; //Limite simétrico do termo integral
+    float integral;        //Termo integral acumulado
+} ControladorPI;
+
+//Configura os ganhos e zera o termo integral
+void controle_pi_inicializar(ControladorPI *controlador, float kp, float ki, float limite_integral);
+
+//Zera o termo integral (usado ao desligar o sistema)
+void controle_pi_resetar(ControladorPI *controlador);
+
+//Executa um passo do controlador e retorna o ciclo de trabalho PWM (0 a 65535)
+//O erro segue a convenção do projeto: temperatura medida menos setpoint
+uint16_t controle_pi_passo(ControladorPI *controlador, float erro, float intervalo_s);
+
+//Converte um sinal de controle (-4096 a 4096) para ciclo de trabalho PWM
+uint16_t controle_pi_sinal_para_pwm(float sinal_controle);
+
+//Núcleo do PI sobre variáveis soltas, para quem guarda o estado em vetores (ex.: tabela de zonas)
+static inline float controle_pi_calcular(float *integral, float kp, float ki, float limite_integral, float erro, float intervalo_s) {
+    *integral += ki * erro * intervalo_s;
+    *integral = fmaxf(fminf(*integral, limite_integral), -limite_integral); //Limita o termo integral
+    return kp * erro + *integral;
+}
+
+#endif // CONTROLE_PI_H
@@ -0,0 +1,80 @@
+#include "passo_controle.h"
+#include <math.h>
+#include "controle_pi.h"
+
+// Liga o sistema com o ensaio do relé
+void passo_controle_iniciar_autotune(ControlePrincipal *controle) {
+    autotune_iniciar(&controle->autotune, (float)controle->setpoint_temperatura, AUTOTUNE_HISTERESE,
+                     CONTROLE_PI_SAIDA_MAX, REGRA_ZIEGLER_NICHOLS);
+    controle->autotune_ativo = true;
+    controle->modo_selecao = false;
+    controle->sistema_ligado = true;
+}
+
+static NivelAlarme nivel_alarme(const ControlePrincipal *controle, const TabelaZonas *zonas, int zona) {
+    if (!controle->sistema_ligado || controle->modo_selecao || !zonas->leitura_recebida[zona]) {
+        return ALARME_NENHUM;
+    }
+    float erro = fabsf(controle->temperatura_ambiente - (float)controle->setpoint_temperatura);
+    return erro > 9.6f ? ALARME_CRITICO : (erro >= 3.6f ? ALARME_MODERADO : ALARME_LEVE);
+}
+
+// Executa um período de controle
+uint32_t passo_controle_executar(ControlePrincipal *controle, TabelaZonas *zonas, int zona, float intervalo_s) {
+    uint32_t eventos = 0;
+
+    //Sincroniza a zona principal com o estado da interface local
+    zonas->setpoint[zona] = (float)controle->setpoint_temperatura;
+    zonas->kp[zona] = controle->ganho_kp;
+    zonas->ki[zona] = controle->ganho_ki;
+    zonas->ligada[zona] = controle->sistema_ligado;
+    zonas->saida_externa[zona] = controle->sistema_ligado && controle->autotune_ativo;
+
+    if (controle->sistema_ligado && controle->autotune_ativo) {
+        //Ensaio do relé: a saída comuta entre os extremos em torno do setpoint
+        zonas->ciclo_pwm[zona] = autotune_passo(&controle->autotune, controle->temperatura_ambiente, intervalo_s);
+        if (controle->autotune.estado == AUTOTUNE_CONCLUIDO) {
+            //Aplica os novos ganhos imediatamente e passa a medir a resposta
+            controle->ganho_kp = controle->autotune.kp;
+            controle->ganho_ki = controle->autotune.ki;
+            zonas->integral[zona] = 0.0f;
+            avaliador_iniciar(&controle->avaliador, (float)controle->setpoint_temperatura,
+                              controle->temperatura_ambiente, AUTOTUNE_BANDA, AUTOTUNE_JANELA_S);
+            controle->autotune_ativo = false;
+            eventos |= PASSO_AUTOTUNE_CONCLUIDO;
+        } else if (controle->autotune.estado == AUTOTUNE_FALHOU) {
+            //Mantém os ganhos anteriores se não houve oscilação sustentada
+            controle->autotune_ativo = false;
+            eventos |= PASSO_AUTOTUNE_FALHOU;
+        }
+    } else if (controle->sistema_ligado && !controle->ligado_anterior) {
+        //Mede acomodação e sobressinal desde o instante em que o controle foi ligado
+        avaliador_iniciar(&controle->avaliador, (float)controle->setpoint_temperatura,
+                          controle->temperatura_ambiente, AUTOTUNE_BANDA, AUTOTUNE_JANELA_S);
+    } else if (!controle->sistema_ligado && controle->autotune_ativo) {
+        autotune_cancelar(&controle->autotune);
+        controle->autotune_ativo = false;
+    }
+
+    //Passo do PI de todas as zonas
+    zonas_executar_passo(zonas, intervalo_s);
+
+    if (controle->sistema_ligado && !controle->autotune_ativo) {
+        bool acomodado = controle->avaliador.concluido;
+        avaliador_passo(&controle->avaliador, controle->temperatura_ambiente, intervalo_s);
+        if (!acomodado && controle->avaliador.concluido) {
+            eventos |= PASSO_ACOMODOU;
+        }
+    }
+
+    //Alerta sonoro acompanha o erro calculado neste passo
+    NivelAlarme nivel = nivel_alarme(controle, zonas, zona);
+    if (nivel != controle->alarme) {
+        controle->alarme = nivel;
+        eventos |= PASSO_ALARME_MUDOU;
+    }
+
+    //O avaliador só parte com uma temperatura real em mãos
+    controle->ligado_anterior = controle->sistema_ligado && zonas->leitura_recebida[zona];
+    return eventos;
+}
@@ -0,0 +1,54 @@
+#ifndef PASSO_CONTROLE_H
+#define PASSO_CONTROLE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "autotune.h"
+#include "lib/Zonas/zonas.h"
+
+//Decisões de um período de controle da zona principal (autossintonia,
+//avaliação da resposta, PI de todas as zonas e nível do alarme) sem acesso
+//ao hardware: o firmware chama a cada período e a reprodução de rastros
+//chama com as entradas gravadas, executando exatamente o mesmo código
+
+#define AUTOTUNE_HISTERESE 0.5f  //Banda morta do relé (°C), acima da resolução do DHT11
+#define AUTOTUNE_BANDA     0.5f  //Faixa de acomodação para avaliar os novos ganhos (°C)
+#define AUTOTUNE_JANELA_S  60.0f //Tempo na faixa para considerar acomodado
+
+//Alertas sonoros por faixa de erro
+typedef enum {
+    ALARME_NENHUM,
+    ALARME_LEVE,     //Erro abaixo de 3,6 °C
+    ALARME_MODERADO, //Erro entre 3,6 e 9,6 °C
+    ALARME_CRITICO   //Erro acima de 9,6 °C
+} NivelAlarme;
+
+//Estado da zona principal: comandos da interface local e da web e o que o passo mantém
+typedef struct {
+    float temperatura_ambiente; //Última leitura válida da zona principal
+    int setpoint_temperatura;   //Temperatura desejada (setpoint)
+    bool modo_selecao;          //Indica se está ajustando o setpoint
+    bool sistema_ligado;        //Indica se o sistema de controle está ativo
+    bool autotune_ativo;        //Indica se o ensaio do relé está em andamento
+    float ganho_kp;             //Ganho proporcional em uso
+    float ganho_ki;             //Ganho integral em uso
+    Autotune autotune;          //Estado e resultados da autossintonia
+    AvaliadorResposta avaliador; //Acomodação e sobressinal com os ganhos atuais
+    bool ligado_anterior;       //Ligado com leitura real no passo anterior (partida do avaliador)
+    NivelAlarme alarme;
+} ControlePrincipal;
+
+//Eventos devolvidos pelo passo, para mensagens e atuadores fora da biblioteca
+#define PASSO_AUTOTUNE_CONCLUIDO (1u << 0)
+#define PASSO_AUTOTUNE_FALHOU    (1u << 1)
+#define PASSO_ACOMODOU           (1u << 2)
+#define PASSO_ALARME_MUDOU       (1u << 3)
+
+//Liga o sistema executando o ensaio do relé em torno do setpoint atual
+void passo_controle_iniciar_autotune(ControlePrincipal *controle);
+
+//Executa um período: sincroniza a zona principal, decide a saída e atualiza o alarme.
+//Retorna os eventos PASSO_* ocorridos
+uint32_t passo_controle_executar(ControlePrincipal *controle, TabelaZonas *zonas, int zona, float intervalo_s);
+
+#endif // PASSO_CONTROLE_H
@@ -0,0 +1,159 @@
+#include "grafico_tendencia.h"
+#include <string.h>
+
+#define LIMITE_CENTESIMOS 30000 //±300 °C: mantém a escala arredondada dentro do int16
+
+static int16_t para_centesimos(float temperatura) {
+    float centesimos = temperatura * 100.0f;
+    if (centesimos > LIMITE_CENTESIMOS) return LIMITE_CENTESIMOS;
+    if (centesimos < -LIMITE_CENTESIMOS) return -LIMITE_CENTESIMOS;
+    return (int16_t)(centesimos >= 0.0f ? centesimos + 0.5f : centesimos - 0.5f);
+}
+
+static int16_t grau_abaixo(int16_t centesimos) {
+    return centesimos >= 0 ? (centesimos / 100) * 100 : -(((-centesimos + 99) / 100) * 100);
+}
+
+static int16_t grau_acima(int16_t centesimos) {
+    return -grau_abaixo(-centesimos);
+}
+
+//Amostra pela idade: 0 é a mais recente
+static int16_t amostra(const GraficoTendencia *grafico, uint8_t idade) {
+    return grafico->amostras[(grafico->posicao + GRAFICO_TENDENCIA_LARGURA - 1 - idade) % GRAFICO_TENDENCIA_LARGURA];
+}
+
+//Varre a janela inteira; só roda quando um extremo sai do anel
+static void recalcular_extremos(GraficoTendencia *grafico) {
+    grafico->minimo = grafico->maximo = grafico->amostras[0];
+    for (uint8_t i = 1; i < grafico->quantidade; i++) {
+        if (grafico->amostras[i] < grafico->minimo) grafico->minimo = grafico->amostras[i];
+        if (grafico->amostras[i] > grafico->maximo) grafico->maximo = grafico->amostras[i];
+    }
+}
+
+//A escala anda em graus inteiros, então oscilações dentro do mesmo grau não causam redesenho
+static void atualizar_escala(GraficoTendencia *grafico) {
+    int16_t minima = grau_abaixo(grafico->minimo);
+    int16_t maxima = grau_acima(grafico->maximo);
+    if (maxima - minima < GRAFICO_TENDENCIA_FAIXA_MIN) {
+        maxima = minima + GRAFICO_TENDENCIA_FAIXA_MIN;
+    }
+    if (minima != grafico->escala_minima || maxima != grafico->escala_maxima) {
+        grafico->escala_minima = minima;
+        grafico->escala_maxima = maxima;
+        grafico->redesenhar = true;
+    }
+}
+
+void grafico_tendencia_inicializar(GraficoTendencia *grafico, uint8_t pagina_inicial) {
+    memset(grafico, 0, sizeof(*grafico));
+    grafico->pagina_inicial = pagina_inicial;
+    grafico->escala_maxima = GRAFICO_TENDENCIA_FAIXA_MIN;
+    grafico->redesenhar = true;
+}
+
+void grafico_tendencia_adicionar(GraficoTendencia *grafico, float temperatura) {
+    int16_t valor = para_centesimos(temperatura);
+    bool cheio = grafico->quantidade == GRAFICO_TENDENCIA_LARGURA;
+    int16_t removido = grafico->amostras[grafico->posicao];
+
+    grafico->amostras[grafico->posicao] = valor;
+    grafico->posicao = (grafico->posicao + 1) % GRAFICO_TENDENCIA_LARGURA;
+    if (!cheio) {
+        grafico->quantidade++;
+    }
+    if (grafico->pendentes < GRAFICO_TENDENCIA_LARGURA) {
+        grafico->pendentes++;
+    }
+
+    if (grafico->quantidade == 1) {
+        grafico->minimo = grafico->maximo = valor;
+    } else if (cheio && (removido == grafico->minimo || removido == grafico->maximo)) {
+        recalcular_extremos(grafico);
+    } else {
+        if (valor < grafico->minimo) grafico->minimo = valor;
+        if (valor > grafico->maximo) grafico->maximo = valor;
+    }
+    atualizar_escala(grafico);
+}
+
+void grafico_tendencia_invalidar(GraficoTendencia *grafico) {
+    grafico->redesenhar = true;
+}
+
+static uint8_t linha_do_valor(const GraficoTendencia *grafico, int16_t valor, uint8_t topo, uint8_t altura) {
+    int32_t faixa = grafico->escala_maxima - grafico->escala_minima;
+    int32_t deslocamento = ((int32_t)(valor - grafico->escala_minima) * (altura - 1) + faixa / 2) / faixa;
+    return (uint8_t)(topo + altura - 1 - deslocamento);
+}
+
+//Escreve a coluna x inteira de uma vez: um segmento vertical de linha_a a linha_b
+static void desenhar_coluna(const GraficoTendencia *grafico, ssd1306_t *ssd, uint8_t x,
+                            uint8_t linha_a, uint8_t linha_b) {
+    uint8_t de = linha_a < linha_b ? linha_a : linha_b;
+    uint8_t ate = linha_a < linha_b ? linha_b : linha_a;
+    for (uint8_t pagina = grafico->pagina_inicial; pagina < ssd->pages; pagina++) {
+        uint8_t primeira = pagina * 8, ultima = primeira + 7;
+        uint8_t mascara = 0;
+        if (de <= ultima && ate >= primeira) {
+            uint8_t inicio = de > primeira ? de - primeira : 0;
+            uint8_t fim = ate < ultima ? ate - primeira : 7;
+            mascara = (uint8_t)((0xFFu >> (7 - fim)) & (0xFFu << inicio));
+        }
+        ssd->ram_buffer[1 + pagina * ssd->width + x] = mascara;
+    }
+}
+
+//Coluna de uma amostra, ligada à anterior para a curva não ficar pontilhada
+static void desenhar_amostra(const GraficoTendencia *grafico, ssd1306_t *ssd, uint8_t largura,
+                             uint8_t idade, uint8_t topo, uint8_t altura) {
+    uint8_t linha = linha_do_valor(grafico, amostra(grafico, idade), topo, altura);
+    uint8_t linha_anterior = linha;
+    if (idade + 1 < grafico->quantidade) {
+        linha_anterior = linha_do_valor(grafico, amostra(grafico, idade + 1), topo, altura);
+    }
+    desenhar_coluna(grafico, ssd, largura - 1 - idade, linha_anterior, linha);
+}
+
+bool grafico_tendencia_desenhar(GraficoTendencia *grafico, ssd1306_t *ssd) {
+    if (!grafico->redesenhar && grafico->pendentes == 0) {
+        return false;
+    }
+    if (grafico->pagina_inicial >= ssd->pages) {
+        return false;
+    }
+
+    uint8_t largura = ssd->width < GRAFICO_TENDENCIA_LARGURA ? ssd->width : GRAFICO_TENDENCIA_LARGURA;
+    uint8_t topo = grafico->pagina_inicial * 8;
+    uint8_t altura = ssd->height - topo;
+    uint8_t novas = grafico->pendentes;
+
+    if (grafico->redesenhar || novas >= largura) {
+        //Desenho completo: limpa a região e refaz uma coluna por amostra
+        for (uint8_t pagina = grafico->pagina_inicial; pagina < ssd->pages; pagina++) {
+            memset(&ssd->ram_buffer[1 + pagina * ssd->width], 0, largura);
+        }
+        uint8_t visiveis = grafico->quantidade < largura ? grafico->quantidade : largura;
+        for (uint8_t idade = 0; idade < visiveis; idade++) {
+            desenhar_amostra(grafico, ssd, largura, idade, topo, altura);
+        }
+    } else {
+        //Rolagem: cada página anda 'novas' bytes para a esquerda e só as colunas novas são desenhadas
+        for (uint8_t pagina = grafico->pagina_inicial; pagina < ssd->pages; pagina++) {
+            uint8_t *linha = &ssd->ram_buffer[1 + pagina * ssd->width];
+            memmove(linha, linha + novas, largura - novas);
+        }
+        for (uint8_t idade = 0; idade < novas; idade++) {
+            desenhar_amostra(grafico, ssd, largura, idade, topo, altura);
+        }
+        //Com a janela cheia a coluna da esquerda ainda liga à amostra que saiu; refaz só ela
+        if (grafico->quantidade >= largura) {
+            desenhar_amostra(grafico, ssd, largura, largura - 1, topo, altura);
+        }
+    }
+
+    grafico->pendentes = 0;
+    grafico->redesenhar = false;
+    return true;
+}
@@ -0,0 +1,42 @@
+#ifndef GRAFICO_TENDENCIA_H
+#define GRAFICO_TENDENCIA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "ssd1306.h"
+
+//Gráfico de tendência de temperatura que rola uma coluna por amostra.
+//Ocupa as páginas de pagina_inicial até o fim do display, na largura toda.
+//A cada amostra as páginas do gráfico andam um byte para a esquerda e só a
+//coluna nova é desenhada; o desenho completo só acontece quando a escala
+//(graus inteiros em volta do mínimo e máximo da janela) muda ou quando outra
+//tela sobrescreveu o framebuffer
+
+#define GRAFICO_TENDENCIA_LARGURA   128 //Amostras na janela (uma por coluna)
+#define GRAFICO_TENDENCIA_FAIXA_MIN 200 //Faixa mínima da escala, em centésimos de grau
+
+typedef struct {
+    int16_t amostras[GRAFICO_TENDENCIA_LARGURA]; //Anel em centésimos de grau
+    uint8_t posicao;          //Próxima posição de escrita no anel
+    uint8_t quantidade;       //Amostras válidas no anel
+    uint8_t pendentes;        //Amostras ainda não desenhadas
+    uint8_t pagina_inicial;   //Primeira página do display ocupada pelo gráfico
+    int16_t minimo, maximo;   //Extremos da janela
+    int16_t escala_minima;    //Limites do eixo vertical, múltiplos de 100
+    int16_t escala_maxima;
+    bool redesenhar;          //Framebuffer precisa do gráfico inteiro
+} GraficoTendencia;
+
+//Prepara um gráfico vazio a partir da página indicada
+void grafico_tendencia_inicializar(GraficoTendencia *grafico, uint8_t pagina_inicial);
+
+//Acrescenta uma amostra (°C); não toca no framebuffer
+void grafico_tendencia_adicionar(GraficoTendencia *grafico, float temperatura);
+
+//Força o desenho completo na próxima chamada (ex.: outra tela usou o framebuffer)
+void grafico_tendencia_invalidar(GraficoTendencia *grafico);
+
+//Atualiza a região do gráfico no framebuffer; retorna true se algo mudou
+bool grafico_tendencia_desenhar(GraficoTendencia *grafico, ssd1306_t *ssd);
+
+#endif // GRAFICO_TENDENCIA_H
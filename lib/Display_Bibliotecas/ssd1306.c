@@ -1,24 +1,32 @@
 #include "ssd1306.h"
 #include "font.h"
 #include <stdlib.h>
+#include <string.h>
 #include <math.h>
 #include "hardware/i2c.h"
 
 // Inicializa a estrutura do display SSD1306
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+    // Aloca buffer de dados
+    uint8_t *buffer = calloc(SSD1306_TAMANHO_BUFFER(width, height), sizeof(uint8_t));
+    if (buffer == NULL) {
+        // Em caso de falha, poderia adicionar tratamento de erro (ex.: log ou loop infinito)
+        while (1);
+    }
+    ssd1306_init_buffer(ssd, width, height, external_vcc, address, i2c, buffer);
+}
+
+// Inicializa a estrutura do display usando um framebuffer alocado pelo chamador
+void ssd1306_init_buffer(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c, uint8_t *buffer) {
     ssd->width = width;
     ssd->height = height;
     ssd->pages = height / 8;
     ssd->address = address;
     ssd->i2c_port = i2c;
     ssd->bufsize = ssd->pages * ssd->width + 1;
-    
-    // Aloca buffer de dados
-    ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-    if (ssd->ram_buffer == NULL) {
-        // Em caso de falha, poderia adicionar tratamento de erro (ex.: log ou loop infinito)
-        while (1);
-    }
+    ssd->ram_buffer = buffer;
+    ssd->transporte = NULL;
+    ssd->contexto_transporte = NULL;
     
     // Inicializa buffers
     ssd->ram_buffer[0] = 0x40; // Prefixo de dados
@@ -27,48 +35,92 @@ void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_v
 
 // Configura os parâmetros iniciais do display
 void ssd1306_config(ssd1306_t *ssd) {
-    ssd1306_command(ssd, 0xAE); // Desliga o display
-    ssd1306_command(ssd, 0x20); // Define modo de memória
-    ssd1306_command(ssd, 0x00); // Endereçamento horizontal
-    ssd1306_command(ssd, 0x40); // Linha inicial
-    ssd1306_command(ssd, 0xA1); // Remapeia segmentos
-    ssd1306_command(ssd, 0xA8); // Define razão de multiplexação
-    ssd1306_command(ssd, ssd->height - 1);
-    ssd1306_command(ssd, 0xC8); // Define direção de varredura COM
-    ssd1306_command(ssd, 0xD3); // Define deslocamento do display
-    ssd1306_command(ssd, 0x00);
-    ssd1306_command(ssd, 0xDA); // Configura pinos COM
-    ssd1306_command(ssd, 0x12);
-    ssd1306_command(ssd, 0xD5); // Define divisor de clock
-    ssd1306_command(ssd, 0x80);
-    ssd1306_command(ssd, 0xD9); // Define período de pré-carga
-    ssd1306_command(ssd, 0xF1);
-    ssd1306_command(ssd, 0xDB); // Define nível VCOMH
-    ssd1306_command(ssd, 0x30);
-    ssd1306_command(ssd, 0x81); // Define contraste
-    ssd1306_command(ssd, 0xFF);
-    ssd1306_command(ssd, 0xA4); // Exibe conteúdo do buffer
-    ssd1306_command(ssd, 0xA6); // Modo normal (não invertido)
-    ssd1306_command(ssd, 0x8D); // Habilita charge pump
-    ssd1306_command(ssd, 0x14);
-    ssd1306_command(ssd, 0xAF); // Liga o display
+    const uint8_t comandos[] = {
+        0xAE,                   // Desliga o display
+        0x20, 0x00,             // Modo de memória: endereçamento horizontal
+        0x40,                   // Linha inicial
+        0xA1,                   // Remapeia segmentos
+        0xA8, ssd->height - 1,  // Razão de multiplexação
+        0xC8,                   // Direção de varredura COM
+        0xD3, 0x00,             // Deslocamento do display
+        0xDA, 0x12,             // Configura pinos COM
+        0xD5, 0x80,             // Divisor de clock
+        0xD9, 0xF1,             // Período de pré-carga
+        0xDB, 0x30,             // Nível VCOMH
+        0x81, 0xFF,             // Contraste
+        0xA4,                   // Exibe conteúdo do buffer
+        0xA6,                   // Modo normal (não invertido)
+        0x8D, 0x14,             // Habilita charge pump
+        0xAF,                   // Liga o display
+    };
+    ssd1306_command_list(ssd, comandos, sizeof(comandos));
+}
+
+// Uma transação: cabeçalho e, se houver, dados logo em seguida
+static void ssd1306_transmit(ssd1306_t *ssd, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                             const uint8_t *dados, size_t tamanho_dados) {
+    if (ssd->transporte) {
+        ssd->transporte(ssd->contexto_transporte, cabecalho, tamanho_cabecalho, dados, tamanho_dados);
+    } else if (tamanho_dados) {
+        // Burst: sem STOP nem novo endereço entre o cabeçalho e os dados
+        i2c_write_burst_blocking(ssd->i2c_port, ssd->address, cabecalho, tamanho_cabecalho);
+        i2c_write_blocking(ssd->i2c_port, ssd->address, dados, tamanho_dados, false);
+    } else {
+        i2c_write_blocking(ssd->i2c_port, ssd->address, cabecalho, tamanho_cabecalho, false);
+    }
+}
+
+void ssd1306_set_transporte(ssd1306_t *ssd, ssd1306_transporte_t transporte, void *contexto) {
+    ssd->transporte = transporte;
+    ssd->contexto_transporte = contexto;
 }
 
 // Envia um comando para o display via I2C
 void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
     ssd->port_buffer[1] = command;
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->port_buffer, 2, false);
+    ssd1306_transmit(ssd, ssd->port_buffer, 2, NULL, 0);
+}
+
+// Envia uma lista de comandos: um byte de controle Co=0, D/C=0 e os comandos em sequência
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t count) {
+    uint8_t transacao[SSD1306_COMANDOS_POR_TRANSACAO + 1];
+    transacao[0] = 0x00;
+    while (count > 0) {
+        size_t parte = count < SSD1306_COMANDOS_POR_TRANSACAO ? count : SSD1306_COMANDOS_POR_TRANSACAO;
+        memcpy(&transacao[1], commands, parte);
+        ssd1306_transmit(ssd, transacao, parte + 1, NULL, 0);
+        commands += parte;
+        count -= parte;
+    }
+}
+
+// Janela de escrita seguida dos dados na mesma transação: cada comando leva um byte de
+// controle Co=1 (outro controle vem depois) e o prefixo 0x40 do buffer encerra com dados
+static void ssd1306_send_window(ssd1306_t *ssd, uint8_t primeira, uint8_t ultima, const uint8_t *dados, size_t tamanho) {
+    const uint8_t cabecalho[] = {
+        0x80, 0x21, 0x80, 0, 0x80, ssd->width - 1, // Endereço de coluna
+        0x80, 0x22, 0x80, primeira, 0x80, ultima,  // Endereço de página
+    };
+    ssd1306_transmit(ssd, cabecalho, sizeof(cabecalho), dados, tamanho);
 }
 
 // Envia o buffer de dados para o display
 void ssd1306_send_data(ssd1306_t *ssd) {
-    ssd1306_command(ssd, 0x21); // Define endereço de coluna
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->width - 1);
-    ssd1306_command(ssd, 0x22); // Define endereço de página
-    ssd1306_command(ssd, 0);
-    ssd1306_command(ssd, ssd->pages - 1);
-    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->ram_buffer, ssd->bufsize, false);
+    ssd1306_send_window(ssd, 0, ssd->pages - 1, ssd->ram_buffer, ssd->bufsize);
+}
+
+// Envia um intervalo de páginas do buffer
+void ssd1306_send_pages(ssd1306_t *ssd, uint8_t primeira, uint8_t ultima) {
+    if (ultima >= ssd->pages) ultima = ssd->pages - 1;
+    if (primeira > ultima) return;
+
+    // O prefixo de dados precisa vir logo antes da primeira página: usa emprestado o
+    // último byte da página anterior e o devolve depois do envio
+    uint8_t *inicio = &ssd->ram_buffer[primeira * ssd->width];
+    uint8_t guardado = *inicio;
+    *inicio = 0x40;
+    ssd1306_send_window(ssd, primeira, ultima, inicio, (ultima - primeira + 1) * ssd->width + 1);
+    *inicio = guardado;
 }
 
 // Desenha um pixel no buffer
@@ -6,19 +6,42 @@
 #include <stdbool.h>
 #include "hardware/i2c.h"
 
+// Transporte alternativo ao I2C direto (ex.: árbitro de barramento compartilhado).
+// Cada chamada é uma única transação: cabecalho seguido de dados, sem STOP entre eles
+typedef void (*ssd1306_transporte_t)(void *contexto, const uint8_t *cabecalho, size_t tamanho_cabecalho,
+                                     const uint8_t *dados, size_t tamanho_dados);
+
 typedef struct {
     uint8_t width, height, pages, address;
     i2c_inst_t *i2c_port;
     uint16_t bufsize;
     uint8_t *ram_buffer;
     uint8_t port_buffer[2];
+    ssd1306_transporte_t transporte; // NULL: escreve direto em i2c_port
+    void *contexto_transporte;
 } ssd1306_t;
 
+// Comandos enviados por transação em ssd1306_command_list
+#define SSD1306_COMANDOS_POR_TRANSACAO 32
+
+// Bytes do framebuffer: uma página de 8 linhas por byte, mais o prefixo de dados
+#define SSD1306_TAMANHO_BUFFER(width, height) ((width) * ((height) / 8) + 1)
+
 void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height,
                   bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+// Igual a ssd1306_init, mas usa um buffer fornecido (SSD1306_TAMANHO_BUFFER bytes) em vez do heap
+void ssd1306_init_buffer(ssd1306_t *ssd, uint8_t width, uint8_t height,
+                         bool external_vcc, uint8_t address, i2c_inst_t *i2c,
+                         uint8_t *buffer);
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
+// Envia uma sequência de comandos (e seus argumentos) em uma só transação
+void ssd1306_command_list(ssd1306_t *ssd, const uint8_t *commands, size_t count);
+// Passa as transações do display por outro transporte (NULL volta ao I2C direto)
+void ssd1306_set_transporte(ssd1306_t *ssd, ssd1306_transporte_t transporte, void *contexto);
 void ssd1306_send_data(ssd1306_t *ssd);
+// Envia só as páginas de primeira a ultima (inclusive)
+void ssd1306_send_pages(ssd1306_t *ssd, uint8_t primeira, uint8_t ultima);
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0,
@@ -0,0 +1,147 @@
+#include "aquisicao_adc.h"
+#include <stdio.h>
+#include "pico/stdlib.h"
+#include "hardware/adc.h"
+#include "hardware/dma.h"
+#include "hardware/irq.h"
+
+#define CLOCK_ADC_HZ      48000000u
+#define INTERRUPCAO_DMA   1 //DMA_IRQ_1, com handler compartilhado
+#define PINO_ADC0         26
+
+static struct {
+    ConsumidorAdc consumidores[AQUISICAO_ADC_ENTRADAS];
+    void *contextos[AQUISICAO_ADC_ENTRADAS];
+    uint8_t ordem[AQUISICAO_ADC_ENTRADAS]; //Sequência do round-robin (entradas em ordem crescente)
+    uint8_t quantidade;
+    uint8_t fase;                          //Posição em 'ordem' da próxima conversão do bloco
+    int canais[2];
+    uint16_t blocos[2][AQUISICAO_ADC_BLOCO];
+    MetricasAquisicaoAdc metricas;
+} aquisicao;
+
+void aquisicao_adc_registrar(uint8_t entrada, ConsumidorAdc consumidor, void *contexto) {
+    if (entrada < AQUISICAO_ADC_ENTRADAS) {
+        aquisicao.consumidores[entrada] = consumidor;
+        aquisicao.contextos[entrada] = contexto;
+    }
+}
+
+//Separa as conversões do bloco por entrada; a fase continua de um bloco para o outro
+//porque o tamanho do bloco não precisa ser múltiplo da quantidade de entradas
+static void processarBloco(const uint16_t *bloco) {
+    uint32_t somas[AQUISICAO_ADC_ENTRADAS] = {0};
+    uint16_t quantidades[AQUISICAO_ADC_ENTRADAS] = {0};
+    uint8_t fase = aquisicao.fase;
+
+    for (uint16_t i = 0; i < AQUISICAO_ADC_BLOCO; i++) {
+        uint8_t entrada = aquisicao.ordem[fase];
+        fase = fase + 1 == aquisicao.quantidade ? 0 : fase + 1;
+        if (bloco[i] & AQUISICAO_ADC_ERRO) {
+            aquisicao.metricas.erros++;
+            continue;
+        }
+        somas[entrada] += bloco[i] & 0x0FFF;
+        quantidades[entrada]++;
+    }
+    aquisicao.fase = fase;
+
+    for (uint8_t i = 0; i < aquisicao.quantidade; i++) {
+        uint8_t entrada = aquisicao.ordem[i];
+        if (quantidades[entrada]) {
+            aquisicao.consumidores[entrada](somas[entrada], quantidades[entrada], aquisicao.contextos[entrada]);
+        }
+    }
+    aquisicao.metricas.blocos++;
+}
+
+static void tratarDma(void) {
+    for (int i = 0; i < 2; i++) {
+        int canal = aquisicao.canais[i];
+        if (!dma_irqn_get_channel_status(INTERRUPCAO_DMA, canal)) {
+            continue;
+        }
+        uint32_t inicio = time_us_32();
+        dma_irqn_acknowledge_channel(INTERRUPCAO_DMA, canal);
+        //O outro canal já está enchendo o próximo bloco; este só volta a rodar quando ele terminar
+        dma_channel_set_write_addr(canal, aquisicao.blocos[i], false);
+        dma_channel_set_trans_count(canal, AQUISICAO_ADC_BLOCO, false);
+        processarBloco(aquisicao.blocos[i]);
+        uint32_t duracao = time_us_32() - inicio;
+        if (duracao > aquisicao.metricas.processamento_maximo_us) {
+            aquisicao.metricas.processamento_maximo_us = duracao;
+        }
+    }
+}
+
+static void configurarCanal(int indice) {
+    int canal = aquisicao.canais[indice];
+    dma_channel_config configuracao = dma_channel_get_default_config(canal);
+    channel_config_set_transfer_data_size(&configuracao, DMA_SIZE_16);
+    channel_config_set_read_increment(&configuracao, false);
+    channel_config_set_write_increment(&configuracao, true);
+    channel_config_set_dreq(&configuracao, DREQ_ADC);
+    channel_config_set_chain_to(&configuracao, aquisicao.canais[1 - indice]);
+    dma_channel_configure(canal, &configuracao, aquisicao.blocos[indice], &adc_hw->fifo, AQUISICAO_ADC_BLOCO, false);
+    dma_irqn_set_channel_enabled(INTERRUPCAO_DMA, canal, true);
+}
+
+bool aquisicao_adc_iniciar(uint32_t conversoes_por_segundo) {
+    uint32_t mascara = 0;
+    aquisicao.quantidade = 0;
+    for (uint8_t entrada = 0; entrada < AQUISICAO_ADC_ENTRADAS; entrada++) {
+        if (aquisicao.consumidores[entrada]) {
+            aquisicao.ordem[aquisicao.quantidade++] = entrada;
+            mascara |= 1u << entrada;
+        }
+    }
+    if (!aquisicao.quantidade || !conversoes_por_segundo) {
+        return false;
+    }
+
+    aquisicao.canais[0] = dma_claim_unused_channel(false);
+    aquisicao.canais[1] = dma_claim_unused_channel(false);
+    if (aquisicao.canais[0] < 0 || aquisicao.canais[1] < 0) {
+        printf("Aquisicao ADC: canais de DMA indisponiveis\n");
+        return false;
+    }
+
+    adc_init();
+    for (uint8_t i = 0; i < aquisicao.quantidade; i++) {
+        if (aquisicao.ordem[i] < 4) {
+            adc_gpio_init(PINO_ADC0 + aquisicao.ordem[i]);
+        } else {
+            adc_set_temp_sensor_enabled(true);
+        }
+    }
+    //O round-robin começa na entrada selecionada e segue as habilitadas em ordem crescente
+    adc_select_input(aquisicao.ordem[0]);
+    adc_set_round_robin(aquisicao.quantidade > 1 ? mascara : 0);
+    //Com o erro no bit 15 uma conversão ruim é descartada sem perder o alinhamento das entradas
+    adc_fifo_setup(true, true, 1, true, false);
+    adc_set_clkdiv((float)CLOCK_ADC_HZ / conversoes_por_segundo - 1.0f);
+    adc_fifo_drain();
+    aquisicao.fase = 0;
+    aquisicao.metricas.conversoes_por_segundo = conversoes_por_segundo;
+
+    configurarCanal(0);
+    configurarCanal(1);
+    irq_add_shared_handler(DMA_IRQ_0 + INTERRUPCAO_DMA, tratarDma, PICO_SHARED_IRQ_HANDLER_DEFAULT_ORDER_PRIORITY);
+    irq_set_enabled(DMA_IRQ_0 + INTERRUPCAO_DMA, true);
+
+    dma_channel_start(aquisicao.canais[0]);
+    adc_run(true);
+    return true;
+}
+
+const MetricasAquisicaoAdc *aquisicao_adc_metricas(void) {
+    return &aquisicao.metricas;
+}
+
+int aquisicao_adc_json(char *buffer, size_t tamanho) {
+    const MetricasAquisicaoAdc *m = &aquisicao.metricas;
+    return snprintf(buffer, tamanho,
+                    "{\"conversoes_por_segundo\":%lu,\"entradas\":%u,\"blocos\":%lu,\"erros\":%lu,\"processamento_max_us\":%lu}",
+                    (unsigned long)m->conversoes_por_segundo, aquisicao.quantidade, (unsigned long)m->blocos,
+                    (unsigned long)m->erros, (unsigned long)m->processamento_maximo_us);
+}
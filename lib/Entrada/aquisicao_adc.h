@@ -0,0 +1,40 @@
+#ifndef AQUISICAO_ADC_H
+#define AQUISICAO_ADC_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+
+//Aquisição contínua do ADC por DMA, sem a CPU disparar conversões.
+//O ADC roda livre em round-robin sobre as entradas registradas e dois canais
+//de DMA encadeados enchem blocos alternados (ping-pong). A cada bloco cheio a
+//interrupção do DMA separa as conversões por entrada e entrega a soma de cada
+//uma ao seu consumidor (média por superamostragem); o bloco seguinte já está
+//sendo preenchido pelo outro canal
+
+#define AQUISICAO_ADC_ENTRADAS 5  //ADC0 a ADC3 (GPIO 26 a 29) e o sensor interno (ADC4)
+#define AQUISICAO_ADC_BLOCO    64 //Conversões por bloco, somando todas as entradas
+#define AQUISICAO_ADC_ERRO     (1u << 15) //Marcador de erro que o FIFO põe na conversão
+
+//Chamado na interrupção do DMA com a soma das conversões válidas da entrada no bloco
+typedef void (*ConsumidorAdc)(uint32_t soma, uint16_t quantidade, void *contexto);
+
+typedef struct {
+    uint32_t conversoes_por_segundo; //Taxa total do ADC (dividida entre as entradas)
+    uint32_t blocos;                 //Blocos processados
+    uint32_t erros;                  //Conversões descartadas pelo bit de erro
+    uint32_t processamento_maximo_us;
+} MetricasAquisicaoAdc;
+
+//Associa um consumidor a uma entrada (0 a 4); chamar antes de aquisicao_adc_iniciar
+void aquisicao_adc_registrar(uint8_t entrada, ConsumidorAdc consumidor, void *contexto);
+
+//Configura ADC, DMA e interrupção e inicia as conversões; false se não houver entradas ou canais de DMA
+bool aquisicao_adc_iniciar(uint32_t conversoes_por_segundo);
+
+const MetricasAquisicaoAdc *aquisicao_adc_metricas(void);
+
+//Serializa as métricas como objeto JSON; retorna o número de caracteres escritos
+int aquisicao_adc_json(char *buffer, size_t tamanho);
+
+#endif // AQUISICAO_ADC_H
@@ -0,0 +1,91 @@
+#include "botao_irq.h"
+#include "hardware/gpio.h"
+#include "hardware/irq.h"
+
+#define BORDAS (GPIO_IRQ_EDGE_FALL | GPIO_IRQ_EDGE_RISE)
+
+static BotaoIrq *botoes[BOTAO_IRQ_MAXIMO];
+static uint8_t quantidade_botoes;
+
+//Lê o nível e publica se ele diferir do último estado estável
+static bool publicar(BotaoIrq *botao, BaseType_t *acordar) {
+    bool pressionado = !gpio_get(botao->pino);
+    if (pressionado == botao->pressionado) {
+        return false;
+    }
+    botao->pressionado = pressionado;
+    botao->instante_us = time_us_64();
+    if (pressionado) {
+        botao->pressoes++;
+    } else {
+        botao->solturas++;
+    }
+    if (botao->tarefa) {
+        xTaskNotifyFromISR(botao->tarefa, botao->bit_evento, eSetBits, acordar);
+    }
+    return true;
+}
+
+static int64_t fimDebounce(alarm_id_t id, void *dados) {
+    BotaoIrq *botao = (BotaoIrq *)dados;
+    BaseType_t acordar = pdFALSE;
+
+    //Descarta as bordas da trepidação e volta a ouvir o pino
+    gpio_acknowledge_irq(botao->pino, BORDAS);
+    gpio_set_irq_enabled(botao->pino, BORDAS, true);
+
+    //Se o nível mudou dentro da janela, publica agora e abre outra janela
+    int64_t reagendar = 0;
+    if (publicar(botao, &acordar)) {
+        gpio_set_irq_enabled(botao->pino, BORDAS, false);
+        reagendar = BOTAO_IRQ_DEBOUNCE_US;
+    }
+    portYIELD_FROM_ISR(acordar);
+    return reagendar;
+}
+
+static void tratarBorda(void) {
+    BaseType_t acordar = pdFALSE;
+    for (uint8_t i = 0; i < quantidade_botoes; i++) {
+        BotaoIrq *botao = botoes[i];
+        uint32_t eventos = gpio_get_irq_event_mask(botao->pino);
+        if (!(eventos & BORDAS)) {
+            continue;
+        }
+        gpio_acknowledge_irq(botao->pino, eventos);
+        if (!publicar(botao, &acordar)) {
+            continue; //Pulso curto demais: o nível já voltou ao estado estável
+        }
+        //As próximas bordas são trepidação até o alarme conferir o nível
+        gpio_set_irq_enabled(botao->pino, BORDAS, false);
+        if (add_alarm_in_us(BOTAO_IRQ_DEBOUNCE_US, fimDebounce, botao, true) <= 0) {
+            gpio_set_irq_enabled(botao->pino, BORDAS, true);
+        }
+    }
+    portYIELD_FROM_ISR(acordar);
+}
+
+bool botao_irq_iniciar(BotaoIrq *botao, uint pino, TaskHandle_t tarefa, uint32_t bit_evento) {
+    if (quantidade_botoes >= BOTAO_IRQ_MAXIMO) {
+        return false;
+    }
+    gpio_init(pino);
+    gpio_set_dir(pino, GPIO_IN);
+    gpio_pull_up(pino);
+    sleep_us(10); //Pull-up estabiliza antes da primeira leitura
+
+    botao->pino = pino;
+    botao->pressionado = !gpio_get(pino);
+    botao->pressoes = 0;
+    botao->solturas = 0;
+    botao->instante_us = time_us_64();
+    botao->tarefa = tarefa;
+    botao->bit_evento = bit_evento;
+    botoes[quantidade_botoes++] = botao;
+
+    //Handler próprio do pino: convive com o do driver Wi-Fi e com o callback padrão do SDK
+    gpio_add_raw_irq_handler(pino, tratarBorda);
+    gpio_set_irq_enabled(pino, BORDAS, true);
+    irq_set_enabled(IO_IRQ_BANK0, true);
+    return true;
+}
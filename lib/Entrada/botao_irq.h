@@ -0,0 +1,33 @@
+#ifndef BOTAO_IRQ_H
+#define BOTAO_IRQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "pico/stdlib.h"
+#include "FreeRTOS.h"
+#include "task.h"
+
+//Botão ativo em nível baixo (pull-up interno) lido por interrupção de borda.
+//A primeira borda é publicada na hora; em seguida a interrupção do pino fica
+//desligada por BOTAO_IRQ_DEBOUNCE_US e um alarme confere o nível no fim da
+//janela, então a trepidação não gera eventos nem interrupções repetidas.
+//Cada mudança estável incrementa um contador e avisa a task por notificação
+//(bits), de modo que um toque curto nunca se perde
+
+#define BOTAO_IRQ_DEBOUNCE_US 20000
+#define BOTAO_IRQ_MAXIMO      4 //Botões simultâneos (um handler cuida de todos)
+
+typedef struct {
+    uint pino;
+    volatile bool pressionado;     //Estado estável
+    volatile uint32_t pressoes;    //Bordas estáveis de soltura para pressão
+    volatile uint32_t solturas;
+    volatile uint64_t instante_us; //Instante em que o último estado estável foi detectado
+    TaskHandle_t tarefa;           //Task avisada a cada mudança (NULL: ninguém)
+    uint32_t bit_evento;
+} BotaoIrq;
+
+//Configura o pino e a interrupção; o estado inicial é lido na hora
+bool botao_irq_iniciar(BotaoIrq *botao, uint pino, TaskHandle_t tarefa, uint32_t bit_evento);
+
+#endif // BOTAO_IRQ_H
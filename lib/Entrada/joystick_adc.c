@@ -0,0 +1,49 @@
+#include "joystick_adc.h"
+#include "pico/stdlib.h"
+#include "aquisicao_adc.h"
+
+static void consumirBloco(uint32_t soma, uint16_t quantidade, void *contexto) {
+    JoystickAdc *joystick = (JoystickAdc *)contexto;
+    uint16_t media = (uint16_t)((soma + quantidade / 2) / quantidade);
+    joystick->media = media;
+
+    int8_t direcao = joystick->direcao;
+    if (direcao == 0) {
+        direcao = media > joystick->limite_alto ? 1 : (media < joystick->limite_baixo ? -1 : 0);
+    } else if (direcao == 1 && media + joystick->histerese < joystick->limite_alto) {
+        direcao = media < joystick->limite_baixo ? -1 : 0;
+    } else if (direcao == -1 && media > joystick->limite_baixo + joystick->histerese) {
+        direcao = media > joystick->limite_alto ? 1 : 0;
+    }
+    if (direcao == joystick->direcao) {
+        return;
+    }
+
+    joystick->direcao = direcao;
+    joystick->instante_us = time_us_64();
+    if (direcao == 1) {
+        joystick->subidas++;
+    } else if (direcao == -1) {
+        joystick->descidas++;
+    }
+    if (joystick->tarefa) {
+        BaseType_t acordar = pdFALSE;
+        xTaskNotifyFromISR(joystick->tarefa, joystick->bit_evento, eSetBits, &acordar);
+        portYIELD_FROM_ISR(acordar);
+    }
+}
+
+void joystick_adc_iniciar(JoystickAdc *joystick, uint8_t entrada_adc, uint16_t limite_baixo,
+                          uint16_t limite_alto, uint16_t histerese, TaskHandle_t tarefa, uint32_t bit_evento) {
+    joystick->limite_baixo = limite_baixo;
+    joystick->limite_alto = limite_alto;
+    joystick->histerese = histerese;
+    joystick->media = 2048;
+    joystick->direcao = 0;
+    joystick->subidas = 0;
+    joystick->descidas = 0;
+    joystick->instante_us = time_us_64();
+    joystick->tarefa = tarefa;
+    joystick->bit_evento = bit_evento;
+    aquisicao_adc_registrar(entrada_adc, consumirBloco, joystick);
+}
@@ -0,0 +1,29 @@
+#ifndef JOYSTICK_ADC_H
+#define JOYSTICK_ADC_H
+
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+//Eixo analógico do joystick sobre lib/Entrada/aquisicao_adc: cada bloco do DMA
+//vira uma média superamostrada e só a travessia dos limites (com histerese)
+//gera evento para a task, que fica dormindo enquanto o eixo não se move
+
+typedef struct {
+    uint16_t limite_baixo;     //Abaixo: direção -1
+    uint16_t limite_alto;      //Acima: direção +1
+    uint16_t histerese;        //Margem para voltar ao centro
+    volatile uint16_t media;   //Última média (12 bits)
+    volatile int8_t direcao;   //-1, 0 ou +1
+    volatile uint32_t subidas; //Entradas em +1
+    volatile uint32_t descidas; //Entradas em -1
+    volatile uint64_t instante_us; //Instante da última mudança de direção
+    TaskHandle_t tarefa;
+    uint32_t bit_evento;
+} JoystickAdc;
+
+//Registra o eixo na aquisição; chamar antes de aquisicao_adc_iniciar
+void joystick_adc_iniciar(JoystickAdc *joystick, uint8_t entrada_adc, uint16_t limite_baixo,
+                          uint16_t limite_alto, uint16_t histerese, TaskHandle_t tarefa, uint32_t bit_evento);
+
+#endif // JOYSTICK_ADC_H
@@ -63,15 +63,23 @@
  #define configUSE_NEWLIB_REENTRANT              0
  #define configENABLE_BACKWARD_COMPATIBILITY     0
  #define configNUM_THREAD_LOCAL_STORAGE_POINTERS 5
+ #define configTASK_NOTIFICATION_ARRAY_ENTRIES   2 /* Índice 1: passagem do barramento I2C */
  
  /* System */
  #define configSTACK_DEPTH_TYPE                  uint32_t
  #define configMESSAGE_BUFFER_LENGTH_TYPE        size_t
  
  /* Memory allocation related definitions. */
+ /* MEMORIA_ESTATICA (opção do CMake): tasks, idle e timer com memória estática
+    e nenhum heap do FreeRTOS; o heap4 deixa de ser vinculado. */
+ #if defined(MEMORIA_ESTATICA) && MEMORIA_ESTATICA
+ #define configSUPPORT_STATIC_ALLOCATION         1
+ #define configSUPPORT_DYNAMIC_ALLOCATION        0
+ #else
  #define configSUPPORT_STATIC_ALLOCATION         0
  #define configSUPPORT_DYNAMIC_ALLOCATION        1
  #define configTOTAL_HEAP_SIZE                   (128*1024)
+ #endif
  #define configAPPLICATION_ALLOCATED_HEAP        0
  
  /* Hook function related definitions. */
@@ -0,0 +1,162 @@
+#include "historico.h"
+#include <string.h>
+#include <math.h>
+
+// Associa o armazenamento de um nível ao anel
+static void configurarNivel(NivelAnel *nivel, int16_t *medias, int16_t *minimos, int16_t *maximos,
+                            uint16_t *fila_minimo, uint16_t *fila_maximo, uint16_t capacidade,
+                            uint32_t segundos_por_balde) {
+    memset(nivel, 0, sizeof(*nivel));
+    nivel->medias = medias;
+    nivel->minimos = minimos;
+    nivel->maximos = maximos;
+    nivel->fila_minimo = fila_minimo;
+    nivel->fila_maximo = fila_maximo;
+    nivel->capacidade = capacidade;
+    nivel->segundos_por_balde = segundos_por_balde;
+    nivel->periodo_acumulado = UINT32_MAX;
+}
+
+// Insere um balde no anel atualizando soma, soma dos quadrados e filas de extremos
+static void inserirBalde(NivelAnel *nivel, int16_t media, int16_t minimo, int16_t maximo, uint32_t tempo_s) {
+    uint16_t posicao = nivel->posicao;
+    uint16_t capacidade = nivel->capacidade;
+
+    //Remove da janela o balde mais antigo, que será sobrescrito
+    if (nivel->quantidade == capacidade) {
+        int32_t antigo = nivel->medias[posicao];
+        nivel->soma -= antigo;
+        nivel->soma_quadrados -= antigo * antigo;
+        if (nivel->tamanho_minimo && nivel->fila_minimo[nivel->inicio_minimo] == posicao) {
+            nivel->inicio_minimo = (nivel->inicio_minimo + 1) % capacidade;
+            nivel->tamanho_minimo--;
+        }
+        if (nivel->tamanho_maximo && nivel->fila_maximo[nivel->inicio_maximo] == posicao) {
+            nivel->inicio_maximo = (nivel->inicio_maximo + 1) % capacidade;
+            nivel->tamanho_maximo--;
+        }
+    } else {
+        nivel->quantidade++;
+    }
+
+    nivel->medias[posicao] = media;
+    nivel->minimos[posicao] = minimo;
+    nivel->maximos[posicao] = maximo;
+    nivel->soma += media;
+    nivel->soma_quadrados += (int32_t)media * media;
+
+    //Descarta do fim das filas os candidatos que nunca mais serão extremos
+    while (nivel->tamanho_minimo) {
+        uint16_t ultimo = (nivel->inicio_minimo + nivel->tamanho_minimo - 1) % capacidade;
+        if (nivel->minimos[nivel->fila_minimo[ultimo]] < minimo) break;
+        nivel->tamanho_minimo--;
+    }
+    nivel->fila_minimo[(nivel->inicio_minimo + nivel->tamanho_minimo) % capacidade] = posicao;
+    nivel->tamanho_minimo++;
+
+    while (nivel->tamanho_maximo) {
+        uint16_t ultimo = (nivel->inicio_maximo + nivel->tamanho_maximo - 1) % capacidade;
+        if (nivel->maximos[nivel->fila_maximo[ultimo]] > maximo) break;
+        nivel->tamanho_maximo--;
+    }
+    nivel->fila_maximo[(nivel->inicio_maximo + nivel->tamanho_maximo) % capacidade] = posicao;
+    nivel->tamanho_maximo++;
+
+    nivel->posicao = (posicao + 1) % capacidade;
+    nivel->ultimo_tempo_s = tempo_s;
+}
+
+// Prepara os anéis vazios
+void historico_inicializar(Historico *historico) {
+    //No nível de segundos cada balde é uma amostra: mínimo e máximo coincidem com a média
+    configurarNivel(&historico->niveis[NIVEL_SEGUNDOS], historico->segundos, historico->segundos, historico->segundos,
+                    historico->filas_segundos[0], historico->filas_segundos[1], HISTORICO_CAPACIDADE_SEGUNDOS, 1);
+    configurarNivel(&historico->niveis[NIVEL_MINUTOS], historico->minutos[0], historico->minutos[1], historico->minutos[2],
+                    historico->filas_minutos[0], historico->filas_minutos[1], HISTORICO_CAPACIDADE_MINUTOS, 60);
+    configurarNivel(&historico->niveis[NIVEL_HORAS], historico->horas[0], historico->horas[1], historico->horas[2],
+                    historico->filas_horas[0], historico->filas_horas[1], HISTORICO_CAPACIDADE_HORAS, 3600);
+}
+
+// Registra uma amostra e propaga os baldes fechados para os níveis superiores
+void historico_registrar(Historico *historico, float temperatura, uint32_t tempo_s) {
+    int16_t valor = (int16_t)lroundf(temperatura * 100.0f);
+    int16_t minimo = valor, maximo = valor;
+
+    for (int n = 0; n < HISTORICO_NIVEIS; n++) {
+        NivelAnel *nivel = &historico->niveis[n];
+        inserirBalde(nivel, valor, minimo, maximo, tempo_s);
+        if (n + 1 == HISTORICO_NIVEIS) {
+            break;
+        }
+
+        //Acumula no balde do nível seguinte; ao mudar de período o balde anterior é fechado
+        NivelAnel *superior = &historico->niveis[n + 1];
+        uint32_t periodo = tempo_s / superior->segundos_por_balde;
+        bool fechar = superior->acumulado_quantidade && periodo != superior->periodo_acumulado;
+        int16_t media_fechada = 0, minimo_fechado = 0, maximo_fechado = 0;
+        uint32_t inicio_fechado = 0;
+        if (fechar) {
+            //Média arredondada ao mais próximo (a divisão inteira puxaria as negativas para cima)
+            int32_t soma = superior->acumulado_soma;
+            int32_t quantidade = superior->acumulado_quantidade;
+            media_fechada = (int16_t)((soma >= 0 ? soma + quantidade / 2 : soma - quantidade / 2) / quantidade);
+            inicio_fechado = superior->periodo_acumulado * superior->segundos_por_balde;
+            minimo_fechado = superior->acumulado_minimo;
+            maximo_fechado = superior->acumulado_maximo;
+            superior->acumulado_quantidade = 0;
+        }
+        if (!superior->acumulado_quantidade) {
+            superior->periodo_acumulado = periodo;
+            superior->acumulado_soma = 0;
+            superior->acumulado_minimo = INT16_MAX;
+            superior->acumulado_maximo = INT16_MIN;
+        }
+        superior->acumulado_soma += valor;
+        if (minimo < superior->acumulado_minimo) superior->acumulado_minimo = minimo;
+        if (maximo > superior->acumulado_maximo) superior->acumulado_maximo = maximo;
+        superior->acumulado_quantidade++;
+
+        if (!fechar) {
+            break;
+        }
+        //O balde fechado sobe com o instante em que começou: o minuto 00:59 fechado pela
+        //amostra de 01:00:00 pertence à hora 00
+        valor = media_fechada;
+        minimo = minimo_fechado;
+        maximo = maximo_fechado;
+        tempo_s = inicio_fechado;
+    }
+}
+
+// Estatísticas da janela de um nível em O(1)
+bool historico_estatisticas(const Historico *historico, NivelHistorico nivel, EstatisticasHistorico *estatisticas) {
+    const NivelAnel *anel = &historico->niveis[nivel];
+    estatisticas->quantidade = anel->quantidade;
+    if (!anel->quantidade) {
+        estatisticas->media = estatisticas->minimo = estatisticas->maximo = estatisticas->variancia = 0.0f;
+        return false;
+    }
+
+    float media = (float)anel->soma / anel->quantidade;
+    float variancia = (float)anel->soma_quadrados / anel->quantidade - media * media;
+    estatisticas->media = media / 100.0f;
+    estatisticas->variancia = (variancia > 0.0f ? variancia : 0.0f) / 10000.0f;
+    estatisticas->minimo = anel->minimos[anel->fila_minimo[anel->inicio_minimo]] / 100.0f;
+    estatisticas->maximo = anel->maximos[anel->fila_maximo[anel->inicio_maximo]] / 100.0f;
+    return true;
+}
+
+// Quantidade de baldes armazenados em um nível
+uint16_t historico_quantidade(const Historico *historico, NivelHistorico nivel) {
+    return historico->niveis[nivel].quantidade;
+}
+
+// Média de um balde; idade 0 é o mais recente
+int16_t historico_amostra(const Historico *historico, NivelHistorico nivel, uint16_t idade) {
+    const NivelAnel *anel = &historico->niveis[nivel];
+    if (idade >= anel->quantidade) {
+        return 0;
+    }
+    uint16_t posicao = (anel->posicao + anel->capacidade - 1 - idade) % anel->capacidade;
+    return anel->medias[posicao];
+}
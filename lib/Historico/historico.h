@@ -0,0 +1,83 @@
+#ifndef HISTORICO_H
+#define HISTORICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Histórico de temperatura em três resoluções (1 s, 1 min, 1 h) guardado em
+//centésimos de grau (int16). Cada nível mantém soma, soma dos quadrados e
+//filas monotônicas de mínimo/máximo, então as estatísticas da janela são O(1)
+
+#define HISTORICO_CAPACIDADE_SEGUNDOS 120 //2 minutos com resolução de 1 s
+#define HISTORICO_CAPACIDADE_MINUTOS  240 //4 horas com resolução de 1 min
+#define HISTORICO_CAPACIDADE_HORAS    48  //2 dias com resolução de 1 h
+
+typedef enum {
+    NIVEL_SEGUNDOS,
+    NIVEL_MINUTOS,
+    NIVEL_HORAS,
+    HISTORICO_NIVEIS
+} NivelHistorico;
+
+//Anel de um nível com agregados incrementais
+typedef struct {
+    int16_t *medias;          //Valor médio de cada balde
+    int16_t *minimos;         //Mínimo de cada balde (no nível de segundos aponta para medias)
+    int16_t *maximos;         //Máximo de cada balde (no nível de segundos aponta para medias)
+    uint16_t *fila_minimo;    //Posições candidatas a mínimo da janela, em ordem crescente de valor
+    uint16_t *fila_maximo;    //Posições candidatas a máximo da janela, em ordem decrescente de valor
+    uint16_t capacidade;
+    uint16_t quantidade;
+    uint16_t posicao;         //Próxima posição de escrita
+    uint16_t inicio_minimo, tamanho_minimo;
+    uint16_t inicio_maximo, tamanho_maximo;
+    int32_t soma;
+    int64_t soma_quadrados;
+    uint32_t segundos_por_balde;
+    uint32_t ultimo_tempo_s;  //Início do balde mais recente (a própria amostra no nível de segundos)
+
+    //Balde em formação para o nível seguinte
+    uint32_t periodo_acumulado;
+    int32_t acumulado_soma;
+    int16_t acumulado_minimo;
+    int16_t acumulado_maximo;
+    uint16_t acumulado_quantidade;
+} NivelAnel;
+
+typedef struct {
+    NivelAnel niveis[HISTORICO_NIVEIS];
+
+    //Armazenamento dos anéis e das filas
+    int16_t segundos[HISTORICO_CAPACIDADE_SEGUNDOS];
+    uint16_t filas_segundos[2][HISTORICO_CAPACIDADE_SEGUNDOS];
+    int16_t minutos[3][HISTORICO_CAPACIDADE_MINUTOS];
+    uint16_t filas_minutos[2][HISTORICO_CAPACIDADE_MINUTOS];
+    int16_t horas[3][HISTORICO_CAPACIDADE_HORAS];
+    uint16_t filas_horas[2][HISTORICO_CAPACIDADE_HORAS];
+} Historico;
+
+//Estatísticas da janela completa de um nível, em °C
+typedef struct {
+    uint16_t quantidade;
+    float media;
+    float minimo;
+    float maximo;
+    float variancia;
+} EstatisticasHistorico;
+
+//Prepara os anéis vazios
+void historico_inicializar(Historico *historico);
+
+//Registra uma amostra (°C) no instante indicado e propaga os baldes fechados
+void historico_registrar(Historico *historico, float temperatura, uint32_t tempo_s);
+
+//Estatísticas da janela de um nível em O(1); retorna false se estiver vazio
+bool historico_estatisticas(const Historico *historico, NivelHistorico nivel, EstatisticasHistorico *estatisticas);
+
+//Quantidade de baldes armazenados em um nível
+uint16_t historico_quantidade(const Historico *historico, NivelHistorico nivel);
+
+//Média de um balde em centésimos de grau; idade 0 é o mais recente
+int16_t historico_amostra(const Historico *historico, NivelHistorico nivel, uint16_t idade);
+
+#endif // HISTORICO_H
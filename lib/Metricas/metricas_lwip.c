@@ -0,0 +1,36 @@
+#include "metricas_lwip.h"
+#include <stdio.h>
+#include "lwip/opt.h"
+#include "lwip/stats.h"
+#include "lwip/memp.h"
+
+//Nomes dos pools na ordem de memp_t; a descrição do lwIP só existe em builds de depuração
+static const char *const NOMES_POOLS[MEMP_MAX] = {
+#define LWIP_MEMPOOL(nome, quantidade, tamanho, descricao) #nome,
+#include "lwip/priv/memp_std.h"
+};
+
+int metricas_lwip_json(char *buffer, size_t tamanho) {
+    const struct stats_mem *heap = &lwip_stats.mem;
+    int usado = snprintf(buffer, tamanho,
+        "{\"perfil\":\"%s\",\"heap\":{\"tamanho\":%lu,\"usado\":%lu,\"maximo\":%lu,\"falhas\":%lu},\"pools\":[",
+        LWIP_PERFIL_NOME, (unsigned long)MEM_SIZE, (unsigned long)heap->used,
+        (unsigned long)heap->max, (unsigned long)heap->err);
+
+    const char *separador = "";
+    for (int i = 0; i < MEMP_MAX && usado < (int)tamanho; i++) {
+        const struct stats_mem *pool = lwip_stats.memp[i];
+        if (!pool) {
+            continue;
+        }
+        usado += snprintf(buffer + usado, tamanho - usado,
+            "%s{\"nome\":\"%s\",\"total\":%lu,\"usado\":%lu,\"maximo\":%lu,\"falhas\":%lu}",
+            separador, NOMES_POOLS[i], (unsigned long)pool->avail, (unsigned long)pool->used,
+            (unsigned long)pool->max, (unsigned long)pool->err);
+        separador = ",";
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "]}");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
@@ -0,0 +1,14 @@
+#ifndef METRICAS_LWIP_H
+#define METRICAS_LWIP_H
+
+#include <stddef.h>
+
+//Uso do heap e dos pools do lwIP a partir dos contadores MEM_STATS/MEMP_STATS:
+//total, em uso, pico e falhas de alocação de cada pool, mais o perfil de
+//memória compilado (lwipopts.h). Chamar no contexto do lwIP (callbacks ou
+//entre cyw43_arch_lwip_begin/end)
+
+//Serializa como objeto JSON; retorna o número de caracteres escritos
+int metricas_lwip_json(char *buffer, size_t tamanho);
+
+#endif // METRICAS_LWIP_H
@@ -0,0 +1,62 @@
+#include "metricas_periodo.h"
+#include <stdio.h>
+#include <string.h>
+#include "pico/stdlib.h"
+
+static const uint32_t limites_us[METRICAS_FAIXAS - 1] = METRICAS_LIMITES_US;
+
+void metricas_periodo_iniciar(MetricasPeriodo *metricas, const char *nome, uint32_t periodo_nominal_us) {
+    memset(metricas, 0, sizeof(*metricas));
+    metricas->nome = nome;
+    metricas->periodo_nominal_us = periodo_nominal_us;
+    metricas->periodo_minimo_us = UINT32_MAX;
+}
+
+// Mede o intervalo desde a liberação anterior e classifica o desvio
+uint32_t metricas_periodo_marcar(MetricasPeriodo *metricas) {
+    uint64_t agora = time_us_64();
+    uint64_t anterior = metricas->ultima_liberacao_us;
+    metricas->ultima_liberacao_us = agora;
+    if (!anterior) {
+        return metricas->periodo_nominal_us;
+    }
+
+    uint32_t periodo = (uint32_t)(agora - anterior);
+    uint32_t desvio = periodo > metricas->periodo_nominal_us ? periodo - metricas->periodo_nominal_us
+                                                             : metricas->periodo_nominal_us - periodo;
+    int faixa = 0;
+    while (faixa < METRICAS_FAIXAS - 1 && desvio >= limites_us[faixa]) {
+        faixa++;
+    }
+    metricas->histograma[faixa]++;
+    metricas->ativacoes++;
+    metricas->soma_periodos_us += periodo;
+    if (periodo < metricas->periodo_minimo_us) metricas->periodo_minimo_us = periodo;
+    if (periodo > metricas->periodo_maximo_us) metricas->periodo_maximo_us = periodo;
+    return periodo;
+}
+
+void metricas_periodo_concluir(MetricasPeriodo *metricas) {
+    uint32_t execucao = (uint32_t)(time_us_64() - metricas->ultima_liberacao_us);
+    if (execucao > metricas->execucao_maxima_us) {
+        metricas->execucao_maxima_us = execucao;
+    }
+}
+
+int metricas_periodo_json(const MetricasPeriodo *metricas, char *buffer, size_t tamanho) {
+    uint32_t ativacoes = metricas->ativacoes;
+    int usado = snprintf(buffer, tamanho,
+        "{\"nome\":\"%s\",\"nominal_us\":%lu,\"ativacoes\":%lu,\"medio_us\":%lu,\"minimo_us\":%lu,\"maximo_us\":%lu,"
+        "\"execucao_maxima_us\":%lu,\"histograma_desvio\":[",
+        metricas->nome, (unsigned long)metricas->periodo_nominal_us, (unsigned long)ativacoes,
+        (unsigned long)(ativacoes ? metricas->soma_periodos_us / ativacoes : 0),
+        (unsigned long)(ativacoes ? metricas->periodo_minimo_us : 0), (unsigned long)metricas->periodo_maximo_us,
+        (unsigned long)metricas->execucao_maxima_us);
+    for (int i = 0; i < METRICAS_FAIXAS && usado < (int)tamanho; i++) {
+        usado += snprintf(buffer + usado, tamanho - usado, "%s%lu", i ? "," : "", (unsigned long)metricas->histograma[i]);
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "]}");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
@@ -0,0 +1,40 @@
+#ifndef METRICAS_PERIODO_H
+#define METRICAS_PERIODO_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//Medição de período e jitter de tasks periódicas pelo temporizador de 1 MHz.
+//A cada liberação a task chama metricas_periodo_marcar, que devolve o intervalo
+//real desde a liberação anterior e acumula o desvio em relação ao período nominal
+//em um histograma de faixas fixas
+
+#define METRICAS_FAIXAS 8
+
+//Limites superiores das faixas de |período - nominal| em µs; a última faixa é aberta
+#define METRICAS_LIMITES_US {100, 250, 500, 1000, 2000, 5000, 10000}
+
+typedef struct {
+    const char *nome;
+    uint32_t periodo_nominal_us;
+    uint64_t ultima_liberacao_us;
+    uint32_t ativacoes;
+    uint32_t periodo_minimo_us;
+    uint32_t periodo_maximo_us;
+    uint64_t soma_periodos_us;
+    uint32_t execucao_maxima_us;   //Maior tempo entre a liberação e o fim do trabalho
+    uint32_t histograma[METRICAS_FAIXAS];
+} MetricasPeriodo;
+
+void metricas_periodo_iniciar(MetricasPeriodo *metricas, const char *nome, uint32_t periodo_nominal_us);
+
+//Registra uma liberação; retorna o intervalo medido em µs (o nominal na primeira)
+uint32_t metricas_periodo_marcar(MetricasPeriodo *metricas);
+
+//Registra o fim do trabalho desta ativação
+void metricas_periodo_concluir(MetricasPeriodo *metricas);
+
+//Serializa como objeto JSON; retorna o número de caracteres escritos
+int metricas_periodo_json(const MetricasPeriodo *metricas, char *buffer, size_t tamanho);
+
+#endif // METRICAS_PERIODO_H
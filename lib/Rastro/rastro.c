@@ -0,0 +1,458 @@
+#include "rastro.h"
+#include <string.h>
+
+//Mesmo código lê e escreve os registros: na escrita os campos são copiados
+//para o bloco, na leitura o bloco é copiado para os campos
+typedef struct {
+    const uint8_t *entrada; //Leitura
+    uint8_t *saida;         //Escrita
+    size_t tamanho;         //Bytes disponíveis (leitura) ou capacidade (escrita)
+    size_t posicao;
+    bool erro;
+} Cursor;
+
+static void campo_byte(Cursor *cursor, uint8_t *valor) {
+    if (cursor->erro || cursor->posicao >= cursor->tamanho) {
+        cursor->erro = true;
+        return;
+    }
+    if (cursor->saida) {
+        cursor->saida[cursor->posicao++] = *valor;
+    } else {
+        *valor = cursor->entrada[cursor->posicao++];
+    }
+}
+
+static void campo_varint(Cursor *cursor, uint32_t *valor) {
+    if (cursor->saida) {
+        uint32_t resto = *valor;
+        do {
+            uint8_t byte = (uint8_t)(resto & 0x7F);
+            resto >>= 7;
+            if (resto) {
+                byte |= 0x80;
+            }
+            campo_byte(cursor, &byte);
+        } while (resto && !cursor->erro);
+        return;
+    }
+    uint32_t lido = 0;
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        uint8_t byte = 0;
+        campo_byte(cursor, &byte);
+        lido |= (uint32_t)(byte & 0x7F) << deslocamento;
+        if (!(byte & 0x80) || cursor->erro) {
+            *valor = lido;
+            return;
+        }
+    }
+    cursor->erro = true;
+}
+
+static void campo_inteiro(Cursor *cursor, int32_t *valor) {
+    //Zigzag: valores pequenos de qualquer sinal ocupam um byte
+    uint32_t codificado = ((uint32_t)*valor << 1) ^ (uint32_t)(*valor >> 31);
+    campo_varint(cursor, &codificado);
+    *valor = (int32_t)(codificado >> 1) ^ -(int32_t)(codificado & 1);
+}
+
+static void campo_float(Cursor *cursor, float *valor) {
+    //Bits exatos: a reprodução precisa partir dos mesmos valores do firmware
+    uint32_t bits;
+    memcpy(&bits, valor, sizeof(bits));
+    for (int i = 0; i < 4; i++) {
+        uint8_t byte = (uint8_t)(bits >> (8 * i));
+        campo_byte(cursor, &byte);
+        bits = (bits & ~(0xFFu << (8 * i))) | ((uint32_t)byte << (8 * i));
+    }
+    memcpy(valor, &bits, sizeof(bits));
+}
+
+static void campo_bool(Cursor *cursor, bool *valor) {
+    uint8_t byte = *valor;
+    campo_byte(cursor, &byte);
+    *valor = byte != 0;
+}
+
+#define CAMPO_ENUM(cursor, campo) do { \
+        uint8_t valor_ = (uint8_t)(campo); \
+        campo_byte(cursor, &valor_); \
+        (campo) = valor_; \
+    } while (0)
+
+static void escrever_cabecalho(Cursor *cursor, uint8_t tipo, uint8_t detalhe) {
+    uint8_t cabecalho = (uint8_t)(tipo << 4 | (detalhe & 0x0F));
+    campo_byte(cursor, &cabecalho);
+}
+
+//Estado completo do passo, na mesma ordem para gravar e reproduzir
+static void campos_estado(Cursor *cursor, ControlePrincipal *controle, TabelaZonas *zonas, uint8_t *zona,
+                          uint32_t *tempo_ms) {
+    campo_varint(cursor, tempo_ms);
+    campo_byte(cursor, zona);
+    campo_byte(cursor, &zonas->quantidade);
+    campo_float(cursor, &zonas->limite_integral);
+    if (zonas->quantidade > ZONAS_MAX || *zona >= zonas->quantidade) {
+        cursor->erro = true;
+        return;
+    }
+
+    campo_float(cursor, &controle->temperatura_ambiente);
+    int32_t setpoint = controle->setpoint_temperatura;
+    campo_inteiro(cursor, &setpoint);
+    controle->setpoint_temperatura = setpoint;
+    campo_bool(cursor, &controle->modo_selecao);
+    campo_bool(cursor, &controle->sistema_ligado);
+    campo_bool(cursor, &controle->autotune_ativo);
+    campo_bool(cursor, &controle->ligado_anterior);
+    campo_float(cursor, &controle->ganho_kp);
+    campo_float(cursor, &controle->ganho_ki);
+    CAMPO_ENUM(cursor, controle->alarme);
+
+    Autotune *autotune = &controle->autotune;
+    campo_float(cursor, &autotune->setpoint);
+    campo_float(cursor, &autotune->histerese);
+    campo_float(cursor, &autotune->amplitude);
+    campo_float(cursor, &autotune->tempo_limite_s);
+    campo_byte(cursor, &autotune->ciclos_desejados);
+    CAMPO_ENUM(cursor, autotune->regra);
+    CAMPO_ENUM(cursor, autotune->estado);
+    campo_bool(cursor, &autotune->saida_alta);
+    campo_float(cursor, &autotune->tempo_s);
+    campo_float(cursor, &autotune->temperatura_max);
+    campo_float(cursor, &autotune->temperatura_min);
+    campo_float(cursor, &autotune->inicio_ciclo_s);
+    campo_byte(cursor, &autotune->ciclos);
+    campo_float(cursor, &autotune->soma_amplitudes);
+    campo_float(cursor, &autotune->soma_periodos);
+    campo_float(cursor, &autotune->ganho_critico);
+    campo_float(cursor, &autotune->periodo_critico_s);
+    campo_float(cursor, &autotune->kp);
+    campo_float(cursor, &autotune->ki);
+
+    AvaliadorResposta *avaliador = &controle->avaliador;
+    campo_bool(cursor, &avaliador->ativo);
+    campo_bool(cursor, &avaliador->concluido);
+    campo_float(cursor, &avaliador->setpoint);
+    campo_float(cursor, &avaliador->banda);
+    campo_float(cursor, &avaliador->janela_estavel_s);
+    campo_float(cursor, &avaliador->tempo_s);
+    campo_float(cursor, &avaliador->ultimo_fora_s);
+    campo_float(cursor, &avaliador->erro_inicial);
+    campo_float(cursor, &avaliador->sobressinal);
+    campo_float(cursor, &avaliador->tempo_acomodacao_s);
+
+    for (int i = 0; i < zonas->quantidade; i++) {
+        campo_bool(cursor, &zonas->leitura_recebida[i]);
+        campo_bool(cursor, &zonas->ligada[i]);
+        campo_bool(cursor, &zonas->saida_externa[i]);
+        campo_float(cursor, &zonas->temperatura[i]);
+        campo_float(cursor, &zonas->setpoint[i]);
+        campo_float(cursor, &zonas->kp[i]);
+        campo_float(cursor, &zonas->ki[i]);
+        campo_float(cursor, &zonas->integral[i]);
+        uint32_t ciclo = zonas->ciclo_pwm[i];
+        campo_varint(cursor, &ciclo);
+        zonas->ciclo_pwm[i] = (uint16_t)ciclo;
+    }
+}
+
+//Compara os bits: um NaN repetido não é uma mudança
+static bool mudou(float atual, float anterior) {
+    return memcmp(&atual, &anterior, sizeof(float)) != 0;
+}
+
+static Cursor cursor_gravador(GravadorRastro *gravador) {
+    return (Cursor){.saida = gravador->bloco, .tamanho = sizeof(gravador->bloco), .posicao = gravador->tamanho};
+}
+
+static bool concluir_bloco(GravadorRastro *gravador, const Cursor *cursor) {
+    if (!cursor->erro) {
+        gravador->tamanho = cursor->posicao;
+    }
+    gravador->excedido |= cursor->erro;
+    return !cursor->erro;
+}
+
+// Começa uma gravação
+void rastro_gravador_iniciar(GravadorRastro *gravador) {
+    gravador->iniciado = false;
+    gravador->passos = 0;
+    gravador->bytes = 0;
+    gravador->tamanho = 0;
+    gravador->excedido = false;
+}
+
+// Grava o estado ou as entradas alteradas e o passo
+bool rastro_gravar_entradas(GravadorRastro *gravador, const ControlePrincipal *controle, const TabelaZonas *zonas,
+                            int zona, uint32_t tempo_ms, float intervalo_s) {
+    gravador->tamanho = 0;
+    Cursor cursor = cursor_gravador(gravador);
+    ControlePrincipal *anterior = &gravador->controle;
+    TabelaZonas *zonas_anteriores = &gravador->zonas;
+
+    if (!gravador->iniciado) {
+        *anterior = *controle;
+        *zonas_anteriores = *zonas;
+        uint8_t principal = (uint8_t)zona;
+        escrever_cabecalho(&cursor, RASTRO_ESTADO, 0);
+        campos_estado(&cursor, anterior, zonas_anteriores, &principal, &tempo_ms);
+        gravador->iniciado = !cursor.erro;
+        gravador->tempo_ms = tempo_ms;
+    } else {
+        //Comandos, na ordem em que a reprodução deve aplicá-los: o modo vem depois da
+        //autossintonia porque iniciá-la também liga o sistema
+        if (mudou(zonas->limite_integral, zonas_anteriores->limite_integral)) {
+            float limite = zonas->limite_integral;
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_LIMITE);
+            campo_float(&cursor, &limite);
+        }
+        if (mudou(controle->ganho_kp, anterior->ganho_kp) || mudou(controle->ganho_ki, anterior->ganho_ki)) {
+            float kp = controle->ganho_kp, ki = controle->ganho_ki;
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_GANHOS);
+            campo_float(&cursor, &kp);
+            campo_float(&cursor, &ki);
+        }
+        if (controle->setpoint_temperatura != anterior->setpoint_temperatura) {
+            int32_t setpoint = controle->setpoint_temperatura;
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_SETPOINT);
+            campo_inteiro(&cursor, &setpoint);
+        }
+        for (int i = 0; i < zonas->quantidade; i++) {
+            //A zona principal é sincronizada pelo próprio passo a partir do controle
+            if (i == zona || (!mudou(zonas->setpoint[i], zonas_anteriores->setpoint[i]) &&
+                              !mudou(zonas->kp[i], zonas_anteriores->kp[i]) &&
+                              !mudou(zonas->ki[i], zonas_anteriores->ki[i]) &&
+                              zonas->ligada[i] == zonas_anteriores->ligada[i])) {
+                continue;
+            }
+            uint8_t indice = (uint8_t)i;
+            float setpoint = zonas->setpoint[i], kp = zonas->kp[i], ki = zonas->ki[i];
+            bool ligada = zonas->ligada[i];
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_ZONA);
+            campo_byte(&cursor, &indice);
+            campo_float(&cursor, &setpoint);
+            campo_float(&cursor, &kp);
+            campo_float(&cursor, &ki);
+            campo_bool(&cursor, &ligada);
+        }
+        if (controle->autotune_ativo && !anterior->autotune_ativo) {
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_AUTOTUNE);
+        }
+        if (controle->sistema_ligado != anterior->sistema_ligado || controle->modo_selecao != anterior->modo_selecao ||
+            (controle->autotune_ativo && !anterior->autotune_ativo)) {
+            uint8_t modo = (uint8_t)(controle->sistema_ligado | controle->modo_selecao << 1);
+            escrever_cabecalho(&cursor, RASTRO_COMANDO, RASTRO_COMANDO_MODO);
+            campo_byte(&cursor, &modo);
+        }
+
+        //Leituras dos sensores
+        for (int i = 0; i < zonas->quantidade; i++) {
+            if (zonas->leitura_recebida[i] != zonas_anteriores->leitura_recebida[i] ||
+                mudou(zonas->temperatura[i], zonas_anteriores->temperatura[i])) {
+                float temperatura = zonas->temperatura[i];
+                escrever_cabecalho(&cursor, RASTRO_LEITURA, (uint8_t)i);
+                campo_float(&cursor, &temperatura);
+            }
+        }
+        if (mudou(controle->temperatura_ambiente, anterior->temperatura_ambiente)) {
+            float temperatura = controle->temperatura_ambiente;
+            escrever_cabecalho(&cursor, RASTRO_LEITURA, RASTRO_AMBIENTE);
+            campo_float(&cursor, &temperatura);
+        }
+    }
+
+    uint32_t decorrido_ms = tempo_ms - gravador->tempo_ms;
+    escrever_cabecalho(&cursor, RASTRO_PASSO, 0);
+    campo_varint(&cursor, &decorrido_ms);
+    campo_float(&cursor, &intervalo_s);
+    gravador->tempo_ms = tempo_ms;
+    return concluir_bloco(gravador, &cursor);
+}
+
+// Grava as saídas alteradas pelo passo
+bool rastro_gravar_saidas(GravadorRastro *gravador, const ControlePrincipal *controle, const TabelaZonas *zonas) {
+    Cursor cursor = cursor_gravador(gravador);
+    for (int i = 0; i < zonas->quantidade; i++) {
+        if (zonas->ciclo_pwm[i] != gravador->zonas.ciclo_pwm[i]) {
+            uint32_t ciclo = zonas->ciclo_pwm[i];
+            escrever_cabecalho(&cursor, RASTRO_SAIDA, (uint8_t)i);
+            campo_varint(&cursor, &ciclo);
+        }
+    }
+    if (controle->alarme != gravador->controle.alarme) {
+        escrever_cabecalho(&cursor, RASTRO_ALARME, (uint8_t)controle->alarme);
+    }
+
+    //Próximo período grava só o que mudar a partir daqui
+    gravador->controle = *controle;
+    gravador->zonas = *zonas;
+    gravador->passos++;
+    bool cabe = concluir_bloco(gravador, &cursor);
+    gravador->bytes += gravador->tamanho;
+    return cabe;
+}
+
+// Prepara a reprodução de um rastro
+void rastro_reprodutor_iniciar(ReprodutorRastro *reprodutor, uint16_t tolerancia_pwm) {
+    memset(reprodutor, 0, sizeof(*reprodutor));
+    reprodutor->tolerancia_pwm = tolerancia_pwm;
+}
+
+static void comparar_passo(ReprodutorRastro *reprodutor) {
+    //As saídas gravadas de um passo chegam logo depois do PASSO
+    if (!reprodutor->passo_pendente) {
+        return;
+    }
+    reprodutor->passo_pendente = false;
+    bool divergiu = reprodutor->controle.alarme != reprodutor->alarme_gravado;
+    for (int i = 0; i < reprodutor->zonas.quantidade; i++) {
+        int diferenca = (int)reprodutor->zonas.ciclo_pwm[i] - (int)reprodutor->ciclo_gravado[i];
+        uint16_t absoluta = (uint16_t)(diferenca < 0 ? -diferenca : diferenca);
+        if (absoluta > reprodutor->maior_diferenca_pwm) {
+            reprodutor->maior_diferenca_pwm = absoluta;
+        }
+        divergiu |= absoluta > reprodutor->tolerancia_pwm;
+    }
+    if (divergiu && reprodutor->divergencias++ == 0) {
+        reprodutor->primeira_divergencia_ms = reprodutor->tempo_ms;
+    }
+}
+
+static void aplicar_comando(ReprodutorRastro *reprodutor, Cursor *cursor, uint8_t comando) {
+    ControlePrincipal *controle = &reprodutor->controle;
+    TabelaZonas *zonas = &reprodutor->zonas;
+    switch (comando) {
+    case RASTRO_COMANDO_SETPOINT: {
+        int32_t setpoint = 0;
+        campo_inteiro(cursor, &setpoint);
+        controle->setpoint_temperatura = setpoint;
+        break;
+    }
+    case RASTRO_COMANDO_MODO: {
+        uint8_t modo = 0;
+        campo_byte(cursor, &modo);
+        controle->sistema_ligado = modo & 1;
+        controle->modo_selecao = (modo >> 1) & 1;
+        break;
+    }
+    case RASTRO_COMANDO_AUTOTUNE:
+        passo_controle_iniciar_autotune(controle);
+        break;
+    case RASTRO_COMANDO_GANHOS:
+        campo_float(cursor, &controle->ganho_kp);
+        campo_float(cursor, &controle->ganho_ki);
+        break;
+    case RASTRO_COMANDO_ZONA: {
+        uint8_t indice = 0;
+        float setpoint = 0.0f, kp = 0.0f, ki = 0.0f;
+        bool ligada = false;
+        campo_byte(cursor, &indice);
+        campo_float(cursor, &setpoint);
+        campo_float(cursor, &kp);
+        campo_float(cursor, &ki);
+        campo_bool(cursor, &ligada);
+        if (indice >= zonas->quantidade) {
+            cursor->erro = true;
+            break;
+        }
+        zonas->setpoint[indice] = setpoint;
+        zonas->kp[indice] = kp;
+        zonas->ki[indice] = ki;
+        zonas->ligada[indice] = ligada;
+        break;
+    }
+    case RASTRO_COMANDO_LIMITE:
+        campo_float(cursor, &zonas->limite_integral);
+        break;
+    default:
+        cursor->erro = true;
+    }
+}
+
+// Reproduz um bloco de registros
+bool rastro_reproduzir(ReprodutorRastro *reprodutor, const uint8_t *dados, size_t tamanho) {
+    Cursor cursor = {.entrada = dados, .tamanho = tamanho};
+    while (!cursor.erro && cursor.posicao < cursor.tamanho) {
+        uint8_t cabecalho = 0;
+        campo_byte(&cursor, &cabecalho);
+        uint8_t tipo = cabecalho >> 4, detalhe = cabecalho & 0x0F;
+
+        if (tipo != RASTRO_SAIDA && tipo != RASTRO_ALARME) {
+            comparar_passo(reprodutor);
+        }
+        if (!reprodutor->iniciado && tipo != RASTRO_ESTADO) {
+            cursor.erro = true;
+            break;
+        }
+
+        switch (tipo) {
+        case RASTRO_ESTADO: {
+            //Uma nova gravação recomeça do estado completo
+            uint8_t zona = 0;
+            campos_estado(&cursor, &reprodutor->controle, &reprodutor->zonas, &zona, &reprodutor->tempo_ms);
+            reprodutor->zona = zona;
+            memcpy(reprodutor->ciclo_gravado, reprodutor->zonas.ciclo_pwm, sizeof(reprodutor->ciclo_gravado));
+            reprodutor->alarme_gravado = reprodutor->controle.alarme;
+            reprodutor->iniciado = !cursor.erro;
+            break;
+        }
+        case RASTRO_LEITURA: {
+            float temperatura = 0.0f;
+            campo_float(&cursor, &temperatura);
+            if (detalhe == RASTRO_AMBIENTE) {
+                reprodutor->controle.temperatura_ambiente = temperatura;
+            } else if (detalhe < reprodutor->zonas.quantidade) {
+                reprodutor->zonas.temperatura[detalhe] = temperatura;
+                reprodutor->zonas.leitura_recebida[detalhe] = true;
+            } else {
+                cursor.erro = true;
+            }
+            break;
+        }
+        case RASTRO_COMANDO:
+            aplicar_comando(reprodutor, &cursor, detalhe);
+            break;
+        case RASTRO_PASSO: {
+            uint32_t decorrido_ms = 0;
+            float intervalo_s = 0.0f;
+            campo_varint(&cursor, &decorrido_ms);
+            campo_float(&cursor, &intervalo_s);
+            if (cursor.erro) {
+                break;
+            }
+            reprodutor->tempo_ms += decorrido_ms;
+            passo_controle_executar(&reprodutor->controle, &reprodutor->zonas, reprodutor->zona, intervalo_s);
+            reprodutor->passo_pendente = true;
+            reprodutor->passos++;
+            break;
+        }
+        case RASTRO_SAIDA: {
+            uint32_t ciclo = 0;
+            campo_varint(&cursor, &ciclo);
+            if (detalhe >= reprodutor->zonas.quantidade || ciclo > UINT16_MAX) {
+                cursor.erro = true;
+                break;
+            }
+            reprodutor->ciclo_gravado[detalhe] = (uint16_t)ciclo;
+            break;
+        }
+        case RASTRO_ALARME:
+            if (detalhe > ALARME_CRITICO) {
+                cursor.erro = true;
+                break;
+            }
+            reprodutor->alarme_gravado = (NivelAlarme)detalhe;
+            break;
+        default:
+            cursor.erro = true;
+        }
+    }
+    reprodutor->erro |= cursor.erro;
+    return !cursor.erro;
+}
+
+// Compara o último passo
+void rastro_reprodutor_concluir(ReprodutorRastro *reprodutor) {
+    comparar_passo(reprodutor);
+}
@@ -0,0 +1,101 @@
+#ifndef RASTRO_H
+#define RASTRO_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "lib/Controle/passo_controle.h"
+#include "lib/Zonas/zonas.h"
+
+//Rastro determinístico do controle: entradas (leituras dos sensores e
+//comandos da interface local e da web) e saídas de cada período, num formato
+//binário compacto. A reprodução aplica as entradas ao mesmo
+//passo_controle_executar do firmware, tão rápido quanto possível, e compara o
+//PWM e o alarme calculados com os gravados.
+//
+//Cada registro começa por um byte tipo (4 bits altos) | detalhe (4 bits baixos):
+//  ESTADO   estado completo do passo (início da gravação)
+//  LEITURA  detalhe = zona (RASTRO_AMBIENTE: temperatura da zona principal); float
+//  COMANDO  detalhe = RASTRO_COMANDO_*; valores do comando
+//  PASSO    varint ms desde o passo anterior; float intervalo_s
+//  SAIDA    detalhe = zona; varint ciclo PWM
+//  ALARME   detalhe = nível
+//Leituras e comandos só aparecem quando mudam e valem para o PASSO seguinte;
+//saídas e alarme só aparecem quando o passo os altera. Inteiros são varints
+//(LEB128), floats vão com os bits exatos em little-endian
+
+#define RASTRO_ESTADO  0x0
+#define RASTRO_LEITURA 0x1
+#define RASTRO_COMANDO 0x2
+#define RASTRO_PASSO   0x3
+#define RASTRO_SAIDA   0x4
+#define RASTRO_ALARME  0x5
+
+#define RASTRO_AMBIENTE 0xF //Detalhe da LEITURA de temperatura_ambiente
+
+#define RASTRO_COMANDO_SETPOINT 0x0 //Varint zigzag
+#define RASTRO_COMANDO_MODO     0x1 //Byte: bit 0 ligado, bit 1 seleção
+#define RASTRO_COMANDO_AUTOTUNE 0x2 //Sem valor: passo_controle_iniciar_autotune
+#define RASTRO_COMANDO_GANHOS   0x3 //Floats kp e ki
+#define RASTRO_COMANDO_ZONA     0x4 //Byte zona; floats setpoint, kp e ki; byte ligada
+#define RASTRO_COMANDO_LIMITE   0x5 //Float limite_integral
+
+//Maior bloco de um período: estado completo, comandos de todas as zonas e saídas
+#define RASTRO_BLOCO_MAX 768
+
+//Lado do firmware: guarda o estado visto ao fim do passo anterior para gravar
+//apenas o que mudou. Só a task de controle usa o gravador
+typedef struct {
+    bool iniciado;              //ESTADO já gravado
+    ControlePrincipal controle; //Como ficou após o último passo gravado
+    TabelaZonas zonas;
+    uint32_t tempo_ms;          //Instante do último passo gravado
+    uint32_t passos;
+    uint32_t bytes;             //Total já gravado
+    uint8_t bloco[RASTRO_BLOCO_MAX]; //Registros do período atual
+    size_t tamanho;
+    bool excedido;              //Algum registro não coube no bloco
+} GravadorRastro;
+
+//Começa uma gravação: o próximo período grava o estado completo
+void rastro_gravador_iniciar(GravadorRastro *gravador);
+
+//Início do período, antes do passo: estado ou entradas alteradas e o PASSO.
+//Recomeça o bloco; retorna false se algum registro não coube
+bool rastro_gravar_entradas(GravadorRastro *gravador, const ControlePrincipal *controle, const TabelaZonas *zonas,
+                            int zona, uint32_t tempo_ms, float intervalo_s);
+
+//Fim do período, após o passo: saídas e alarme alterados. O bloco fica
+//pronto para ser enviado; retorna false se algum registro não coube
+bool rastro_gravar_saidas(GravadorRastro *gravador, const ControlePrincipal *controle, const TabelaZonas *zonas);
+
+//Lado da reprodução: o mesmo estado que o firmware mantém, reconstruído a partir
+//do rastro, e o resultado da comparação
+typedef struct {
+    ControlePrincipal controle;
+    TabelaZonas zonas;
+    int zona;
+    bool iniciado;           //ESTADO já recebido
+    bool passo_pendente;     //Passo executado aguardando as saídas gravadas
+    uint16_t ciclo_gravado[ZONAS_MAX];
+    NivelAlarme alarme_gravado;
+    uint32_t tempo_ms;       //Instante do último passo
+
+    uint32_t passos;
+    uint32_t divergencias;   //Passos com PWM ou alarme diferente do gravado
+    uint32_t primeira_divergencia_ms;
+    uint16_t maior_diferenca_pwm;
+    uint16_t tolerancia_pwm; //Diferença de PWM ainda aceita como igual
+    bool erro;               //Registro desconhecido, truncado ou anterior ao ESTADO
+} ReprodutorRastro;
+
+void rastro_reprodutor_iniciar(ReprodutorRastro *reprodutor, uint16_t tolerancia_pwm);
+
+//Reproduz um bloco de registros completos (um período do gravador, ou vários
+//concatenados); retorna false se o bloco estiver malformado
+bool rastro_reproduzir(ReprodutorRastro *reprodutor, const uint8_t *dados, size_t tamanho);
+
+//Compara o último passo reproduzido; chamar ao fim do rastro
+void rastro_reprodutor_concluir(ReprodutorRastro *reprodutor);
+
+#endif // RASTRO_H
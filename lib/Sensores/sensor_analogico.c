@@ -0,0 +1,99 @@
+#include "sensor_analogico.h"
+#include <math.h>
+#include <string.h>
+
+#define BITS_SAIDA      16 //12 bits do ADC mais 4 de superamostragem
+#define BITS_SEGMENTO   (BITS_SAIDA - 6) //log2(SENSOR_ANALOGICO_SEGMENTOS) bits indexam a tabela
+#define GANHO_CIC_BITS  2  //Ganho R^N = 2^2 com R = 2 e N = 2
+#define LIMITE_CENTESIMOS 30000
+
+static int16_t para_centesimos(float temperatura) {
+    float centesimos = temperatura * 100.0f;
+    if (!(centesimos < LIMITE_CENTESIMOS)) return LIMITE_CENTESIMOS; //Também cobre NaN e infinito
+    if (centesimos < -LIMITE_CENTESIMOS) return -LIMITE_CENTESIMOS;
+    return (int16_t)lroundf(centesimos);
+}
+
+//Fração do fundo de escala no limite k da tabela; as pontas ficam meio segmento
+//para dentro porque 0 e 1 não têm temperatura (curto e circuito aberto)
+static float fracao_do_limite(int k) {
+    float fracao = (float)k / SENSOR_ANALOGICO_SEGMENTOS;
+    const float margem = 0.5f / SENSOR_ANALOGICO_SEGMENTOS;
+    return fminf(fmaxf(fracao, margem), 1.0f - margem);
+}
+
+static void reiniciar_filtro(SensorAnalogico *sensor) {
+    memset(sensor->integradores, 0, sizeof(sensor->integradores));
+    memset(sensor->atrasos, 0, sizeof(sensor->atrasos));
+    sensor->fase = 0;
+    sensor->centesimos = SENSOR_ANALOGICO_INVALIDO;
+    sensor->amostras = 0;
+    sensor->amostras_lidas = 0;
+}
+
+void sensor_analogico_ntc(SensorAnalogico *sensor, const ParametrosNtc *parametros) {
+    reiniciar_filtro(sensor);
+    for (int k = 0; k <= SENSOR_ANALOGICO_SEGMENTOS; k++) {
+        float fracao = fracao_do_limite(k);
+        float resistencia = parametros->resistor_serie * fracao / (1.0f - fracao);
+        float ln_r = logf(resistencia);
+        float kelvin = 1.0f / (parametros->a + parametros->b * ln_r + parametros->c * ln_r * ln_r * ln_r);
+        sensor->tabela[k] = para_centesimos(kelvin - 273.15f);
+    }
+}
+
+void sensor_analogico_interno(SensorAnalogico *sensor) {
+    reiniciar_filtro(sensor);
+    for (int k = 0; k <= SENSOR_ANALOGICO_SEGMENTOS; k++) {
+        //Fórmula do datasheet do RP2040: 0,706 V a 27 °C e -1,721 mV/°C
+        float tensao = fracao_do_limite(k) * 3.3f;
+        sensor->tabela[k] = para_centesimos(27.0f - (tensao - 0.706f) / 0.001721f);
+    }
+}
+
+//Código de 16 bits para centésimos; o primeiro e o último segmento ficam de fora
+static int32_t linearizar(const SensorAnalogico *sensor, uint32_t codigo) {
+    uint32_t segmento = codigo >> BITS_SEGMENTO;
+    if (segmento == 0 || segmento >= SENSOR_ANALOGICO_SEGMENTOS - 1) {
+        return SENSOR_ANALOGICO_INVALIDO;
+    }
+    int32_t inicio = sensor->tabela[segmento];
+    int32_t fim = sensor->tabela[segmento + 1];
+    int32_t posicao = (int32_t)(codigo & ((1u << BITS_SEGMENTO) - 1));
+    return inicio + (((fim - inicio) * posicao) >> BITS_SEGMENTO);
+}
+
+void sensor_analogico_consumir(uint32_t soma, uint16_t quantidade, void *contexto) {
+    SensorAnalogico *sensor = (SensorAnalogico *)contexto;
+
+    //Média do bloco com 4 bits extras; entra nos integradores na taxa dos blocos
+    uint32_t media = ((soma << (BITS_SAIDA - 12)) + quantidade / 2) / quantidade;
+    sensor->integradores[0] += media;
+    sensor->integradores[1] += sensor->integradores[0];
+    if (++sensor->fase < SENSOR_ANALOGICO_DECIMACAO) {
+        return;
+    }
+    sensor->fase = 0;
+
+    //Pentes na taxa de saída
+    uint32_t pente1 = sensor->integradores[1] - sensor->atrasos[0];
+    sensor->atrasos[0] = sensor->integradores[1];
+    uint32_t pente2 = pente1 - sensor->atrasos[1];
+    sensor->atrasos[1] = pente1;
+
+    sensor->centesimos = linearizar(sensor, pente2 >> GANHO_CIC_BITS);
+    sensor->amostras++;
+}
+
+bool sensor_analogico_ler(SensorAnalogico *sensor, float *temperatura) {
+    uint32_t amostras = sensor->amostras;
+    int32_t centesimos = sensor->centesimos;
+    //A primeira saída ainda carrega o transitório do filtro
+    bool nova = amostras != sensor->amostras_lidas && amostras > 1;
+    sensor->amostras_lidas = amostras;
+    if (!nova || centesimos == SENSOR_ANALOGICO_INVALIDO) {
+        return false;
+    }
+    *temperatura = centesimos / 100.0f;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef SENSOR_ANALOGICO_H
+#define SENSOR_ANALOGICO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Temperatura de uma entrada analógica alimentada por lib/Entrada/aquisicao_adc.
+//Cada bloco do DMA já chega como soma das conversões da entrada (média por
+//superamostragem); um filtro CIC de ordem 2 decima essas médias por
+//SENSOR_ANALOGICO_DECIMACAO e a saída, com 4 bits além dos 12 do ADC, é
+//convertida em °C por uma tabela com interpolação linear montada na
+//inicialização (Steinhart–Hart para o NTC, reta para o sensor interno).
+//Com 16 kS/s em blocos de 64 saem 125 amostras filtradas por segundo, tudo
+//em inteiros dentro da interrupção do DMA
+
+#define SENSOR_ANALOGICO_DECIMACAO 2  //Blocos do DMA por amostra filtrada
+#define SENSOR_ANALOGICO_SEGMENTOS 64 //Segmentos da tabela de linearização
+#define SENSOR_ANALOGICO_INVALIDO  INT32_MIN
+
+//NTC no lado de baixo do divisor: 3V3 -> resistor_serie -> ADC -> NTC -> GND.
+//Coeficientes de Steinhart–Hart: 1/T = a + b ln(R) + c ln(R)^3, com T em kelvin
+typedef struct {
+    float resistor_serie; //Ohms
+    float a, b, c;
+} ParametrosNtc;
+
+//NTC genérico de 10 kΩ (B ≈ 3950) com resistor de 10 kΩ
+#define SENSOR_NTC_10K {10000.0f, 1.009249522e-3f, 2.378405444e-4f, 2.019202697e-7f}
+
+typedef struct {
+    int16_t tabela[SENSOR_ANALOGICO_SEGMENTOS + 1]; //Centésimos de grau nos limites de cada segmento
+
+    //Filtro CIC (aritmética modular: o estouro dos integradores se cancela nos pentes)
+    uint32_t integradores[2];
+    uint32_t atrasos[2];
+    uint8_t fase;
+
+    volatile int32_t centesimos;   //Última amostra filtrada ou SENSOR_ANALOGICO_INVALIDO
+    volatile uint32_t amostras;    //Amostras filtradas produzidas
+    uint32_t amostras_lidas;       //Valor de 'amostras' na última leitura
+} SensorAnalogico;
+
+//Monta a tabela de um NTC
+void sensor_analogico_ntc(SensorAnalogico *sensor, const ParametrosNtc *parametros);
+
+//Monta a tabela do sensor interno do RP2040 (ADC4)
+void sensor_analogico_interno(SensorAnalogico *sensor);
+
+//Consumidor para aquisicao_adc_registrar (contexto: o SensorAnalogico)
+void sensor_analogico_consumir(uint32_t soma, uint16_t quantidade, void *contexto);
+
+//Última temperatura filtrada (°C); false se não houve amostra nova desde a leitura
+//anterior ou se o código está fora da faixa útil (NTC aberto ou em curto)
+bool sensor_analogico_ler(SensorAnalogico *sensor, float *temperatura);
+
+#endif // SENSOR_ANALOGICO_H
@@ -0,0 +1,49 @@
+#include "malha_simulada.h"
+#include <math.h>
+#include <stdio.h>
+#include "lib/Controle/controle_pi.h"
+#include "lib/Controle/autotune.h"
+
+void malha_simulada_executar(const ParametrosPlanta *parametros, const EnsaioMalha *ensaio,
+                             ResultadoMalha *resultado, ObservadorMalha observador, void *contexto) {
+    PlantaTermica planta;
+    planta_inicializar(&planta, parametros, ensaio->intervalo_s, ensaio->semente);
+
+    AvaliadorResposta avaliador;
+    avaliador_iniciar(&avaliador, ensaio->setpoint, planta_medir(&planta), ensaio->banda, ensaio->janela_estavel_s);
+
+    *resultado = (ResultadoMalha){0};
+    float integral = 0.0f;
+    uint32_t passos = (uint32_t)(ensaio->duracao_s / ensaio->intervalo_s);
+
+    for (uint32_t i = 0; i < passos; i++) {
+        //Mesma sequência do firmware: leitura, passo do PI, avaliação e saída
+        float medida = planta_medir(&planta);
+        float sinal = controle_pi_calcular(&integral, ensaio->kp, ensaio->ki, ensaio->limite_integral,
+                                           medida - ensaio->setpoint, ensaio->intervalo_s);
+        uint16_t ciclo = controle_pi_sinal_para_pwm(sinal);
+        avaliador_passo(&avaliador, medida, ensaio->intervalo_s);
+
+        float erro = planta.temperatura - ensaio->setpoint;
+        resultado->iae += fabsf(erro) * ensaio->intervalo_s;
+        resultado->ise += erro * erro * ensaio->intervalo_s;
+        if (observador) {
+            observador(planta.tempo_s, medida, planta.temperatura, ciclo, contexto);
+        }
+        planta_avancar(&planta, ciclo);
+    }
+
+    resultado->passos = passos;
+    resultado->sobressinal = avaliador.sobressinal;
+    resultado->acomodou = avaliador.concluido;
+    resultado->tempo_acomodacao_s = avaliador.tempo_acomodacao_s;
+    resultado->temperatura_final = planta.temperatura;
+}
+
+int malha_simulada_json(const ResultadoMalha *resultado, char *buffer, size_t tamanho) {
+    return snprintf(buffer, tamanho,
+                    "{\"passos\":%lu,\"iae\":%.2f,\"ise\":%.2f,\"sobressinal\":%.2f,\"acomodou\":%s,"
+                    "\"tempo_acomodacao_s\":%.0f,\"temperatura_final\":%.2f}",
+                    (unsigned long)resultado->passos, resultado->iae, resultado->ise, resultado->sobressinal,
+                    resultado->acomodou ? "true" : "false", resultado->tempo_acomodacao_s, resultado->temperatura_final);
+}
@@ -0,0 +1,45 @@
+#ifndef MALHA_SIMULADA_H
+#define MALHA_SIMULADA_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdbool.h>
+#include "planta_termica.h"
+
+//Malha fechada do PI da tabela de zonas (controle_pi_calcular e
+//controle_pi_sinal_para_pwm) contra a planta simulada, sem esperar o tempo
+//real: cada período do controle é um passo de cálculo. Acomodação e
+//sobressinal vêm do mesmo AvaliadorResposta do firmware; IAE e ISE integram
+//o erro da temperatura real (sem ruído) durante todo o ensaio
+
+typedef struct {
+    float kp, ki, limite_integral;
+    float setpoint;
+    float intervalo_s;       //Período do controle (1 s no firmware)
+    float duracao_s;
+    float banda;             //Critério de acomodação do avaliador (°C)
+    float janela_estavel_s;
+    uint32_t semente;        //Ruído reprodutível
+} EnsaioMalha;
+
+typedef struct {
+    uint32_t passos;
+    float iae;               //∫|erro| dt (°C·s)
+    float ise;               //∫erro² dt (°C²·s)
+    float sobressinal;       //°C
+    float tempo_acomodacao_s;
+    bool acomodou;
+    float temperatura_final;
+} ResultadoMalha;
+
+//Chamado a cada passo (ex.: para gravar a curva); pode ser NULL
+typedef void (*ObservadorMalha)(float tempo_s, float medida, float temperatura, uint16_t ciclo_pwm, void *contexto);
+
+//Executa o ensaio a partir da planta em equilíbrio com a saída em zero
+void malha_simulada_executar(const ParametrosPlanta *parametros, const EnsaioMalha *ensaio,
+                             ResultadoMalha *resultado, ObservadorMalha observador, void *contexto);
+
+//Serializa o resultado como objeto JSON; retorna o número de caracteres escritos
+int malha_simulada_json(const ResultadoMalha *resultado, char *buffer, size_t tamanho);
+
+#endif // MALHA_SIMULADA_H
@@ -0,0 +1,75 @@
+#include "planta_termica.h"
+#include <math.h>
+#include <string.h>
+
+#define PI_F 3.14159265f
+
+void planta_inicializar(PlantaTermica *planta, const ParametrosPlanta *parametros, float passo_s, uint32_t semente) {
+    memset(planta, 0, sizeof(*planta));
+    planta->parametros = *parametros;
+    planta->passo_s = passo_s;
+    planta->decaimento = expf(-passo_s / parametros->constante_tempo_s);
+    planta->temperatura = parametros->ambiente_c;
+
+    int atraso = (int)lroundf(parametros->atraso_s / passo_s);
+    planta->atraso_passos = (uint8_t)(atraso < 0 ? 0 : (atraso >= PLANTA_ATRASO_MAX ? PLANTA_ATRASO_MAX - 1 : atraso));
+
+    planta->cosseno = 1.0f;
+    if (parametros->periodo_perturbacao_s > 0.0f) {
+        float angulo = 2.0f * PI_F * passo_s / parametros->periodo_perturbacao_s;
+        planta->giro_seno = sinf(angulo);
+        planta->giro_cosseno = cosf(angulo);
+    } else {
+        planta->giro_cosseno = 1.0f;
+    }
+    planta->semente = semente ? semente : 1;
+}
+
+void planta_avancar(PlantaTermica *planta, uint16_t ciclo_pwm) {
+    //Tempo morto: a saída aplicada agora só age daqui a atraso_passos
+    planta->saidas[planta->posicao] = ciclo_pwm;
+    uint16_t atrasada = planta->saidas[(planta->posicao + PLANTA_ATRASO_MAX - planta->atraso_passos) % PLANTA_ATRASO_MAX];
+    planta->posicao = (planta->posicao + 1) % PLANTA_ATRASO_MAX;
+
+    const ParametrosPlanta *p = &planta->parametros;
+    float equilibrio = p->ambiente_c + p->perturbacao_c * planta->seno + p->ganho_c * (atrasada / 65535.0f);
+    planta->temperatura = equilibrio + (planta->temperatura - equilibrio) * planta->decaimento;
+    planta->tempo_s += planta->passo_s;
+
+    float seno = planta->seno * planta->giro_cosseno + planta->cosseno * planta->giro_seno;
+    planta->cosseno = planta->cosseno * planta->giro_cosseno - planta->seno * planta->giro_seno;
+    planta->seno = seno;
+    //Corrige o módulo (aproximação de primeira ordem de 1/|z|) para o fasor não derivar em ensaios longos
+    float correcao = 1.5f - 0.5f * (planta->seno * planta->seno + planta->cosseno * planta->cosseno);
+    planta->seno *= correcao;
+    planta->cosseno *= correcao;
+}
+
+void planta_avancar_ate(PlantaTermica *planta, float tempo_s, uint16_t ciclo_pwm) {
+    while (planta->tempo_s + planta->passo_s <= tempo_s) {
+        planta_avancar(planta, ciclo_pwm);
+    }
+}
+
+static float uniforme(PlantaTermica *planta) {
+    uint32_t x = planta->semente;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    planta->semente = x;
+    return (x >> 8) * (1.0f / 16777216.0f);
+}
+
+float planta_medir(PlantaTermica *planta) {
+    const ParametrosPlanta *p = &planta->parametros;
+    float medida = planta->temperatura;
+    if (p->ruido_c > 0.0f) {
+        //Soma de quatro uniformes: aproximadamente gaussiano, desvio padrão 1 após a escala
+        float soma = uniforme(planta) + uniforme(planta) + uniforme(planta) + uniforme(planta);
+        medida += (soma - 2.0f) * 1.7320508f * p->ruido_c;
+    }
+    if (p->resolucao_c > 0.0f) {
+        medida = roundf(medida / p->resolucao_c) * p->resolucao_c;
+    }
+    return medida;
+}
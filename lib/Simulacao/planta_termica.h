@@ -0,0 +1,59 @@
+#ifndef PLANTA_TERMICA_H
+#define PLANTA_TERMICA_H
+
+#include <stdint.h>
+
+//Modelo térmico de primeira ordem com tempo morto (FOPDT) acionado pelo ciclo
+//PWM: a temperatura tende a ambiente + ganho * saída com a constante de tempo
+//dada, e a saída só chega à planta depois do atraso. O ambiente oscila
+//lentamente (perturbação) e a medida recebe ruído e a quantização do sensor.
+//A discretização é exata para saída constante no passo (segurador de ordem
+//zero), então o passo pode ser o próprio período do controle
+
+#define PLANTA_ATRASO_MAX 64 //Passos de tempo morto guardados
+
+typedef struct {
+    float ambiente_c;            //Temperatura de equilíbrio com a saída em zero
+    float ganho_c;               //Variação em regime com a saída em 100% (negativa: resfriamento)
+    float constante_tempo_s;
+    float atraso_s;              //Tempo morto (até PLANTA_ATRASO_MAX passos)
+    float ruido_c;               //Desvio padrão do ruído de medição
+    float perturbacao_c;         //Amplitude da oscilação do ambiente
+    float periodo_perturbacao_s;
+    float resolucao_c;           //Quantização da medida (0: contínua, 1: DHT11)
+} ParametrosPlanta;
+
+//Ventilador resfriando um ambiente a 32 °C: 16 °C a 100%, 90 s de constante e 8 s de atraso
+#define PLANTA_PADRAO {32.0f, -16.0f, 90.0f, 8.0f, 0.05f, 0.5f, 1800.0f, 0.0f}
+
+typedef struct {
+    ParametrosPlanta parametros;
+    float passo_s;
+    float decaimento;             //exp(-passo / constante de tempo)
+    float temperatura;            //Temperatura real (sem ruído)
+    float tempo_s;
+
+    uint16_t saidas[PLANTA_ATRASO_MAX]; //Anel do tempo morto
+    uint8_t atraso_passos;
+    uint8_t posicao;
+
+    //Perturbação como fasor girado a cada passo (sem seno por passo)
+    float seno, cosseno;
+    float giro_seno, giro_cosseno;
+
+    uint32_t semente;             //Gerador do ruído (xorshift32)
+} PlantaTermica;
+
+//Prepara a planta em equilíbrio com a saída em zero
+void planta_inicializar(PlantaTermica *planta, const ParametrosPlanta *parametros, float passo_s, uint32_t semente);
+
+//Avança um passo com o ciclo de trabalho aplicado (0 a 65535)
+void planta_avancar(PlantaTermica *planta, uint16_t ciclo_pwm);
+
+//Avança quantos passos couberem até o instante indicado
+void planta_avancar_ate(PlantaTermica *planta, float tempo_s, uint16_t ciclo_pwm);
+
+//Leitura do sensor: temperatura real mais ruído e quantização
+float planta_medir(PlantaTermica *planta);
+
+#endif // PLANTA_TERMICA_H
@@ -0,0 +1,67 @@
+#include "cache_respostas.h"
+#include <stdio.h>
+#include <string.h>
+#include "pagina_web.h"
+
+void cache_resposta_iniciar(RespostaCache *cache, const char *tipo_conteudo, MontarCorpo montar,
+                            char *buffers, size_t capacidade) {
+    memset(cache, 0, sizeof(*cache));
+    cache->tipo_conteudo = tipo_conteudo;
+    cache->montar = montar;
+    cache->capacidade = capacidade;
+    for (int i = 0; i < CACHE_RESPOSTA_COPIAS; i++) {
+        cache->copias[i].buffer = buffers + i * capacidade;
+    }
+}
+
+static void montar_copia(RespostaCache *cache, CopiaResposta *copia, uint32_t versao) {
+    //O corpo vai logo após o espaço reservado e o cabeçalho é encostado nele,
+    //formando uma resposta contígua sem mover o corpo
+    char *corpo = copia->buffer + CACHE_RESPOSTA_CABECALHO;
+    int tamanho_corpo = cache->montar(corpo, cache->capacidade - CACHE_RESPOSTA_CABECALHO);
+    char cabecalho[CACHE_RESPOSTA_CABECALHO];
+    int tamanho_cabecalho = pagina_web_cabecalho(cabecalho, sizeof(cabecalho), "200 OK", cache->tipo_conteudo,
+                                                 tamanho_corpo);
+    memcpy(corpo - tamanho_cabecalho, cabecalho, tamanho_cabecalho);
+    copia->dados = corpo - tamanho_cabecalho;
+    copia->tamanho = (uint16_t)(tamanho_cabecalho + tamanho_corpo);
+    copia->versao = versao;
+    copia->valida = true;
+    cache->montagens++;
+}
+
+// Entrega a cópia da versão
+CopiaResposta *cache_resposta_obter(RespostaCache *cache, uint32_t versao) {
+    CopiaResposta *livre = NULL;
+    for (int i = 0; i < CACHE_RESPOSTA_COPIAS; i++) {
+        CopiaResposta *copia = &cache->copias[i];
+        if (copia->valida && copia->versao == versao) {
+            copia->referencias++;
+            cache->entregas++;
+            return copia;
+        }
+        //Prefere uma cópia vazia ou a de versão mais antiga
+        if (!copia->referencias && (!livre || !copia->valida || (livre->valida && copia->versao < livre->versao))) {
+            livre = copia;
+        }
+    }
+    if (!livre) {
+        cache->esgotadas++;
+        return NULL;
+    }
+    montar_copia(cache, livre, versao);
+    livre->referencias = 1;
+    cache->entregas++;
+    return livre;
+}
+
+void cache_resposta_liberar(CopiaResposta *copia) {
+    if (copia->referencias) {
+        copia->referencias--;
+    }
+}
+
+int cache_resposta_json(const RespostaCache *cache, char *buffer, size_t tamanho) {
+    return snprintf(buffer, tamanho, "{\"entregas\":%lu,\"montagens\":%lu,\"esgotadas\":%lu}",
+                    (unsigned long)cache->entregas, (unsigned long)cache->montagens, (unsigned long)cache->esgotadas);
+}
@@ -0,0 +1,54 @@
+#ifndef CACHE_RESPOSTAS_H
+#define CACHE_RESPOSTAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//Respostas HTTP completas (cabeçalho e corpo) montadas uma vez por versão do
+//estado e entregues a todos os clientes pelo mesmo buffer: o lwIP envia por
+//referência (tcp_write sem cópia), então uma cópia fica imutável enquanto
+//houver envio em andamento apontando para ela. Com duas cópias por resposta a
+//versão nova é montada na livre enquanto a antiga termina de sair
+
+#define CACHE_RESPOSTA_COPIAS    2
+#define CACHE_RESPOSTA_CABECALHO 128 //Espaço reservado para o cabeçalho antes do corpo
+
+//Monta o corpo; retorna o tamanho (truncado em 'tamanho' - 1)
+typedef int (*MontarCorpo)(char *corpo, size_t tamanho);
+
+typedef struct {
+    char *buffer;
+    const char *dados;     //Início da resposta pronta dentro do buffer
+    uint16_t tamanho;      //Cabeçalho + corpo
+    uint32_t versao;
+    bool valida;
+    uint8_t referencias;   //Envios que ainda apontam para os dados
+} CopiaResposta;
+
+typedef struct {
+    const char *tipo_conteudo;
+    MontarCorpo montar;
+    size_t capacidade;     //Bytes de cada buffer
+    CopiaResposta copias[CACHE_RESPOSTA_COPIAS];
+
+    uint32_t entregas;     //Respostas servidas do cache (incluindo a que montou)
+    uint32_t montagens;
+    uint32_t esgotadas;    //Versão nova sem cópia livre: todas presas em envios
+} RespostaCache;
+
+//Associa a resposta aos buffers (CACHE_RESPOSTA_COPIAS x capacidade bytes)
+void cache_resposta_iniciar(RespostaCache *cache, const char *tipo_conteudo, MontarCorpo montar,
+                            char *buffers, size_t capacidade);
+
+//Entrega a cópia da versão pedida, montando-a se preciso, com uma referência
+//adquirida. Retorna NULL se a versão não existe e as cópias estão todas em uso
+CopiaResposta *cache_resposta_obter(RespostaCache *cache, uint32_t versao);
+
+//Solta a referência quando o envio termina (dados confirmados ou conexão abortada)
+void cache_resposta_liberar(CopiaResposta *copia);
+
+//Contadores como objeto JSON; retorna o número de caracteres escritos
+int cache_resposta_json(const RespostaCache *cache, char *buffer, size_t tamanho);
+
+#endif // CACHE_RESPOSTAS_H
@@ -0,0 +1,347 @@
+#include "escritor_http.h"
+#include <stdio.h>
+#include <string.h>
+#include "lwip/stats.h"
+#include "pagina_web.h"
+
+#define CHUNK_PREFIXO 6 //Tamanho em 4 dígitos hexadecimais (zeros à esquerda são válidos) e CRLF
+#define CHUNK_SUFIXO  2
+#define CHUNK_FINAL   "0\r\n\r\n"
+
+typedef struct {
+    struct tcp_pcb *pcb;       //NULL: livre
+    const char *dados;         //Referência: próximo byte a escrever
+    uint32_t restantes;        //Referência: bytes ainda não escritos
+    GeradorCorpo gerar;
+    char *bloco;               //Gerador: bloco copiado para o TCP aos poucos
+    uint16_t inicio_bloco;     //Bytes do bloco já escritos
+    uint16_t fim_bloco;
+    bool corpo_terminado;      //Gerador: o chunk final já está no bloco
+    uint32_t nao_confirmados;
+    uint8_t esperas;           //Intervalos do tcp_poll sem confirmação
+    FimResposta fim;
+    void *contexto;
+} Escritor;
+
+static Escritor escritores[ESCRITOR_CONEXOES];
+static char blocos[ESCRITOR_GERADORES][ESCRITOR_BLOCO];
+static bool bloco_em_uso[ESCRITOR_GERADORES];
+static MetricasEscritor metricas;
+
+static const char RESPOSTA_OCUPADO[] =
+    "HTTP/1.1 503 Service Unavailable\r\n"
+    "Content-Type: application/json\r\n"
+    "Content-Length: 27\r\n"
+    "Retry-After: 1\r\n"
+    "Connection: close\r\n\r\n"
+    "{\"erro\":\"servidor ocupado\"}";
+
+static bool heap_esgotado(void) {
+#if MEM_STATS
+    return MEM_SIZE - lwip_stats.mem.used < ESCRITOR_HEAP_MINIMO;
+#else
+    return false;
+#endif
+}
+
+// Fecha a conexão
+static err_t fechar(struct tcp_pcb *pcb) {
+    if (tcp_close(pcb) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    return ERR_OK;
+}
+
+err_t escritor_http_recusar(struct tcp_pcb *pcb) {
+    metricas.recusadas++;
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    //Constante: enviada por referência, sem alocar do heap que pode ser o que faltou
+    if (tcp_write(pcb, RESPOSTA_OCUPADO, sizeof(RESPOSTA_OCUPADO) - 1, 0) != ERR_OK) {
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    tcp_output(pcb);
+    return fechar(pcb) == ERR_OK ? ERR_MEM : ERR_ABRT;
+}
+
+// Solta o escritor e avisa o dono do contexto
+static void liberar(Escritor *escritor, bool concluida) {
+    if (escritor->bloco) {
+        bloco_em_uso[(escritor->bloco - blocos[0]) / ESCRITOR_BLOCO] = false;
+    }
+    FimResposta fim = escritor->fim;
+    void *contexto = escritor->contexto;
+    memset(escritor, 0, sizeof(*escritor));
+    if (concluida) {
+        metricas.concluidas++;
+    } else {
+        metricas.abortadas++;
+    }
+    if (fim) {
+        fim(contexto, concluida);
+    }
+}
+
+static void desligar_callbacks(struct tcp_pcb *pcb) {
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    tcp_sent(pcb, NULL);
+    tcp_err(pcb, NULL);
+    tcp_poll(pcb, NULL, 0);
+}
+
+static void abortar(Escritor *escritor) {
+    //Descarta os segmentos na fila, que podem apontar para os dados por referência
+    struct tcp_pcb *pcb = escritor->pcb;
+    desligar_callbacks(pcb);
+    liberar(escritor, false);
+    tcp_abort(pcb);
+}
+
+static void preencher_bloco(Escritor *escritor) {
+    //Um chunk por bloco; o gerador escreve direto depois do prefixo
+    char *bloco = escritor->bloco;
+    size_t tamanho = escritor->gerar(escritor->contexto, bloco + CHUNK_PREFIXO,
+                                     ESCRITOR_BLOCO - CHUNK_PREFIXO - CHUNK_SUFIXO);
+    if (!tamanho) {
+        memcpy(bloco, CHUNK_FINAL, sizeof(CHUNK_FINAL) - 1);
+        escritor->fim_bloco = sizeof(CHUNK_FINAL) - 1;
+        escritor->corpo_terminado = true;
+    } else {
+        static const char HEX[] = "0123456789ABCDEF";
+        for (int i = 0; i < 4; i++) {
+            bloco[i] = HEX[(tamanho >> (12 - 4 * i)) & 0xF];
+        }
+        memcpy(bloco + 4, "\r\n", 2);
+        memcpy(bloco + CHUNK_PREFIXO + tamanho, "\r\n", 2);
+        escritor->fim_bloco = (uint16_t)(CHUNK_PREFIXO + tamanho + CHUNK_SUFIXO);
+    }
+    escritor->inicio_bloco = 0;
+}
+
+static bool terminou_de_escrever(const Escritor *escritor) {
+    if (escritor->gerar) {
+        return escritor->corpo_terminado && escritor->inicio_bloco == escritor->fim_bloco;
+    }
+    return !escritor->restantes;
+}
+
+// Escreve o que couber
+static err_t continuar(Escritor *escritor) {
+    struct tcp_pcb *pcb = escritor->pcb;
+    bool escreveu = false;
+    while (!terminou_de_escrever(escritor)) {
+        if (escritor->gerar && escritor->inicio_bloco == escritor->fim_bloco) {
+            preencher_bloco(escritor);
+        }
+        const char *dados;
+        uint32_t disponiveis;
+        uint8_t opcoes;
+        if (escritor->gerar) {
+            dados = escritor->bloco + escritor->inicio_bloco;
+            disponiveis = escritor->fim_bloco - escritor->inicio_bloco;
+            opcoes = TCP_WRITE_FLAG_COPY; //O bloco é reaproveitado logo em seguida
+        } else {
+            dados = escritor->dados;
+            disponiveis = escritor->restantes;
+            opcoes = 0;
+        }
+
+        //Sem espaço no buffer ou na fila de segmentos: o próximo ACK chama de novo
+        uint16_t espaco = tcp_sndbuf(pcb);
+        if (!espaco || tcp_sndqueuelen(pcb) >= TCP_SND_QUEUELEN - 1) {
+            metricas.esperas++;
+            break;
+        }
+        uint16_t parte = (uint16_t)LWIP_MIN(disponiveis, espaco);
+        if (parte < disponiveis || (escritor->gerar && !escritor->corpo_terminado)) {
+            opcoes |= TCP_WRITE_FLAG_MORE;
+        }
+        err_t erro = tcp_write(pcb, dados, parte, opcoes);
+        if (erro == ERR_MEM) {
+            //Heap ou pools cheios: tenta de novo no próximo ACK ou no tcp_poll
+            metricas.esperas++;
+            break;
+        }
+        if (erro != ERR_OK) {
+            abortar(escritor);
+            return ERR_ABRT;
+        }
+        if (escritor->gerar) {
+            escritor->inicio_bloco += parte;
+        } else {
+            escritor->dados += parte;
+            escritor->restantes -= parte;
+        }
+        escritor->nao_confirmados += parte;
+        metricas.bytes += parte;
+        escreveu = true;
+    }
+    if (escreveu) {
+        tcp_output(pcb);
+    }
+
+    //Fecha só com tudo confirmado: os dados por referência precisam ficar válidos até lá
+    if (terminou_de_escrever(escritor) && !escritor->nao_confirmados) {
+        desligar_callbacks(pcb);
+        liberar(escritor, true);
+        return fechar(pcb);
+    }
+    return ERR_OK;
+}
+
+static err_t callback_envio(void *arg, struct tcp_pcb *pcb, uint16_t len) {
+    Escritor *escritor = arg;
+    escritor->nao_confirmados -= LWIP_MIN(len, escritor->nao_confirmados);
+    escritor->esperas = 0;
+    return continuar(escritor);
+}
+
+static err_t callback_espera(void *arg, struct tcp_pcb *pcb) {
+    //Sem ACK desde o último intervalo: tenta escrever de novo (ERR_MEM) ou desiste do cliente
+    Escritor *escritor = arg;
+    if (++escritor->esperas > ESCRITOR_ESPERAS_MAX) {
+        abortar(escritor);
+        return ERR_ABRT;
+    }
+    return continuar(escritor);
+}
+
+static void callback_erro(void *arg, err_t err) {
+    //O lwIP já liberou o pcb
+    if (arg) {
+        liberar(arg, false);
+    }
+}
+
+static err_t callback_recepcao(void *arg, struct tcp_pcb *pcb, struct pbuf *p, err_t err) {
+    //Dados extras durante o envio são descartados. O FIN do cliente só fecha o lado dele
+    //(shutdown(SHUT_WR), nc -N, proxies): a resposta continua e a conexão fecha no fim.
+    //Se o cliente fechou de vez, o RST dele chega por callback_erro; se parou de
+    //confirmar, o limite de ESCRITOR_ESPERAS_MAX aborta
+    if (p) {
+        tcp_recved(pcb, p->tot_len);
+        pbuf_free(p);
+    }
+    return ERR_OK;
+}
+
+static Escritor *reservar(struct tcp_pcb *pcb, bool com_bloco) {
+    if (heap_esgotado()) {
+        return NULL;
+    }
+    Escritor *escritor = NULL;
+    int em_uso = 0;
+    for (int i = 0; i < ESCRITOR_CONEXOES; i++) {
+        if (escritores[i].pcb) {
+            em_uso++;
+        } else if (!escritor) {
+            escritor = &escritores[i];
+        }
+    }
+    if (!escritor) {
+        return NULL;
+    }
+    if (com_bloco) {
+        for (int i = 0; i < ESCRITOR_GERADORES && !escritor->bloco; i++) {
+            if (!bloco_em_uso[i]) {
+                bloco_em_uso[i] = true;
+                escritor->bloco = blocos[i];
+            }
+        }
+        if (!escritor->bloco) {
+            return NULL;
+        }
+    }
+    if (em_uso + 1 > metricas.em_uso_max) {
+        metricas.em_uso_max = (uint8_t)(em_uso + 1);
+    }
+    escritor->pcb = pcb;
+    metricas.respostas++;
+    return escritor;
+}
+
+static err_t iniciar(Escritor *escritor, FimResposta fim, void *contexto) {
+    struct tcp_pcb *pcb = escritor->pcb;
+    escritor->contexto = contexto;
+    tcp_arg(pcb, escritor);
+    tcp_recv(pcb, callback_recepcao);
+    tcp_sent(pcb, callback_envio);
+    tcp_err(pcb, callback_erro);
+    tcp_poll(pcb, callback_espera, 4);
+    //'fim' só é registrado depois da primeira escrita: se ela abortar, o contexto continua com quem chamou
+    if (continuar(escritor) != ERR_OK) {
+        return ERR_ABRT;
+    }
+    escritor->fim = fim;
+    return ERR_OK;
+}
+
+// Envia por referência
+err_t escritor_http_referencia(struct tcp_pcb *pcb, const char *dados, uint32_t tamanho, FimResposta fim, void *contexto) {
+    Escritor *escritor = reservar(pcb, false);
+    if (!escritor) {
+        return escritor_http_recusar(pcb);
+    }
+    escritor->dados = dados;
+    escritor->restantes = tamanho;
+    return iniciar(escritor, fim, contexto);
+}
+
+// Envia o corpo do gerador
+err_t escritor_http_gerador(struct tcp_pcb *pcb, const char *tipo_conteudo, GeradorCorpo gerar,
+                            FimResposta fim, void *contexto) {
+    Escritor *escritor = reservar(pcb, true);
+    if (!escritor) {
+        return escritor_http_recusar(pcb);
+    }
+    //O cabeçalho ocupa o primeiro bloco; o primeiro chunk vem quando ele sair
+    int tamanho = snprintf(escritor->bloco, ESCRITOR_BLOCO,
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: %s\r\n"
+        "Transfer-Encoding: chunked\r\n"
+        "Connection: close\r\n\r\n", tipo_conteudo);
+    escritor->gerar = gerar;
+    escritor->inicio_bloco = 0;
+    escritor->fim_bloco = (uint16_t)LWIP_MIN(tamanho, ESCRITOR_BLOCO - 1);
+    return iniciar(escritor, fim, contexto);
+}
+
+// Copia a resposta
+err_t escritor_http_copia(struct tcp_pcb *pcb, const char *status, const char *tipo_conteudo,
+                          const char *adicionais, const char *corpo, int tamanho_corpo) {
+    char cabecalho[192];
+    int tamanho_cabecalho = pagina_web_cabecalho_adicional(cabecalho, sizeof(cabecalho), status, tipo_conteudo,
+                                                           adicionais, tamanho_corpo);
+    //O buffer de uma conexão nova vale pelo menos TCP_SND_BUF; o que não couber nele vai por referência ou gerador
+    if (heap_esgotado() || tamanho_cabecalho + tamanho_corpo > tcp_sndbuf(pcb) ||
+        tcp_sndqueuelen(pcb) + 2 >= TCP_SND_QUEUELEN) {
+        return escritor_http_recusar(pcb);
+    }
+    if (tcp_write(pcb, cabecalho, tamanho_cabecalho, TCP_WRITE_FLAG_COPY | (tamanho_corpo ? TCP_WRITE_FLAG_MORE : 0)) != ERR_OK ||
+        (tamanho_corpo && tcp_write(pcb, corpo, tamanho_corpo, TCP_WRITE_FLAG_COPY) != ERR_OK)) {
+        //O heap acabou entre a verificação e a escrita: resposta pela metade não serve
+        metricas.abortadas++;
+        tcp_arg(pcb, NULL);
+        tcp_abort(pcb);
+        return ERR_ABRT;
+    }
+    metricas.respostas++;
+    metricas.bytes += tamanho_cabecalho + tamanho_corpo;
+    tcp_output(pcb);
+    //Os dados já foram copiados: o fechamento gracioso envia o que está na fila antes do FIN
+    tcp_arg(pcb, NULL);
+    tcp_recv(pcb, NULL);
+    return fechar(pcb);
+}
+
+int escritor_http_json(char *buffer, size_t tamanho) {
+    return snprintf(buffer, tamanho,
+        "{\"respostas\":%lu,\"concluidas\":%lu,\"recusadas\":%lu,\"abortadas\":%lu,\"esperas\":%lu,"
+        "\"bytes\":%llu,\"em_uso_max\":%u}",
+        (unsigned long)metricas.respostas, (unsigned long)metricas.concluidas, (unsigned long)metricas.recusadas,
+        (unsigned long)metricas.abortadas, (unsigned long)metricas.esperas,
+        (unsigned long long)metricas.bytes, metricas.em_uso_max);
+}
@@ -0,0 +1,65 @@
+#ifndef ESCRITOR_HTTP_H
+#define ESCRITOR_HTTP_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lwip/tcp.h"
+
+//Envio de respostas HTTP respeitando o buffer de envio do TCP: cada escrita
+//cabe em tcp_sndbuf, o restante segue no callback de envio (ou no tcp_poll,
+//se o lwIP ficou sem memória) e a conexão só fecha depois da confirmação.
+//O corpo vem de uma de três fontes:
+//  referência  bytes prontos, como as cópias de lib/Web/cache_respostas, sem cópia
+//  gerador     corpo produzido em blocos com Transfer-Encoding: chunked; a RAM é
+//              um bloco por resposta, qualquer que seja o tamanho (exportações)
+//  cópia       respostas pequenas copiadas de uma vez
+//Sem escritor livre, sem bloco para o gerador ou com o heap do lwIP quase no
+//fim a conexão recebe 503 com Retry-After em vez de uma resposta truncada
+
+#define ESCRITOR_CONEXOES    8    //Respostas por referência ou gerador em andamento
+#define ESCRITOR_GERADORES   2    //Blocos para respostas com gerador
+#define ESCRITOR_BLOCO       512  //Bytes por bloco, incluindo o enquadramento do chunk
+#define ESCRITOR_HEAP_MINIMO 1024 //Heap livre do lwIP abaixo do qual novas respostas recebem 503
+#define ESCRITOR_ESPERAS_MAX 8    //Intervalos do tcp_poll (~2 s cada) sem confirmação antes de abortar
+
+//Escreve até 'tamanho' bytes do corpo; retorna quantos escreveu, 0 quando o corpo acabou
+typedef size_t (*GeradorCorpo)(void *contexto, char *destino, size_t tamanho);
+
+//Chamado uma vez no fim da resposta; 'concluida' é false se a conexão caiu antes
+typedef void (*FimResposta)(void *contexto, bool concluida);
+
+typedef struct {
+    uint32_t respostas;  //Aceitas pelas três fontes
+    uint32_t concluidas; //Por referência ou gerador, confirmadas até o último byte
+    uint32_t recusadas;  //503 por falta de escritor, bloco, buffer de envio ou heap
+    uint32_t abortadas;  //Conexão caiu, cliente fechou antes ou ficou sem progresso
+    uint32_t esperas;    //Escritas adiadas por buffer de envio, fila de segmentos ou heap cheios
+    uint64_t bytes;
+    uint8_t em_uso_max;
+} MetricasEscritor;
+
+//As funções abaixo rodam no contexto do lwIP e retornam:
+//  ERR_OK    resposta em andamento; 'fim' será chamado uma vez
+//  ERR_MEM   a conexão recebeu 503 e está fechando; 'fim' não é chamado
+//  ERR_ABRT  a conexão foi abortada e o pcb não existe mais; 'fim' não é
+//            chamado e o callback de recepção precisa retornar ERR_ABRT
+
+//Envia 'tamanho' bytes prontos (cabeçalho e corpo); devem continuar válidos até 'fim'
+err_t escritor_http_referencia(struct tcp_pcb *pcb, const char *dados, uint32_t tamanho, FimResposta fim, void *contexto);
+
+//Envia 200 com o corpo do gerador em chunked
+err_t escritor_http_gerador(struct tcp_pcb *pcb, const char *tipo_conteudo, GeradorCorpo gerar,
+                            FimResposta fim, void *contexto);
+
+//Copia cabeçalho e corpo para o TCP; recusa se a resposta não couber agora no buffer de envio
+err_t escritor_http_copia(struct tcp_pcb *pcb, const char *status, const char *tipo_conteudo,
+                          const char *adicionais, const char *corpo, int tamanho_corpo);
+
+//Responde 503 e fecha (o texto é constante, sai sem usar o heap)
+err_t escritor_http_recusar(struct tcp_pcb *pcb);
+
+//Contadores como objeto JSON; retorna o número de caracteres escritos
+int escritor_http_json(char *buffer, size_t tamanho);
+
+#endif // ESCRITOR_HTTP_H
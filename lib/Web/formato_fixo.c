@@ -0,0 +1,62 @@
+#include "formato_fixo.h"
+
+static const int32_t POTENCIAS_10[FORMATO_FIXO_CASAS_MAX + 1] = {1, 10, 100, 1000};
+
+// Escreve os dígitos de um valor sem sinal, com no mínimo 'minimo' dígitos
+static int escreverDigitos(char *destino, uint32_t valor, int minimo) {
+    char invertido[10];
+    int quantidade = 0;
+    do {
+        invertido[quantidade++] = (char)('0' + valor % 10);
+        valor /= 10;
+    } while (valor || quantidade < minimo);
+    for (int i = 0; i < quantidade; i++) {
+        destino[i] = invertido[quantidade - 1 - i];
+    }
+    return quantidade;
+}
+
+int formato_fixo_inteiro(char *destino, int32_t valor) {
+    int usado = 0;
+    uint32_t magnitude = (uint32_t)valor;
+    if (valor < 0) {
+        destino[usado++] = '-';
+        magnitude = 0u - magnitude;
+    }
+    return usado + escreverDigitos(destino + usado, magnitude, 1);
+}
+
+int formato_fixo_decimal(char *destino, int32_t valor, uint8_t casas) {
+    if (casas == 0) {
+        return formato_fixo_inteiro(destino, valor);
+    }
+    if (casas > FORMATO_FIXO_CASAS_MAX) {
+        casas = FORMATO_FIXO_CASAS_MAX;
+    }
+    int usado = 0;
+    uint32_t magnitude = (uint32_t)valor;
+    if (valor < 0) {
+        destino[usado++] = '-';
+        magnitude = 0u - magnitude;
+    }
+    uint32_t divisor = (uint32_t)POTENCIAS_10[casas];
+    usado += escreverDigitos(destino + usado, magnitude / divisor, 1);
+    destino[usado++] = '.';
+    return usado + escreverDigitos(destino + usado, magnitude % divisor, casas);
+}
+
+int32_t formato_fixo_de_float(float valor, uint8_t casas) {
+    if (casas > FORMATO_FIXO_CASAS_MAX) {
+        casas = FORMATO_FIXO_CASAS_MAX;
+    }
+    //Em double o produto é exato: 25.55f (na verdade 25.5499...) vira 255, como no printf
+    double escalado = (double)valor * POTENCIAS_10[casas];
+    //Satura em vez de estourar (ex.: leitura inválida muito grande)
+    if (escalado >= 2147483647.0) {
+        return INT32_MAX;
+    }
+    if (escalado <= -2147483647.0) {
+        return -INT32_MAX;
+    }
+    return (int32_t)(escalado < 0 ? escalado - 0.5 : escalado + 0.5);
+}
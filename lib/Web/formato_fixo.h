@@ -0,0 +1,22 @@
+#ifndef FORMATO_FIXO_H
+#define FORMATO_FIXO_H
+
+#include <stdint.h>
+
+//Formatação de números sem printf: inteiros e decimais em ponto fixo
+//(valor escalado por 10^casas). Evita o printf de ponto flutuante da newlib,
+//que no M0+ roda em software e ocupa vários KB de flash
+
+#define FORMATO_FIXO_CASAS_MAX    3
+#define FORMATO_FIXO_TAMANHO_MAX  13 //Sinal, 10 dígitos, ponto e folga, sem terminador
+
+//Escreve o inteiro em 'destino' sem terminador; retorna a quantidade de caracteres
+int formato_fixo_inteiro(char *destino, int32_t valor);
+
+//Escreve valor / 10^casas com exatamente 'casas' decimais (ex.: 274, 1 -> "27.4")
+int formato_fixo_decimal(char *destino, int32_t valor, uint8_t casas);
+
+//Converte para ponto fixo com arredondamento para o mais próximo (meio para longe do zero)
+int32_t formato_fixo_de_float(float valor, uint8_t casas);
+
+#endif // FORMATO_FIXO_H
@@ -0,0 +1,58 @@
+#include "modelo_web.h"
+#include <string.h>
+#include "formato_fixo.h"
+
+// Copia o que couber deixando espaço para o terminador
+static void anexar(char *saida, size_t tamanho, size_t *usado, const char *dados, size_t quantidade) {
+    size_t livre = tamanho - 1 - *usado;
+    if (quantidade > livre) {
+        quantidade = livre;
+    }
+    memcpy(saida + *usado, dados, quantidade);
+    *usado += quantidade;
+}
+
+int modelo_web_renderizar(const ModeloWeb *modelo, const ValorCampo *valores, char *saida, size_t tamanho) {
+    if (!tamanho) {
+        return 0;
+    }
+    size_t usado = 0;
+    char numero[FORMATO_FIXO_TAMANHO_MAX];
+
+    for (uint16_t i = 0; i < modelo->quantidade_passos; i++) {
+        const PassoModelo *passo = &modelo->passos[i];
+        //Em PASSO_TEXTO o argumento é uma posição no texto, não um campo
+        const ValorCampo *valor = passo->tipo == PASSO_TEXTO ? NULL : &valores[passo->argumento];
+        switch (passo->tipo) {
+            case PASSO_TEXTO:
+                anexar(saida, tamanho, &usado, modelo->texto + passo->argumento, passo->tamanho);
+                break;
+
+            case PASSO_CAMPO:
+                if (passo->formato == FORMATO_TEXTO) {
+                    if (valor->texto) {
+                        anexar(saida, tamanho, &usado, valor->texto, strlen(valor->texto));
+                    }
+                } else {
+                    int casas = passo->formato - FORMATO_INTEIRO;
+                    anexar(saida, tamanho, &usado, numero, formato_fixo_decimal(numero, valor->numero, (uint8_t)casas));
+                }
+                break;
+
+            case PASSO_SECAO:
+                if (!valor->numero) {
+                    i += passo->tamanho;
+                }
+                break;
+
+            case PASSO_SECAO_INVERSA:
+                if (valor->numero) {
+                    i += passo->tamanho;
+                }
+                break;
+        }
+    }
+
+    saida[usado] = '\0';
+    return (int)usado;
+}
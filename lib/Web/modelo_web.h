@@ -0,0 +1,50 @@
+#ifndef MODELO_WEB_H
+#define MODELO_WEB_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+//Modelos de página compilados em tempo de build por ferramentas/compilar_modelo.py.
+//O modelo vira um texto constante na flash e uma lista de passos: trechos de
+//texto, campos tipados e seções condicionais. A renderização só concatena;
+//números saem pelo formatador de ponto fixo, sem printf
+
+typedef enum {
+    PASSO_TEXTO,          //Copia 'tamanho' bytes do texto a partir de 'argumento'
+    PASSO_CAMPO,          //Formata o valor do campo 'argumento'
+    PASSO_SECAO,          //Pula os próximos 'tamanho' passos se o campo 'argumento' for zero
+    PASSO_SECAO_INVERSA   //Pula os próximos 'tamanho' passos se o campo 'argumento' não for zero
+} TipoPasso;
+
+typedef enum {
+    FORMATO_TEXTO,        //{{nome:s}}  valor.texto
+    FORMATO_INTEIRO,      //{{nome:i}}  valor.numero
+    FORMATO_DECIMAL_1,    //{{nome:.1}} valor.numero em décimos
+    FORMATO_DECIMAL_2,    //{{nome:.2}} valor.numero em centésimos
+    FORMATO_DECIMAL_3     //{{nome:.3}} valor.numero em milésimos
+} FormatoCampo;
+
+typedef struct {
+    uint8_t tipo;         //TipoPasso
+    uint8_t formato;      //FormatoCampo (só em PASSO_CAMPO)
+    uint16_t argumento;
+    uint16_t tamanho;
+} PassoModelo;
+
+typedef struct {
+    const char *texto;
+    const PassoModelo *passos;
+    uint16_t quantidade_passos;
+    uint16_t quantidade_campos;
+} ModeloWeb;
+
+//Valor de um campo: número em ponto fixo (escala dada pelo formato) ou texto
+typedef union {
+    int32_t numero;
+    const char *texto;
+} ValorCampo;
+
+//Renderiza o modelo; retorna o tamanho escrito (truncado em 'tamanho' - 1, sempre com terminador)
+int modelo_web_renderizar(const ModeloWeb *modelo, const ValorCampo *valores, char *saida, size_t tamanho);
+
+#endif // MODELO_WEB_H
@@ -0,0 +1,83 @@
+#include "pagina_web.h"
+#include <string.h>
+#include <math.h>
+#include "formato_fixo.h"
+#include "modelo_pagina.h" //Gerado de lib/Web/modelos/pagina.html no build
+
+int pagina_web_montar(const ResumoPagina *resumo, char *corpo, size_t tamanho) {
+    //Preenche os campos do modelo em ponto fixo; a página sai só por concatenação
+    ValorCampo valores[PAGINA_CAMPOS];
+    memset(valores, 0, sizeof(valores));
+
+    valores[PAGINA_LIGADO].numero = resumo->sistema_ligado;
+    valores[PAGINA_ESTADO].texto = resumo->autotune_ativo ? "AUTOTUNE" : (resumo->sistema_ligado ? "ATIVO" : "INATIVO");
+    valores[PAGINA_SETPOINT].numero = resumo->setpoint;
+    //Botões de ajuste enviam o setpoint absoluto já limitado à faixa: repetir o envio não acumula
+    valores[PAGINA_SETPOINT_ACIMA].numero = resumo->setpoint < resumo->setpoint_maximo ? resumo->setpoint + 1 : resumo->setpoint_maximo;
+    valores[PAGINA_SETPOINT_ABAIXO].numero = resumo->setpoint > resumo->setpoint_minimo ? resumo->setpoint - 1 : resumo->setpoint_minimo;
+    valores[PAGINA_TEMPERATURA].numero = formato_fixo_de_float(resumo->temperatura, 1);
+    valores[PAGINA_UMIDADE].numero = formato_fixo_de_float(resumo->umidade, 1);
+    valores[PAGINA_ERRO].numero = formato_fixo_de_float((float)resumo->setpoint - resumo->temperatura, 1);
+    valores[PAGINA_PWM].numero = resumo->ciclo_pwm;
+    //Percentual e ângulo em inteiros: ciclo * 1000 / 65535 décimos de % e ciclo * 1800 / 65535 décimos de grau
+    valores[PAGINA_PERCENTUAL_PWM].numero = (int32_t)(((uint32_t)resumo->ciclo_pwm * 1000u + 32767u) / 65535u);
+    valores[PAGINA_SERVO].numero = (int32_t)(((uint32_t)resumo->ciclo_pwm * 1800u + 32767u) / 65535u);
+    valores[PAGINA_RPM].numero = formato_fixo_de_float(resumo->rpm, 0);
+
+    valores[PAGINA_JANELA].numero = resumo->recentes.quantidade;
+    valores[PAGINA_MEDIA].numero = formato_fixo_de_float(resumo->recentes.media, 1);
+    valores[PAGINA_MINIMO].numero = formato_fixo_de_float(resumo->recentes.minimo, 1);
+    valores[PAGINA_MAXIMO].numero = formato_fixo_de_float(resumo->recentes.maximo, 1);
+    valores[PAGINA_DESVIO].numero = formato_fixo_de_float(sqrtf(resumo->recentes.variancia), 2);
+    valores[PAGINA_KP].numero = formato_fixo_de_float(resumo->kp, 2);
+    valores[PAGINA_KI].numero = formato_fixo_de_float(resumo->ki, 3);
+
+    //Resultados da autossintonia e da resposta com os ganhos atuais
+    valores[PAGINA_AUTOTUNE_CONCLUIDO].numero = resumo->autotune_concluido;
+    valores[PAGINA_AUTOTUNE_FALHOU].numero = !resumo->autotune_concluido && resumo->autotune_falhou;
+    valores[PAGINA_GANHO_CRITICO].numero = formato_fixo_de_float(resumo->ganho_critico, 1);
+    valores[PAGINA_PERIODO_CRITICO].numero = formato_fixo_de_float(resumo->periodo_critico_s, 0);
+    valores[PAGINA_AVALIACAO_CONCLUIDA].numero = resumo->avaliacao_concluida;
+    valores[PAGINA_AVALIACAO_ATIVA].numero = !resumo->avaliacao_concluida && resumo->avaliacao_ativa;
+    valores[PAGINA_ACOMODACAO].numero = formato_fixo_de_float(resumo->tempo_acomodacao_s, 0);
+    valores[PAGINA_SOBRESSINAL].numero = formato_fixo_de_float(resumo->sobressinal, 1);
+    valores[PAGINA_TEMPO_AVALIACAO].numero = formato_fixo_de_float(resumo->tempo_avaliacao_s, 0);
+
+    return modelo_web_renderizar(&modelo_pagina, valores, corpo, tamanho);
+}
+
+// Acrescenta um texto ao cabeçalho sem ultrapassar o buffer
+static void anexar(char *destino, size_t tamanho, size_t *usado, const char *texto, size_t quantidade) {
+    size_t livre = tamanho - 1 - *usado;
+    if (quantidade > livre) {
+        quantidade = livre;
+    }
+    memcpy(destino + *usado, texto, quantidade);
+    *usado += quantidade;
+}
+
+int pagina_web_cabecalho(char *cabecalho, size_t tamanho, const char *status, const char *tipo_conteudo, int tamanho_corpo) {
+    return pagina_web_cabecalho_adicional(cabecalho, tamanho, status, tipo_conteudo, NULL, tamanho_corpo);
+}
+
+int pagina_web_cabecalho_adicional(char *cabecalho, size_t tamanho, const char *status, const char *tipo_conteudo,
+                                   const char *adicionais, int tamanho_corpo) {
+    if (!tamanho) {
+        return 0;
+    }
+    char numero[FORMATO_FIXO_TAMANHO_MAX];
+    size_t usado = 0;
+    anexar(cabecalho, tamanho, &usado, "HTTP/1.1 ", 9);
+    anexar(cabecalho, tamanho, &usado, status, strlen(status));
+    anexar(cabecalho, tamanho, &usado, "\r\nContent-Type: ", 16);
+    anexar(cabecalho, tamanho, &usado, tipo_conteudo, strlen(tipo_conteudo));
+    anexar(cabecalho, tamanho, &usado, "\r\nContent-Length: ", 18);
+    anexar(cabecalho, tamanho, &usado, numero, formato_fixo_inteiro(numero, tamanho_corpo));
+    anexar(cabecalho, tamanho, &usado, "\r\nConnection: close\r\n", 21);
+    if (adicionais) {
+        anexar(cabecalho, tamanho, &usado, adicionais, strlen(adicionais));
+    }
+    anexar(cabecalho, tamanho, &usado, "\r\n", 2);
+    cabecalho[usado] = '\0';
+    return (int)usado;
+}
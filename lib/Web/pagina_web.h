@@ -0,0 +1,52 @@
+#ifndef PAGINA_WEB_H
+#define PAGINA_WEB_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "lib/Historico/historico.h"
+
+//Montagem da página do dashboard e dos cabeçalhos HTTP. Trabalha sobre uma
+//cópia dos valores exibidos, sem depender do estado global nem do lwIP, para
+//poder ser medida no computador (ferramentas/thermoguard_bench)
+
+//Valores exibidos no dashboard
+typedef struct {
+    bool sistema_ligado;
+    bool autotune_ativo;
+    int setpoint;
+    int setpoint_minimo;             //Faixa dos botões de ajuste
+    int setpoint_maximo;
+    float temperatura;
+    float umidade;
+    uint16_t ciclo_pwm;
+    float rpm;                       //Já zerado quando o motor simulado está parado
+    EstatisticasHistorico recentes;  //Janela do nível de segundos
+    float kp;
+    float ki;
+
+    //Resultado da autossintonia
+    bool autotune_concluido;
+    bool autotune_falhou;
+    float ganho_critico;
+    float periodo_critico_s;
+
+    //Avaliação da resposta com os ganhos atuais
+    bool avaliacao_concluida;
+    bool avaliacao_ativa;
+    float tempo_acomodacao_s;
+    float sobressinal;
+    float tempo_avaliacao_s;
+} ResumoPagina;
+
+//Monta o HTML do dashboard; retorna o tamanho do corpo (truncado em 'tamanho' - 1)
+int pagina_web_montar(const ResumoPagina *resumo, char *corpo, size_t tamanho);
+
+//Monta o cabeçalho de uma resposta com Content-Length e Connection: close
+int pagina_web_cabecalho(char *cabecalho, size_t tamanho, const char *status, const char *tipo_conteudo, int tamanho_corpo);
+
+//Idem, com linhas de cabeçalho extras já terminadas em \r\n (ex.: "Location: /\r\n")
+int pagina_web_cabecalho_adicional(char *cabecalho, size_t tamanho, const char *status, const char *tipo_conteudo,
+                                   const char *adicionais, int tamanho_corpo);
+
+#endif // PAGINA_WEB_H
@@ -0,0 +1,210 @@
+#define ROTAS_TABELA
+#include "rotas.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#define TAMANHO_MAX_NUMERO 24 //Maior valor numérico aceito nos parâmetros
+
+//FNV-1a de "MÉTODO caminho" partindo da semente encontrada pelo gerador (mesma conta de compilar_rotas.py)
+static uint32_t misturar(uint32_t valor, const char *texto, size_t tamanho) {
+    for (size_t i = 0; i < tamanho; i++) {
+        valor = (valor ^ (uint8_t)texto[i]) * 16777619u;
+    }
+    return valor;
+}
+
+static RotaHttp procurar(const char *metodo, size_t tamanho_metodo, const char *caminho, size_t tamanho_caminho) {
+    uint32_t valor = misturar(ROTAS_SEMENTE, metodo, tamanho_metodo);
+    valor = misturar(valor, " ", 1);
+    valor = misturar(valor, caminho, tamanho_caminho);
+    const EntradaRota *entrada = &TABELA_ROTAS[(valor ^ (valor >> 16)) & (ROTAS_POSICOES - 1)];
+    if (entrada->chave && entrada->tamanho_metodo == tamanho_metodo &&
+        entrada->tamanho == tamanho_metodo + 1 + tamanho_caminho &&
+        memcmp(entrada->chave, metodo, tamanho_metodo) == 0 &&
+        memcmp(entrada->chave + tamanho_metodo + 1, caminho, tamanho_caminho) == 0) {
+        return (RotaHttp)entrada->rota;
+    }
+    return ROTA_INEXISTENTE;
+}
+
+// Compara o início da linha sem diferenciar maiúsculas
+static bool comeca_com(const char *linha, const char *fim, const char *prefixo) {
+    for (; *prefixo; linha++, prefixo++) {
+        if (linha >= fim || (*linha | 0x20) != (*prefixo | 0x20)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool rotas_interpretar(const char *texto, size_t tamanho, RequisicaoHttp *requisicao) {
+    memset(requisicao, 0, sizeof(*requisicao));
+    const char *fim = texto + tamanho;
+    const char *espaco = memchr(texto, ' ', tamanho);
+    if (!espaco || espaco == texto || espaco + 1 >= fim || espaco[1] != '/') {
+        return false;
+    }
+    const char *alvo = espaco + 1;
+    const char *fim_alvo = memchr(alvo, ' ', fim - alvo);
+    if (!fim_alvo) {
+        return false;
+    }
+    requisicao->metodo = texto;
+    requisicao->tamanho_metodo = (uint16_t)(espaco - texto);
+    requisicao->caminho = alvo;
+    const char *interrogacao = memchr(alvo, '?', fim_alvo - alvo);
+    if (interrogacao) {
+        requisicao->consulta = interrogacao + 1;
+        requisicao->tamanho_consulta = (uint16_t)(fim_alvo - interrogacao - 1);
+        fim_alvo = interrogacao;
+    }
+    requisicao->tamanho_caminho = (uint16_t)(fim_alvo - alvo);
+
+    //Cabeçalhos até a linha em branco; só os que mudam a resposta são lidos
+    const char *linha = memchr(fim_alvo, '\n', fim - fim_alvo);
+    while (linha && ++linha < fim) {
+        const char *fim_linha = memchr(linha, '\n', fim - linha);
+        if (!fim_linha) {
+            break; //Cabeçalhos truncados: sem corpo
+        }
+        if (linha[0] == '\r' || linha[0] == '\n') {
+            requisicao->corpo = fim_linha + 1;
+            requisicao->tamanho_corpo = (uint16_t)(fim - requisicao->corpo);
+            break;
+        }
+        if (comeca_com(linha, fim_linha, "content-length:")) {
+            requisicao->corpo_declarado = (uint32_t)strtoul(linha + 15, NULL, 10);
+        } else if (comeca_com(linha, fim_linha, "accept:")) {
+            for (const char *c = linha + 7; c + 9 <= fim_linha; c++) {
+                if (memcmp(c, "text/html", 9) == 0) {
+                    requisicao->aceita_html = true;
+                    break;
+                }
+            }
+        }
+        linha = fim_linha;
+    }
+    return true;
+}
+
+// Resolve a rota
+RotaHttp rotas_resolver(const RequisicaoHttp *requisicao) {
+    RotaHttp rota = procurar(requisicao->metodo, requisicao->tamanho_metodo,
+                             requisicao->caminho, requisicao->tamanho_caminho);
+    if (rota != ROTA_INEXISTENTE) {
+        return rota;
+    }
+    //Caminho conhecido com outro método merece 405 em vez de 404; só custa na falha
+    return rotas_metodos_permitidos(requisicao, NULL, 0) ? ROTA_METODO_INVALIDO : ROTA_INEXISTENTE;
+}
+
+int rotas_metodos_permitidos(const RequisicaoHttp *requisicao, char *buffer, size_t tamanho) {
+    int quantidade = 0;
+    size_t usado = 0;
+    for (int i = 0; i < ROTAS_METODOS; i++) {
+        const char *metodo = METODOS_ROTAS[i];
+        if (procurar(metodo, strlen(metodo), requisicao->caminho, requisicao->tamanho_caminho) == ROTA_INEXISTENTE) {
+            continue;
+        }
+        if (buffer && usado < tamanho) {
+            usado += snprintf(buffer + usado, tamanho - usado, "%s%s", quantidade ? ", " : "", metodo);
+        }
+        quantidade++;
+    }
+    return quantidade;
+}
+
+bool rotas_corpo_completo(const RequisicaoHttp *requisicao) {
+    return requisicao->tamanho_corpo >= requisicao->corpo_declarado;
+}
+
+// Procura o campo em "a=1&b=2"
+static const char *procurar_campo(const char *campos, size_t tamanho, const char *nome, size_t *tamanho_valor) {
+    size_t tamanho_nome = strlen(nome);
+    const char *fim = campos + tamanho;
+    const char *campo = campos;
+    while (campo && campo < fim) {
+        const char *fim_campo = memchr(campo, '&', fim - campo);
+        if (!fim_campo) {
+            fim_campo = fim;
+        }
+        if ((size_t)(fim_campo - campo) > tamanho_nome && memcmp(campo, nome, tamanho_nome) == 0 &&
+            campo[tamanho_nome] == '=') {
+            *tamanho_valor = fim_campo - campo - tamanho_nome - 1;
+            return campo + tamanho_nome + 1;
+        }
+        campo = fim_campo + 1;
+    }
+    return NULL;
+}
+
+const char *rotas_parametro(const RequisicaoHttp *requisicao, const char *nome, size_t *tamanho) {
+    size_t descartado;
+    if (!tamanho) {
+        tamanho = &descartado;
+    }
+    const char *valor = NULL;
+    if (requisicao->consulta) {
+        valor = procurar_campo(requisicao->consulta, requisicao->tamanho_consulta, nome, tamanho);
+    }
+    if (!valor && requisicao->corpo) {
+        //Ignora o \r\n que alguns clientes acrescentam ao fim do formulário
+        size_t tamanho_corpo = requisicao->tamanho_corpo;
+        while (tamanho_corpo && (requisicao->corpo[tamanho_corpo - 1] == '\n' || requisicao->corpo[tamanho_corpo - 1] == '\r')) {
+            tamanho_corpo--;
+        }
+        valor = procurar_campo(requisicao->corpo, tamanho_corpo, nome, tamanho);
+    }
+    return valor;
+}
+
+// Copia o valor para um texto terminado em zero
+static bool copiar_numero(const RequisicaoHttp *requisicao, const char *nome, char *numero, SituacaoParametro *situacao) {
+    size_t tamanho;
+    const char *valor = rotas_parametro(requisicao, nome, &tamanho);
+    if (!valor) {
+        *situacao = PARAMETRO_AUSENTE;
+        return false;
+    }
+    if (!tamanho || tamanho >= TAMANHO_MAX_NUMERO) {
+        *situacao = PARAMETRO_INVALIDO;
+        return false;
+    }
+    memcpy(numero, valor, tamanho);
+    numero[tamanho] = '\0';
+    return true;
+}
+
+SituacaoParametro rotas_parametro_numero(const RequisicaoHttp *requisicao, const char *nome,
+                                         float minimo, float maximo, float *valor) {
+    char numero[TAMANHO_MAX_NUMERO];
+    SituacaoParametro situacao;
+    if (!copiar_numero(requisicao, nome, numero, &situacao)) {
+        return situacao;
+    }
+    char *fim;
+    float lido = strtof(numero, &fim);
+    if (*fim || !isfinite(lido) || lido < minimo || lido > maximo) {
+        return PARAMETRO_INVALIDO;
+    }
+    *valor = lido;
+    return PARAMETRO_VALIDO;
+}
+
+SituacaoParametro rotas_parametro_inteiro(const RequisicaoHttp *requisicao, const char *nome,
+                                          long minimo, long maximo, long *valor) {
+    char numero[TAMANHO_MAX_NUMERO];
+    SituacaoParametro situacao;
+    if (!copiar_numero(requisicao, nome, numero, &situacao)) {
+        return situacao;
+    }
+    char *fim;
+    long lido = strtol(numero, &fim, 10);
+    if (*fim || lido < minimo || lido > maximo) {
+        return PARAMETRO_INVALIDO;
+    }
+    *valor = lido;
+    return PARAMETRO_VALIDO;
+}
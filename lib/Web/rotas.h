@@ -0,0 +1,68 @@
+#ifndef ROTAS_H
+#define ROTAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+//Roteamento das requisições HTTP. A tabela vem de lib/Web/modelos/rotas.txt,
+//compilada no build por ferramentas/compilar_rotas.py com hash perfeito: o
+//método e o caminho levam direto a uma posição, confirmada com uma comparação.
+//Não depende do lwIP, para poder ser medido em ferramentas/thermoguard_bench
+
+//Posição da tabela gerada
+typedef struct {
+    const char *chave;      //"MÉTODO caminho"
+    uint8_t tamanho_metodo;
+    uint8_t tamanho;
+    uint8_t rota;           //RotaHttp
+} EntradaRota;
+
+#include "rotas_geradas.h" //Gerado de lib/Web/modelos/rotas.txt no build
+
+//Partes da requisição, apontando para o texto recebido (que precisa continuar vivo)
+typedef struct {
+    const char *metodo;
+    const char *caminho;     //Sem a query string
+    const char *consulta;    //Depois do '?', ou NULL
+    const char *corpo;       //Depois da linha em branco, ou NULL
+    uint16_t tamanho_metodo;
+    uint16_t tamanho_caminho;
+    uint16_t tamanho_consulta;
+    uint16_t tamanho_corpo;  //Bytes do corpo presentes no texto
+    uint32_t corpo_declarado; //Content-Length (0 se ausente)
+    bool aceita_html;        //Accept com text/html: formulário do navegador
+} RequisicaoHttp;
+
+typedef enum {
+    PARAMETRO_AUSENTE,
+    PARAMETRO_VALIDO,
+    PARAMETRO_INVALIDO  //Não é número, tem sobra depois dele ou está fora da faixa
+} SituacaoParametro;
+
+//Separa a linha de requisição e os cabeçalhos usados; retorna false se ela estiver malformada
+bool rotas_interpretar(const char *texto, size_t tamanho, RequisicaoHttp *requisicao);
+
+//Rota do método e caminho, ROTA_METODO_INVALIDO se o caminho só existe com
+//outros métodos ou ROTA_INEXISTENTE
+RotaHttp rotas_resolver(const RequisicaoHttp *requisicao);
+
+//Métodos aceitos no caminho da requisição ("GET, PUT"), para o cabeçalho Allow
+int rotas_metodos_permitidos(const RequisicaoHttp *requisicao, char *buffer, size_t tamanho);
+
+//O corpo chegou inteiro no texto recebido
+bool rotas_corpo_completo(const RequisicaoHttp *requisicao);
+
+//Valor de "nome=valor" na query string ou, se não estiver lá, no corpo
+//(application/x-www-form-urlencoded); NULL se ausente
+const char *rotas_parametro(const RequisicaoHttp *requisicao, const char *nome, size_t *tamanho);
+
+//Número decimal finito em [minimo, maximo]
+SituacaoParametro rotas_parametro_numero(const RequisicaoHttp *requisicao, const char *nome,
+                                         float minimo, float maximo, float *valor);
+
+//Número inteiro em [minimo, maximo]
+SituacaoParametro rotas_parametro_inteiro(const RequisicaoHttp *requisicao, const char *nome,
+                                          long minimo, long maximo, long *valor);
+
+#endif // ROTAS_H
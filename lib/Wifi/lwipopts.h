@@ -1,7 +1,48 @@
 #ifndef _LWIPOPTS_H
 #define _LWIPOPTS_H
 
+//Perfis de memória do lwIP, escolhidos no CMake com -DLWIP_PERFIL=<nome>:
+//  padrao            valores dos exemplos do SDK (heap de 4000 bytes, 24 pbufs)
+//  pouca_ram         um cliente por vez; janelas de 2 MSS e poucos pbufs (~25 KB a menos)
+//  muitos_clientes   vários dashboards simultâneos; mais PCBs e segmentos. As páginas
+//                    em cache saem por referência (só o cabeçalho de cada segmento
+//                    vai para o heap); o heap cobre os JSON e blocos gerados, copiados
+//  telemetria        poucas conexões longas (exportação do histórico) com buffer
+//                    de envio grande para manter o enlace ocupado
+//Os contadores de uso dos pools (/api/metricas) mostram qual perfil a carga real pede
+
+#if defined(LWIP_PERFIL_POUCA_RAM)
+#define LWIP_PERFIL_NOME            "pouca_ram"
+#define MEM_SIZE                    4000
+#define PBUF_POOL_SIZE              8
+#define MEMP_NUM_TCP_PCB            4
+#define MEMP_NUM_TCP_SEG            16
+#define TCP_WND                     (2 * TCP_MSS)
+#define TCP_SND_BUF                 (2 * TCP_MSS)
+
+#elif defined(LWIP_PERFIL_MUITOS_CLIENTES)
+#define LWIP_PERFIL_NOME            "muitos_clientes"
+#define MEM_SIZE                    16000 //JSON copiados de vários clientes mais os cabeçalhos dos segmentos por referência
+#define PBUF_POOL_SIZE              16
+#define MEMP_NUM_TCP_PCB            12
+#define MEMP_NUM_TCP_SEG            48
+#define TCP_WND                     (2 * TCP_MSS) //Requisições são pequenas: janela curta por conexão
+#define TCP_SND_BUF                 (3 * TCP_MSS)
+
+#elif defined(LWIP_PERFIL_TELEMETRIA)
+#define LWIP_PERFIL_NOME            "telemetria"
+#define MEM_SIZE                    24000
+#define PBUF_POOL_SIZE              16
+#define MEMP_NUM_TCP_PCB            6
+#define MEMP_NUM_TCP_SEG            64
+#define TCP_WND                     (4 * TCP_MSS)
+#define TCP_SND_BUF                 (8 * TCP_MSS)
+
+#else
+#define LWIP_PERFIL_NOME            "padrao"
+#endif
+
 //Inclui configurações comuns do lwIP para exemplos do Pico W
 #include "lwipopts_examples_common.h"
 
-#endif /* _LWIPOPTS_H */
\ No newline at end of file
+#endif /* _LWIPOPTS_H */
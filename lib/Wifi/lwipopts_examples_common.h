@@ -18,10 +18,16 @@
 #define MEM_LIBC_MALLOC             0  //Desativa alocação da libc em modos não-polling
 #endif
 #define MEM_ALIGNMENT               4   //Alinhamento de memória em 4 bytes
+#ifndef MEM_SIZE
 #define MEM_SIZE                    4000 //Tamanho total do heap em bytes
+#endif
+#ifndef MEMP_NUM_TCP_SEG
 #define MEMP_NUM_TCP_SEG            32  //Número de segmentos TCP na memória
+#endif
 #define MEMP_NUM_ARP_QUEUE          10  //Tamanho da fila ARP
+#ifndef PBUF_POOL_SIZE
 #define PBUF_POOL_SIZE              24  //Número de buffers no pool de pacotes
+#endif
 
 //Configurações de protocolos de rede
 #define LWIP_ARP                    1   //Habilita o protocolo ARP
@@ -37,9 +43,15 @@
 //Configurações de TCP
 #define LWIP_TCP                    1   //Habilita o protocolo TCP
 #define TCP_MSS                     1460 //Tamanho máximo do segmento TCP
+#ifndef TCP_WND
 #define TCP_WND                     (8 * TCP_MSS) //Janela de recepção TCP
+#endif
+#ifndef TCP_SND_BUF
 #define TCP_SND_BUF                 (8 * TCP_MSS) //Buffer de envio TCP
+#endif
+#ifndef TCP_SND_QUEUELEN
 #define TCP_SND_QUEUELEN            ((4 * (TCP_SND_BUF) + (TCP_MSS - 1)) / (TCP_MSS)) //Tamanho da fila de envio
+#endif
 #define LWIP_TCP_KEEPALIVE          1   //Habilita keepalive para conexões TCP
 
 //Configurações de UDP
@@ -53,13 +65,21 @@
 #define LWIP_NETCONN                0   //Desativa a API netconn
 
 //Configurações de estatísticas e depuração
-#define MEM_STATS                   0   //Desativa estatísticas de memória
+//Os contadores de memória (heap e pools) ficam sempre ligados: custam um incremento
+//por alocação e alimentam /api/metricas; os contadores por protocolo ficam desligados
+#define LWIP_STATS                  1   //Habilita coleta de estatísticas
+#define MEM_STATS                   1   //Uso, pico e falhas do heap do lwIP
+#define MEMP_STATS                  1   //Uso, pico e falhas de cada pool
 #define SYS_STATS                   0   //Desativa estatísticas do sistema
-#define MEMP_STATS                  0   //Desativa estatísticas de pools de memória
 #define LINK_STATS                  0   //Desativa estatísticas do link
+#define ETHARP_STATS                0   //Desativa estatísticas do ARP
+#define IP_STATS                    0   //Desativa estatísticas do IP
+#define IPFRAG_STATS                0   //Desativa estatísticas de fragmentação
+#define ICMP_STATS                  0   //Desativa estatísticas do ICMP
+#define UDP_STATS                   0   //Desativa estatísticas do UDP
+#define TCP_STATS                   0   //Desativa estatísticas do TCP
 #ifndef NDEBUG
 #define LWIP_DEBUG                  1   //Habilita modo de depuração
-#define LWIP_STATS                  1   //Habilita coleta de estatísticas
 #define LWIP_STATS_DISPLAY          1   //Habilita exibição de estatísticas
 #endif
 
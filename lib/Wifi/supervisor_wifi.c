@@ -0,0 +1,215 @@
+#include "supervisor_wifi.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "pico/cyw43_arch.h"
+#include "lwip/netif.h"
+#include "lwip/dhcp.h"
+#include "lwip/ip_addr.h"
+
+#define TEMPO_ASSOCIACAO_MS 10000 //Limite para associar ao ponto de acesso
+#define TEMPO_IP_MS         15000 //Limite para obter IP depois de associado
+#define ESPERA_INICIAL_MS   1000  //Primeira espera entre tentativas
+#define ESPERA_MAXIMA_MS    60000 //A espera dobra a cada falha até este teto
+
+#define IOCTL_LER_CANAL    0x3a //WLC_GET_CHANNEL (29) no formato do cyw43_ioctl: comando << 1, bit 0 zerado (leitura)
+#define TAMANHO_INFO_CANAL 12   //channel_info_t: canal em uso, canal alvo e canal da varredura (3 x uint32_t)
+
+static struct {
+    ConfiguracaoWifi config;
+    bool ip_fixo_valido;
+    ip4_addr_t ip, mascara, gateway;
+    EstadoWifi estado;
+    CacheWifi cache;
+    bool usando_cache;
+    uint32_t inicio_estado_ms;
+    uint32_t inicio_tentativa_ms;
+    uint32_t espera_ms;
+    uint32_t proxima_tentativa_ms;
+    MetricasWifi metricas;
+} supervisor;
+
+static uint32_t agoraMs(void) {
+    return to_ms_since_boot(get_absolute_time());
+}
+
+static void mudarEstado(EstadoWifi estado) {
+    supervisor.estado = estado;
+    supervisor.inicio_estado_ms = agoraMs();
+}
+
+// Agenda a próxima tentativa dobrando a espera
+static void agendarTentativa(void) {
+    supervisor.proxima_tentativa_ms = agoraMs() + supervisor.espera_ms;
+    supervisor.espera_ms = supervisor.espera_ms * 2 > ESPERA_MAXIMA_MS ? ESPERA_MAXIMA_MS : supervisor.espera_ms * 2;
+    mudarEstado(WIFI_AGUARDANDO_TENTATIVA);
+}
+
+// Dispara a associação sem esperar pelo resultado
+static void iniciarAssociacao(void) {
+    const char *nome = supervisor.config.nome_rede;
+    const char *senha = supervisor.config.senha;
+    supervisor.usando_cache = supervisor.cache.canal != 0;
+    supervisor.inicio_tentativa_ms = agoraMs();
+    supervisor.metricas.tentativas++;
+
+    //Com BSSID e canal conhecidos o firmware pula a varredura de canais
+    int erro = cyw43_wifi_join(&cyw43_state, strlen(nome), (const uint8_t *)nome,
+                               senha ? strlen(senha) : 0, (const uint8_t *)senha, supervisor.config.autenticacao,
+                               supervisor.usando_cache ? supervisor.cache.bssid : NULL,
+                               supervisor.usando_cache ? supervisor.cache.canal : CYW43_CHANNEL_NONE);
+    if (erro) {
+        agendarTentativa();
+    } else {
+        mudarEstado(WIFI_ASSOCIANDO);
+    }
+}
+
+// Encerra a tentativa atual; um cache que falhou é descartado e a varredura completa é tentada logo em seguida
+static void falharTentativa(void) {
+    cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+    if (supervisor.usando_cache) {
+        supervisor.metricas.falhas_cache++;
+        memset(&supervisor.cache, 0, sizeof(supervisor.cache));
+        iniciarAssociacao();
+        return;
+    }
+    agendarTentativa();
+}
+
+// Guarda BSSID e canal do ponto de acesso associado
+static void atualizarCache(void) {
+    CacheWifi cache = {0};
+    uint8_t canal[TAMANHO_INFO_CANAL] = {0}; //O canal em uso é o primeiro campo, em little-endian
+    if (cyw43_wifi_get_bssid(&cyw43_state, cache.bssid) == 0 &&
+        cyw43_ioctl(&cyw43_state, IOCTL_LER_CANAL, sizeof(canal), canal, CYW43_ITF_STA) == 0) {
+        cache.canal = canal[0];
+        supervisor.cache = cache;
+    }
+}
+
+// Estado do link IP; lê a netif e o DHCP do lwIP, então roda com o lwIP travado
+static int linkTcpip(void) {
+    cyw43_arch_lwip_begin();
+    int link = cyw43_tcpip_link_status(&cyw43_state, CYW43_ITF_STA);
+    cyw43_arch_lwip_end();
+    return link;
+}
+
+// Troca o DHCP pelo endereço fixo configurado
+static void aplicarIpFixo(void) {
+    struct netif *interface = &cyw43_state.netif[CYW43_ITF_STA];
+    cyw43_arch_lwip_begin();
+    dhcp_stop(interface);
+    netif_set_addr(interface, &supervisor.ip, &supervisor.mascara, &supervisor.gateway);
+    cyw43_arch_lwip_end();
+}
+
+// Registra a conexão e as métricas de tempo até o IP
+static void concluirConexao(void) {
+    uint32_t agora = agoraMs();
+    MetricasWifi *metricas = &supervisor.metricas;
+    metricas->tempo_ate_ip_ms = agora - supervisor.inicio_tentativa_ms;
+    if (!metricas->conexoes || metricas->tempo_ate_ip_ms < metricas->melhor_tempo_ate_ip_ms) {
+        metricas->melhor_tempo_ate_ip_ms = metricas->tempo_ate_ip_ms;
+    }
+    if (!metricas->conexoes) {
+        metricas->primeiro_ip_ms = agora;
+    }
+    metricas->conexoes++;
+    metricas->ultima_com_cache = supervisor.usando_cache;
+    supervisor.espera_ms = ESPERA_INICIAL_MS;
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 1);
+    mudarEstado(WIFI_CONECTADO);
+}
+
+bool supervisor_wifi_iniciar(const ConfiguracaoWifi *config, const CacheWifi *cache) {
+    memset(&supervisor, 0, sizeof(supervisor));
+    supervisor.config = *config;
+    supervisor.espera_ms = ESPERA_INICIAL_MS;
+    if (cache && cache->canal) {
+        supervisor.cache = *cache;
+    }
+    supervisor.ip_fixo_valido = config->ip_fixo && config->mascara && config->gateway &&
+                                ip4addr_aton(config->ip_fixo, &supervisor.ip) &&
+                                ip4addr_aton(config->mascara, &supervisor.mascara) &&
+                                ip4addr_aton(config->gateway, &supervisor.gateway);
+
+    if (cyw43_arch_init()) {
+        mudarEstado(WIFI_FALHA_HARDWARE);
+        return false;
+    }
+    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
+    cyw43_arch_enable_sta_mode();
+    iniciarAssociacao();
+    return true;
+}
+
+bool supervisor_wifi_executar(void) {
+    uint32_t no_estado_ms = agoraMs() - supervisor.inicio_estado_ms;
+
+    switch (supervisor.estado) {
+        case WIFI_ASSOCIANDO: {
+            int link = cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA);
+            if (link == CYW43_LINK_JOIN) {
+                atualizarCache();
+                if (supervisor.ip_fixo_valido) {
+                    aplicarIpFixo();
+                }
+                mudarEstado(WIFI_AGUARDANDO_IP);
+            } else if (link == CYW43_LINK_FAIL || link == CYW43_LINK_NONET || link == CYW43_LINK_BADAUTH ||
+                       no_estado_ms > TEMPO_ASSOCIACAO_MS) {
+                falharTentativa();
+            }
+            break;
+        }
+
+        case WIFI_AGUARDANDO_IP:
+            if (linkTcpip() == CYW43_LINK_UP) {
+                concluirConexao();
+                return true;
+            }
+            if (cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_JOIN || no_estado_ms > TEMPO_IP_MS) {
+                falharTentativa();
+            }
+            break;
+
+        case WIFI_CONECTADO:
+            if (cyw43_wifi_link_status(&cyw43_state, CYW43_ITF_STA) != CYW43_LINK_JOIN) {
+                //Link perdido: a primeira nova tentativa é imediata, as seguintes recuam
+                supervisor.metricas.quedas++;
+                cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
+                cyw43_wifi_leave(&cyw43_state, CYW43_ITF_STA);
+                iniciarAssociacao();
+            }
+            break;
+
+        case WIFI_AGUARDANDO_TENTATIVA:
+            if ((int32_t)(agoraMs() - supervisor.proxima_tentativa_ms) >= 0) {
+                iniciarAssociacao();
+            }
+            break;
+
+        case WIFI_INICIANDO:
+        case WIFI_FALHA_HARDWARE:
+            break;
+    }
+    return false;
+}
+
+EstadoWifi supervisor_wifi_estado(void) {
+    return supervisor.estado;
+}
+
+const char *supervisor_wifi_nome_estado(EstadoWifi estado) {
+    static const char *nomes[] = {"iniciando", "associando", "aguardando_ip", "conectado", "aguardando_tentativa", "falha_hardware"};
+    return (unsigned)estado < count_of(nomes) ? nomes[estado] : "?";
+}
+
+bool supervisor_wifi_cache(CacheWifi *cache) {
+    *cache = supervisor.cache;
+    return cache->canal != 0;
+}
+
+const MetricasWifi *supervisor_wifi_metricas(void) {
+    return &supervisor.metricas;
+}
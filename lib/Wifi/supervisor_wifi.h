@@ -0,0 +1,61 @@
+#ifndef SUPERVISOR_WIFI_H
+#define SUPERVISOR_WIFI_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+//Supervisor da conexão Wi-Fi em máquina de estados não bloqueante: associa de
+//forma assíncrona (direto no BSSID/canal em cache quando houver), aplica IP fixo
+//opcional no lugar do DHCP e, em falhas ou quedas do link, tenta de novo com
+//espera exponencial. Basta chamar supervisor_wifi_executar periodicamente
+
+typedef enum {
+    WIFI_INICIANDO,
+    WIFI_ASSOCIANDO,          //Aguardando a associação ao ponto de acesso
+    WIFI_AGUARDANDO_IP,       //Associado; aguardando DHCP (ou aplicando o IP fixo)
+    WIFI_CONECTADO,
+    WIFI_AGUARDANDO_TENTATIVA, //Espera exponencial antes de tentar de novo
+    WIFI_FALHA_HARDWARE       //cyw43_arch_init falhou
+} EstadoWifi;
+
+//Ponto de acesso da última associação; canal 0 indica cache vazio
+typedef struct {
+    uint8_t bssid[6];
+    uint8_t canal;
+} CacheWifi;
+
+typedef struct {
+    const char *nome_rede;
+    const char *senha;
+    uint32_t autenticacao;    //CYW43_AUTH_*
+    const char *ip_fixo;      //NULL usa DHCP
+    const char *mascara;
+    const char *gateway;
+} ConfiguracaoWifi;
+
+typedef struct {
+    uint32_t tentativas;      //Associações iniciadas
+    uint32_t conexoes;        //Vezes em que um IP foi obtido
+    uint32_t quedas;          //Perdas de link depois de conectado
+    uint32_t falhas_cache;    //Associações pelo cache que falharam (cache descartado)
+    uint32_t tempo_ate_ip_ms; //Da última tentativa até ter IP
+    uint32_t melhor_tempo_ate_ip_ms;
+    uint32_t primeiro_ip_ms;  //Desde o boot até o primeiro IP
+    bool ultima_com_cache;    //A última conexão usou BSSID/canal em cache
+} MetricasWifi;
+
+//Inicializa o CYW43 e dispara a primeira associação; cache pode ser NULL
+bool supervisor_wifi_iniciar(const ConfiguracaoWifi *config, const CacheWifi *cache);
+
+//Avança a máquina de estados; nunca bloqueia. Retorna true no instante em que um IP é obtido
+bool supervisor_wifi_executar(void);
+
+EstadoWifi supervisor_wifi_estado(void);
+const char *supervisor_wifi_nome_estado(EstadoWifi estado);
+
+//Cache atual (para persistir); retorna false se estiver vazio
+bool supervisor_wifi_cache(CacheWifi *cache);
+
+const MetricasWifi *supervisor_wifi_metricas(void);
+
+#endif // SUPERVISOR_WIFI_H
@@ -0,0 +1,130 @@
+#include "zonas.h"
+#include <string.h>
+#include "pico/stdlib.h"
+#include "hardware/pwm.h"
+#include "lib/dht11/dht11.h"
+#include "lib/Entrada/aquisicao_adc.h"
+#include "lib/Sensores/sensor_analogico.h"
+
+#define PINO_ADC0       26
+#define ENTRADA_INTERNA 4
+
+//Um filtro por entrada do ADC (cada entrada atende uma zona)
+static SensorAnalogico sensores_analogicos[AQUISICAO_ADC_ENTRADAS];
+static const ParametrosNtc NTC_PADRAO = SENSOR_NTC_10K;
+
+//Entrada do ADC do sensor da zona ou -1 se não for analógico
+static int entrada_adc(TipoSensor tipo_sensor, uint8_t pino_sensor) {
+    if (tipo_sensor == SENSOR_INTERNO) {
+        return ENTRADA_INTERNA;
+    }
+    if (tipo_sensor == SENSOR_NTC && pino_sensor >= PINO_ADC0 && pino_sensor < PINO_ADC0 + ENTRADA_INTERNA - 1) {
+        return pino_sensor - PINO_ADC0;
+    }
+    return -1;
+}
+
+// Zera a tabela de zonas
+void zonas_inicializar(TabelaZonas *zonas, float limite_integral) {
+    memset(zonas, 0, sizeof(*zonas));
+    zonas->limite_integral = limite_integral;
+}
+
+// Adiciona uma zona e configura sua saída PWM
+int zonas_adicionar(TabelaZonas *zonas, const char *nome, TipoSensor tipo_sensor, uint8_t pino_sensor,
+                    uint8_t pino_pwm, float setpoint, float kp, float ki) {
+    if (zonas->quantidade >= ZONAS_MAX) {
+        return -1;
+    }
+
+    int entrada = entrada_adc(tipo_sensor, pino_sensor);
+    if (tipo_sensor != SENSOR_DHT11 && entrada < 0) {
+        return -1;
+    }
+
+    //Cada canal PWM e cada entrada do ADC só podem atender uma zona
+    uint8_t fatia = pwm_gpio_to_slice_num(pino_pwm);
+    uint8_t canal = pwm_gpio_to_channel(pino_pwm);
+    for (int i = 0; i < zonas->quantidade; i++) {
+        if (zonas->fatia_pwm[i] == fatia && zonas->canal_pwm[i] == canal) {
+            return -1;
+        }
+        if (entrada >= 0 && entrada_adc(zonas->tipo_sensor[i], zonas->pino_sensor[i]) == entrada) {
+            return -1;
+        }
+    }
+
+    int indice = zonas->quantidade++;
+    zonas->nome[indice] = nome;
+    zonas->tipo_sensor[indice] = tipo_sensor;
+    zonas->pino_sensor[indice] = pino_sensor;
+    zonas->pino_pwm[indice] = pino_pwm;
+    zonas->fatia_pwm[indice] = fatia;
+    zonas->canal_pwm[indice] = canal;
+    zonas->setpoint[indice] = setpoint;
+    zonas->kp[indice] = kp;
+    zonas->ki[indice] = ki;
+
+    //Configura o sensor
+    if (tipo_sensor == SENSOR_DHT11) {
+        gpio_init(pino_sensor);
+    } else {
+        SensorAnalogico *sensor = &sensores_analogicos[entrada];
+        if (tipo_sensor == SENSOR_NTC) {
+            sensor_analogico_ntc(sensor, &NTC_PADRAO);
+        } else {
+            sensor_analogico_interno(sensor);
+        }
+        aquisicao_adc_registrar(entrada, sensor_analogico_consumir, sensor);
+    }
+
+    //Configura a saída PWM com a mesma resolução da zona principal
+    gpio_set_function(pino_pwm, GPIO_FUNC_PWM);
+    pwm_set_wrap(fatia, 65535);
+    pwm_set_chan_level(fatia, canal, 0);
+    pwm_set_enabled(fatia, true);
+    return indice;
+}
+
+// Troca o sensor da zona pela planta simulada
+void zonas_simular(TabelaZonas *zonas, int indice, PlantaTermica *planta) {
+    if (indice >= 0 && indice < zonas->quantidade) {
+        zonas->planta[indice] = planta;
+    }
+}
+
+// Lê os sensores das zonas ligadas
+int zonas_ler_sensores(TabelaZonas *zonas) {
+    int leituras = 0;
+    for (int i = 0; i < zonas->quantidade; i++) {
+        if (!zonas->ligada[i]) {
+            continue;
+        }
+        float umidade = zonas->umidade[i], temperatura;
+        if (zonas->planta[i]) {
+            //A saída aplicada desde a última leitura age sobre a planta até agora
+            planta_avancar_ate(zonas->planta[i], time_us_64() / 1e6f, zonas->ciclo_pwm[i]);
+            temperatura = planta_medir(zonas->planta[i]);
+            zonas->leitura_valida[i] = true;
+        } else if (zonas->tipo_sensor[i] == SENSOR_DHT11) {
+            zonas->leitura_valida[i] = dht11_read(zonas->pino_sensor[i], &umidade, &temperatura) == 0;
+        } else {
+            int entrada = entrada_adc(zonas->tipo_sensor[i], zonas->pino_sensor[i]);
+            zonas->leitura_valida[i] = sensor_analogico_ler(&sensores_analogicos[entrada], &temperatura);
+        }
+        if (zonas->leitura_valida[i]) {
+            zonas->leitura_recebida[i] = true;
+            zonas->temperatura[i] = temperatura;
+            zonas->umidade[i] = umidade;
+            leituras++;
+        }
+    }
+    return leituras;
+}
+
+// Escreve as saídas no hardware
+void zonas_aplicar_saidas(const TabelaZonas *zonas) {
+    for (int i = 0; i < zonas->quantidade; i++) {
+        pwm_set_chan_level(zonas->fatia_pwm[i], zonas->canal_pwm[i], zonas->ciclo_pwm[i]);
+    }
+}
@@ -0,0 +1,77 @@
+#ifndef ZONAS_H
+#define ZONAS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "lib/Simulacao/planta_termica.h"
+
+//Uma zona por fatia PWM do RP2040
+#define ZONAS_MAX 8
+
+//Tipos de sensor que podem ser ligados a uma zona
+typedef enum {
+    SENSOR_DHT11,
+    SENSOR_NTC,    //Termistor em divisor; pino_sensor de 26 a 28 (ADC0 a ADC2)
+    SENSOR_INTERNO //Sensor do RP2040 no ADC4; pino_sensor é ignorado
+} TipoSensor;
+
+//Tabela de zonas em layout de estrutura de vetores: cada campo fica contíguo
+//para todas as zonas, então o laço de controle percorre a memória em sequência
+typedef struct {
+    uint8_t quantidade;
+
+    //Ligação de hardware
+    const char *nome[ZONAS_MAX];
+    uint8_t tipo_sensor[ZONAS_MAX];
+    uint8_t pino_sensor[ZONAS_MAX];
+    uint8_t pino_pwm[ZONAS_MAX];
+    uint8_t fatia_pwm[ZONAS_MAX];
+    uint8_t canal_pwm[ZONAS_MAX];
+    PlantaTermica *planta[ZONAS_MAX]; //Planta simulada no lugar do sensor (NULL: sensor real)
+
+    //Entradas
+    float temperatura[ZONAS_MAX];
+    float umidade[ZONAS_MAX];
+    bool leitura_valida[ZONAS_MAX]; //Última leitura do sensor foi bem-sucedida
+    bool leitura_recebida[ZONAS_MAX]; //Já houve ao menos uma leitura válida (até lá a saída é mantida)
+    float setpoint[ZONAS_MAX];
+    bool ligada[ZONAS_MAX];        //Zona em operação (sensor lido e saída ativa)
+    bool saida_externa[ZONAS_MAX]; //Saída definida fora do PI (ex.: autossintonia)
+
+    //Estado do controlador
+    float kp[ZONAS_MAX];
+    float ki[ZONAS_MAX];
+    float integral[ZONAS_MAX];
+    float limite_integral;
+
+    //Saídas
+    uint16_t ciclo_pwm[ZONAS_MAX];
+} TabelaZonas;
+
+//Zera a tabela
+void zonas_inicializar(TabelaZonas *zonas, float limite_integral);
+
+//Adiciona uma zona e configura sua saída PWM; retorna o índice ou -1 se a tabela
+//estiver cheia, o canal PWM já estiver em uso por outra zona ou a entrada do ADC
+//não existir ou já pertencer a outra zona.
+//Sensores analógicos são registrados em lib/Entrada/aquisicao_adc e passam a
+//amostrar quando a aquisição for iniciada
+int zonas_adicionar(TabelaZonas *zonas, const char *nome, TipoSensor tipo_sensor, uint8_t pino_sensor,
+                    uint8_t pino_pwm, float setpoint, float kp, float ki);
+
+//Troca o sensor da zona por uma planta simulada alimentada pelo próprio ciclo_pwm;
+//a planta avança em tempo real a cada leitura
+void zonas_simular(TabelaZonas *zonas, int indice, PlantaTermica *planta);
+
+//Lê os sensores das zonas ligadas; retorna quantas leituras foram bem-sucedidas.
+//Sensores analógicos entregam a última amostra filtrada (125 por segundo)
+int zonas_ler_sensores(TabelaZonas *zonas);
+
+//Executa um passo do PI em todas as zonas ligadas (sem acesso ao hardware); zonas
+//ainda sem leitura válida mantêm a saída atual
+void zonas_executar_passo(TabelaZonas *zonas, float intervalo_s);
+
+//Escreve o ciclo de trabalho de cada zona no respectivo canal PWM
+void zonas_aplicar_saidas(const TabelaZonas *zonas);
+
+#endif // ZONAS_H
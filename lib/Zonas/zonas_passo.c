@@ -0,0 +1,21 @@
+#include "zonas.h"
+#include "lib/Controle/controle_pi.h"
+
+//Parte da tabela de zonas sem acesso ao hardware, compilada também nas
+//ferramentas do host (reprodução de rastros)
+
+// Executa um passo do PI em todas as zonas
+void zonas_executar_passo(TabelaZonas *zonas, float intervalo_s) {
+    for (int i = 0; i < zonas->quantidade; i++) {
+        if (!zonas->ligada[i]) {
+            //Zona desligada: reseta o integrador e desliga a saída
+            zonas->integral[i] = 0.0f;
+            zonas->ciclo_pwm[i] = 0;
+        } else if (!zonas->saida_externa[i] && zonas->leitura_recebida[i]) {
+            float erro = zonas->temperatura[i] - zonas->setpoint[i];
+            float sinal_controle = controle_pi_calcular(&zonas->integral[i], zonas->kp[i], zonas->ki[i],
+                                                        zonas->limite_integral, erro, intervalo_s);
+            zonas->ciclo_pwm[i] = controle_pi_sinal_para_pwm(sinal_controle);
+        }
+    }
+}
@@ -53,8 +53,8 @@ static int waitForResponse(uint8_t dataPin) {
     return 0;
 }
 
-// Lê os 40 bits de dados do DHT11 e armazena nos bytes
-static int readDataBits(uint8_t dataPin, uint8_t* data) {
+// Mede a duração do nível alto de cada um dos 40 bits (a decodificação fica fora do laço temporizado)
+static int readPulseLengths(uint8_t dataPin, uint8_t* pulseLengthsUs) {
     for (int i = 0; i < DATA_BITS; i++) {
         //Aguarda início do bit (subida de nível)
         if (waitForPinLevel(dataPin, 1, MAX_WAIT_TIME_US) < 0) {
@@ -67,12 +67,7 @@ static int readDataBits(uint8_t dataPin, uint8_t* data) {
             return ERROR_TIMEOUT;
         }
         uint32_t pulseLength = to_us_since_boot(get_absolute_time()) - startTime;
-
-        //Armazena bit: 1 se duração > limiar, 0 caso contrário
-        data[i / 8] <<= 1;
-        if (pulseLength > PULSE_THRESHOLD_US) {
-            data[i / 8] |= 1;
-        }
+        pulseLengthsUs[i] = pulseLength > 255 ? 255 : (uint8_t)pulseLength;
     }
     return 0;
 }
@@ -86,9 +81,29 @@ static int verifyChecksum(const uint8_t* data) {
     return 0;
 }
 
+// Converte as durações dos pulsos em bytes, confere o checksum e calcula os valores
+int dht11_decode(const uint8_t* pulseLengthsUs, float* humidityPercent, float* temperatureCelsius) {
+    uint8_t data[DATA_BYTES] = {0};
+
+    //Armazena bit: 1 se duração > limiar, 0 caso contrário
+    for (int i = 0; i < DATA_BITS; i++) {
+        data[i / 8] = (uint8_t)((data[i / 8] << 1) | (pulseLengthsUs[i] > PULSE_THRESHOLD_US));
+    }
+
+    //Verifica checksum
+    if (verifyChecksum(data) < 0) {
+        return ERROR_CHECKSUM;
+    }
+
+    //Atribui valores de umidade e temperatura com uma casa decimal simulada
+    *humidityPercent = data[0] + (data[1] / 10.0);
+    *temperatureCelsius = data[2] + (data[3] / 10.0);
+    return 0;
+}
+
 // Lê temperatura e umidade do sensor DHT11
 int dht11_read(uint8_t dataPin, float* humidityPercent, float* temperatureCelsius) {
-    uint8_t data[DATA_BYTES] = {0};
+    uint8_t pulseLengthsUs[DATA_BITS];
 
     //Inicia comunicação com o sensor
     if (sendStartSignal(dataPin) < 0) {
@@ -100,18 +115,10 @@ int dht11_read(uint8_t dataPin, float* humidityPercent, float* temperatureCelsiu
         return ERROR_TIMEOUT;
     }
 
-    //Lê os 40 bits de dados
-    if (readDataBits(dataPin, data) < 0) {
+    //Mede os 40 bits de dados
+    if (readPulseLengths(dataPin, pulseLengthsUs) < 0) {
         return ERROR_TIMEOUT;
     }
 
-    //Verifica checksum
-    if (verifyChecksum(data) < 0) {
-        return ERROR_CHECKSUM;
-    }
-
-    //Atribui valores de umidade e temperatura com uma casa decimal simulada
-    *humidityPercent = data[0] + (data[1] / 10.0);
-    *temperatureCelsius = data[2] + (data[3] / 10.0);
-    return 0;
+    return dht11_decode(pulseLengthsUs, humidityPercent, temperatureCelsius);
 }
@@ -6,4 +6,7 @@
 // Atualiza a assinatura da função para usar float em vez de uint8_t
 int dht11_read(uint8_t dataPin, float* humidityPercent, float* temperatureCelsius);
 
+// Decodifica as durações (µs) do nível alto dos 40 bits já medidos
+int dht11_decode(const uint8_t* pulseLengthsUs, float* humidityPercent, float* temperatureCelsius);
+
 #endif // DHT11_H
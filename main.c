@@ -4,7 +4,6 @@
 #include <stdbool.h>
 #include <math.h>
 #include "pico/stdlib.h"
-#include "hardware/adc.h"
 #include "hardware/gpio.h"
 #include "hardware/pwm.h"
 #include "hardware/i2c.h"
@@ -12,7 +11,29 @@
 #include "task.h"
 #include "lib/dht11/dht11.h" //Biblioteca para o sensor de temperatura e umidade DHT11
 #include "lib/Display_Bibliotecas/ssd1306.h" //Biblioteca para o display OLED SSD1306
+#include "lib/Display_Bibliotecas/grafico_tendencia.h" //Tendência de temperatura com rolagem incremental
+#include "lib/Barramento/barramento_i2c.h" //Árbitro do I2C compartilhado entre dispositivos
+#include "lib/Entrada/aquisicao_adc.h" //ADC em round-robin lido por DMA
+#include "lib/Entrada/botao_irq.h" //Botão por interrupção com debounce por alarme
+#include "lib/Entrada/joystick_adc.h" //Eventos de direção do joystick
 #include "lib/Matriz_Bibliotecas/matriz_led.h" //Biblioteca para a matriz de LEDs
+#include "lib/Controle/controle_pi.h" //Controlador PI
+#include "lib/Controle/autotune.h" //Autossintonia por relé
+#include "lib/Controle/passo_controle.h" //Decisões de cada período de controle, sem hardware
+#include "lib/Zonas/zonas.h" //Tabela de zonas de controle
+#include "lib/Rastro/rastro.h" //Gravação e reprodução determinística do controle
+#include "lib/Simulacao/malha_simulada.h" //Planta térmica simulada e ensaios em malha fechada
+#include "lib/Historico/historico.h" //Histórico de temperatura em múltiplas resoluções
+#include "lib/Armazenamento/log_historico.h" //Log persistente na flash
+#include "lib/Armazenamento/config_persistente.h" //Configuração preservada entre reinicializações
+#include "lib/Wifi/supervisor_wifi.h" //Conexão Wi-Fi assíncrona com reconexão automática
+#include "lib/Buzzer/sequenciador_tons.h" //Padrões de alerta sonoro tocados por alarme de hardware
+#include "lib/Metricas/metricas_periodo.h" //Período e jitter das tasks periódicas
+#include "lib/Metricas/metricas_lwip.h" //Uso do heap e dos pools do lwIP
+#include "lib/Web/pagina_web.h" //HTML do dashboard e cabeçalhos HTTP
+#include "lib/Web/cache_respostas.h" //Respostas montadas uma vez por versão do estado
+#include "lib/Web/rotas.h" //Tabela de rotas HTTP com hash perfeito
+#include "lib/Web/escritor_http.h" //Envio das respostas dentro do buffer TCP, com chunked e 503
 #include "pico/cyw43_arch.h"
 #include "lwip/tcp.h"
 #include "lwip/pbuf.h"
@@ -22,10 +43,15 @@
 //Configurações de Wi-Fi
 #define WIFI_NOME_REDE "Nome_rede"
 #define WIFI_SENHA     "Senha_rede"
+//IP fixo opcional: descomente para pular o DHCP
+//#define WIFI_IP_FIXO   "192.168.0.50"
+//#define WIFI_MASCARA   "255.255.255.0"
+//#define WIFI_GATEWAY   "192.168.0.1"
 
 //Pinos de hardware
 #define PINO_DHT11     16 //Pino do sensor DHT11 (temperatura e umidade)
 #define PINO_JOYSTICK_Y 26 //Pino do eixo Y do joystick (ADC0)
+#define ENTRADA_ADC_JOYSTICK (PINO_JOYSTICK_Y - 26)
 #define PINO_BOTAO_A    5 //Pino do botão A
 #define PINO_LED_AZUL  12 //Pino do LED azul (PWM)
 #define PINO_BUZZER    10 //Pino do buzzer (PWM)
@@ -39,45 +65,346 @@
 //Parâmetros de controle
 #define RPM_MINIMO     300.0f //RPM mínimo do motor simulado
 #define RPM_MAXIMO     2000.0f //RPM máximo do motor simulado
-#define TAMANHO_HISTORICO 60 //Tamanho do buffer de histórico de temperaturas
+#define SETPOINT_MINIMO 10 //Menor setpoint aceito por padrão (°C)
+#define SETPOINT_MAXIMO 30 //Maior setpoint aceito por padrão (°C)
+#define SETPOINT_LIMITE_INFERIOR 0  //Faixa em que PUT /api/controle pode mover esses limites (°C)
+#define SETPOINT_LIMITE_SUPERIOR 50
+#define KP_PADRAO      120.0f //Ganho proporcional inicial
+#define KI_PADRAO      (120.0f / 15.0f) //Ganho integral inicial
+#define LIMITE_INTEGRAL 4096.0f //Limite do termo integral
+#define KP_MAXIMO      1000.0f //Maiores ganhos aceitos por PUT /api/controle
+#define KI_MAXIMO      100.0f
+
+//Parâmetros da autossintonia
+#define SIMULACAO_DURACAO_MAX_S 86400.0f //Maior ensaio aceito por POST /api/simular (um dia simulado)
+#define SIMULACAO_TAU_MAX_S     3600.0f
+#define SIMULACAO_ATRASO_MAX_S  60.0f    //Cabe no anel de PLANTA_ATRASO_MAX passos de 1 s
+#define SIMULACAO_ESPERA_MS     100      //Intervalo em que a task de simulação procura um pedido
+#define TEMPO_BOTAO_LONGO_MS  2000 //Pressionar A por 2 s inicia a autossintonia
+
+//Entrada do usuário por eventos
+#define CONVERSOES_ADC_HZ     16000 //Taxa total do ADC; blocos de 64 conversões = 4 ms de latência
+#define JOYSTICK_LIMITE_BAIXO 1000  //Direção -1 abaixo deste valor
+#define JOYSTICK_LIMITE_ALTO  3000  //Direção +1 acima deste valor
+#define JOYSTICK_HISTERESE    200   //Volta ao centro só depois de recuar esta margem
+#define EVENTO_BOTAO_A        (1u << 0) //Bits de notificação da task de entrada
+#define EVENTO_JOYSTICK       (1u << 1)
+
+//Períodos das tasks, cumpridos por prazo absoluto (vTaskDelayUntil)
+#define PERIODO_CONTROLE_MS   1000 //Leitura dos sensores e passo do PI
+#define PERIODO_INTERFACE_MS  100  //Joystick, display e rede
+#define TEMPO_POR_TELA_MS     5000 //Rodízio das telas com o sistema ligado
+#define PAGINA_GRAFICO        2    //Tela de tendência: páginas 0-1 com texto, 2-7 com o gráfico
+
+//Configuração persistente
+#define ATRASO_GRAVACAO_CONFIG_MS 2000 //A configuração precisa ficar estável por 2 s antes de ir para a flash
+
+//Exportação do histórico persistente
+#define CONEXOES_EXPORTACAO   2 //Exportações simultâneas de /api/history (cada uma ocupa um bloco do escritor HTTP)
+
+//Memória das tasks (palavras de pilha) e das requisições HTTP
+#define PILHA_SENSOR          256
+#define PILHA_ENTRADA         512
+#define PILHA_CONTROLE        512
+#define PILHA_DISPLAY         512
+#define PILHA_REDE            1280
+#define PILHA_REGISTRO        512
+#define PILHA_SIMULACAO       512
+#define TAMANHO_MAX_REQUISICAO 1024 //Bytes da requisição copiados do pbuf; o restante é ignorado
+#define ESPERA_REQUISICAO_POLL 4    //Intervalos do tcp_poll (~2 s) à espera do restante de uma requisição
+#define TAMANHO_PAGINA        3072 //Corpo do dashboard
+#define TAMANHO_JSON_ESTATISTICAS 1024
+#define TAMANHO_JSON_ZONAS    2048
+#define TAMANHO_JSON_CONTROLE 256
+#define TAMANHO_JSON_METRICAS 3840
+
+//Com MEMORIA_ESTATICA as pilhas e TCBs são reservadas no .bss e aparecem no orçamento de RAM;
+//sem ela as tasks vêm do heap4 como antes
+#if MEMORIA_ESTATICA
+#define MEMORIA_TAREFA(nome, palavras) \
+    static StackType_t pilha_##nome[palavras]; \
+    static StaticTask_t tcb_##nome;
+#define PILHA_TAREFA(nome) pilha_##nome
+#define TCB_TAREFA(nome)   (&tcb_##nome)
+#else
+#define MEMORIA_TAREFA(nome, palavras)
+#define PILHA_TAREFA(nome) NULL
+#define TCB_TAREFA(nome)   NULL
+#endif
 
 //=== ESTRUTURAS E VARIÁVEIS GLOBAIS ===
+//Telas que se revezam no OLED enquanto o sistema está ligado
+typedef enum {
+    TELA_PRINCIPAL,
+    TELA_RPM,
+    TELA_TENDENCIA,
+    TELAS_RODIZIO
+} TelaOled;
+
 typedef struct {
     ssd1306_t display; //Estrutura do display OLED
-    float temperaturas[TAMANHO_HISTORICO]; //Histórico de temperaturas
-    int indice_temperatura; //Índice atual no buffer circular
-    int contador_temperaturas; //Contador de temperaturas armazenadas
-    float temperatura_ambiente; //Temperatura atual lida do DHT11
+    Historico historico; //Histórico de temperaturas (1 s, 1 min, 1 h)
+    ControlePrincipal controle; //Setpoint, ganhos, autossintonia e alarme da zona principal
     float umidade_ambiente; //Umidade atual lida do DHT11
-    int setpoint_temperatura; //Temperatura desejada (setpoint)
+    int setpoint_minimo; //Limites do ajuste de setpoint
+    int setpoint_maximo;
     uint16_t ciclo_pwm; //Ciclo de trabalho do PWM (0 a 65535)
     float rpm_atual; //RPM simulado do motor
-    bool modo_selecao; //Indica se está ajustando o setpoint
-    bool tela_principal; //Indica se exibe a tela principal no OLED
-    bool sistema_ligado; //Indica se o sistema de controle está ativo
-    uint canal_pwm_led; //Canal PWM do LED azul
-    uint fatia_pwm_led; //Fatia PWM do LED azul
+    TelaOled tela; //Tela do rodízio exibida no OLED
 } EstadoSistema;
 
 //Variável global para o estado do sistema
 static EstadoSistema estado = {
-    .indice_temperatura = 0,
-    .contador_temperaturas = 0,
-    .temperatura_ambiente = 0.0f,
+    .controle = {
+        .temperatura_ambiente = 0.0f,
+        .setpoint_temperatura = 20,
+        .modo_selecao = true,
+        .sistema_ligado = false,
+        .autotune_ativo = false,
+        .ganho_kp = KP_PADRAO,
+        .ganho_ki = KI_PADRAO,
+        .alarme = ALARME_NENHUM
+    },
     .umidade_ambiente = 0.0f,
-    .setpoint_temperatura = 20,
+    .setpoint_minimo = SETPOINT_MINIMO,
+    .setpoint_maximo = SETPOINT_MAXIMO,
     .ciclo_pwm = 0,
     .rpm_atual = RPM_MINIMO,
-    .modo_selecao = true,
-    .tela_principal = true,
-    .sistema_ligado = false
+    .tela = TELA_PRINCIPAL
 };
 
+//Tabela de zonas de controle; a zona 0 é a principal, ligada ao joystick, OLED e página web
+#define ZONA_PRINCIPAL 0
+
+typedef struct {
+    const char *nome;
+    TipoSensor tipo_sensor;
+    uint8_t pino_sensor;
+    uint8_t pino_pwm;
+    float setpoint;
+} ConfiguracaoZona;
+
+//Para adicionar uma zona basta incluir uma linha (até uma por fatia PWM).
+//Sensores analógicos: SENSOR_NTC nos pinos 27 ou 28 (o 26 é do joystick) ou
+//SENSOR_INTERNO, amostrados pelo ADC + DMA junto com o joystick
+static const ConfiguracaoZona CONFIGURACAO_ZONAS[] = {
+    {"Principal", SENSOR_DHT11, PINO_DHT11, PINO_LED_AZUL, 20.0f},
+};
+
+static TabelaZonas zonas;
+
+#if defined(PLANTA_SIMULADA) && PLANTA_SIMULADA
+//Build sem sensor: a zona principal lê a planta térmica acionada pelo próprio PWM
+static PlantaTermica planta_principal;
+#endif
+
+//Alertas sonoros por faixa de erro (NivelAlarme): cada padrão é tocado em laço pelo sequenciador
+static const NotaTom NOTAS_ALARME_LEVE[] = {{200, 300}, {0, 1000}};
+static const NotaTom NOTAS_ALARME_MODERADO[] = {{500, 200}, {0, 600}};
+static const NotaTom NOTAS_ALARME_CRITICO[] = {{1000, 100}, {0, 100}};
+
+static const struct {
+    const NotaTom *notas;
+    uint8_t quantidade;
+} PADROES_ALARME[] = {
+    [ALARME_NENHUM] = {NULL, 0},
+    [ALARME_LEVE] = {NOTAS_ALARME_LEVE, count_of(NOTAS_ALARME_LEVE)},
+    [ALARME_MODERADO] = {NOTAS_ALARME_MODERADO, count_of(NOTAS_ALARME_MODERADO)},
+    [ALARME_CRITICO] = {NOTAS_ALARME_CRITICO, count_of(NOTAS_ALARME_CRITICO)},
+};
+
+//Task que grava o log na flash logo após cada passo de controle
+static TaskHandle_t tarefa_registro = NULL;
+
+//Framebuffer do OLED fora do heap
+static uint8_t framebuffer_oled[SSD1306_TAMANHO_BUFFER(128, 64)];
+
+//I2C1 compartilhado: novos displays ou sensores entram como outro DispositivoI2C
+static BarramentoI2C barramento_i2c;
+static DispositivoI2C dispositivo_oled;
+
+//Tendência exibida no OLED, alimentada pelas amostras de 1 s do histórico
+static GraficoTendencia tendencia;
+static volatile uint32_t amostras_registradas = 0;
+
+MEMORIA_TAREFA(sensor, PILHA_SENSOR)
+MEMORIA_TAREFA(entrada, PILHA_ENTRADA)
+MEMORIA_TAREFA(controle, PILHA_CONTROLE)
+MEMORIA_TAREFA(display, PILHA_DISPLAY)
+MEMORIA_TAREFA(rede, PILHA_REDE)
+MEMORIA_TAREFA(registro, PILHA_REGISTRO)
+MEMORIA_TAREFA(simulacao, PILHA_SIMULACAO)
+
+//Período e jitter medidos de cada task periódica, expostos em /api/metricas
+typedef enum {
+    TAREFA_SENSOR,
+    TAREFA_CONTROLE,
+    TAREFA_DISPLAY,
+    TAREFA_REDE,
+    TAREFAS_PERIODICAS
+} TarefaPeriodica;
+
+static MetricasPeriodo metricas_tarefas[TAREFAS_PERIODICAS];
+
+//Entrada do usuário: a task só acorda com eventos do botão e do joystick
+static BotaoIrq botao_a;
+static JoystickAdc joystick;
+static struct {
+    uint32_t eventos;
+    uint32_t latencia_maxima_us; //Da detecção na interrupção até a task tratar
+    uint64_t soma_latencias_us;
+} metricas_entrada;
+
+//Configuração já gravada na flash e tempo de partida até a primeira saída PWM
+static ConfiguracaoPersistente configuracao_gravada;
+static bool configuracao_restaurada = false;
+static CacheWifi cache_wifi_restaurado; //BSSID/canal da última associação, para reconectar sem varredura
+static bool medir_partida = false; //Só quando a configuração restaurada já liga o sistema
+static uint64_t tempo_primeiro_pwm_us = 0; //Medido pelo temporizador do sistema, que parte do zero no reset
+
+//Versão do estado exibido: cada mudança incrementa e invalida as respostas em cache
+static volatile uint32_t versao_estado = 1;
+
+//Ensaio pedido por POST /api/simular: o callback do lwIP só valida e enfileira, a
+//task de simulação (prioridade do idle) executa e GET /api/simular consulta
+typedef enum {
+    SIMULACAO_OCIOSA,
+    SIMULACAO_NA_FILA,
+    SIMULACAO_EXECUTANDO,
+    SIMULACAO_CONCLUIDA,
+} EstadoSimulacao;
+
+static struct {
+    volatile EstadoSimulacao estado; //Muda por último: os campos abaixo já estão prontos
+    ParametrosPlanta planta;
+    EnsaioMalha ensaio;
+    ResultadoMalha resultado;
+    uint32_t duracao_us; //Tempo de parede, inclui as preempções pelas outras tasks
+} simulacao = {.estado = SIMULACAO_OCIOSA};
+
+//Rastro do controle enviado pela USB (linhas "rastro <hex>"), ligado por PUT /api/rastro?gravar=1
+static GravadorRastro gravador_rastro; //Só a task de controle grava
+static volatile bool gravar_rastro = false;
+
+//Cópias do passo de controle (só a task de controle usa): entradas como estavam no
+//início do período e o resultado do passo sobre elas
+static ControlePrincipal controle_capturado, controle_calculado;
+static TabelaZonas zonas_capturadas, zonas_calculadas;
+
 //=== FUNÇÕES AUXILIARES ===
+static void marcar_estado_alterado(void) {
+    //Chamado depois da mudança: uma resposta montada com a versão nova já a contém
+    versao_estado++;
+}
+
+static void capturar_configuracao(ConfiguracaoPersistente *config) {
+    //Reúne os parâmetros que sobrevivem a uma reinicialização
+    memset(config, 0, sizeof(*config));
+    config->setpoint = (int16_t)estado.controle.setpoint_temperatura;
+    config->setpoint_minimo = (int16_t)estado.setpoint_minimo;
+    config->setpoint_maximo = (int16_t)estado.setpoint_maximo;
+    config->ligado = estado.controle.sistema_ligado;
+    config->kp = estado.controle.ganho_kp;
+    config->ki = estado.controle.ganho_ki;
+    config->limite_integral = zonas.limite_integral;
+
+    CacheWifi cache;
+    if (supervisor_wifi_cache(&cache)) {
+        memcpy(config->wifi_bssid, cache.bssid, sizeof(config->wifi_bssid));
+        config->wifi_canal = cache.canal;
+    }
+}
+
+static bool restaurar_configuracao(void) {
+    //Aplica a configuração gravada se ela for coerente; senão mantém os valores padrão
+    ConfiguracaoPersistente config;
+    if (!config_carregar(&config)) {
+        return false;
+    }
+    if (config.setpoint_minimo < SETPOINT_LIMITE_INFERIOR || config.setpoint_maximo > SETPOINT_LIMITE_SUPERIOR ||
+        config.setpoint_minimo > config.setpoint_maximo ||
+        config.setpoint < config.setpoint_minimo || config.setpoint > config.setpoint_maximo ||
+        !isfinite(config.kp) || !isfinite(config.ki) || config.kp < 0.0f || config.ki < 0.0f ||
+        !isfinite(config.limite_integral) || config.limite_integral <= 0.0f) {
+        printf("Configuracao gravada invalida, usando valores padrao\n");
+        return false;
+    }
+    estado.controle.setpoint_temperatura = config.setpoint;
+    estado.setpoint_minimo = config.setpoint_minimo;
+    estado.setpoint_maximo = config.setpoint_maximo;
+    estado.controle.sistema_ligado = config.ligado;
+    estado.controle.modo_selecao = !config.ligado;
+    estado.controle.ganho_kp = config.kp;
+    estado.controle.ganho_ki = config.ki;
+    zonas.limite_integral = config.limite_integral;
+    memcpy(cache_wifi_restaurado.bssid, config.wifi_bssid, sizeof(cache_wifi_restaurado.bssid));
+    cache_wifi_restaurado.canal = config.wifi_canal;
+    configuracao_gravada = config;
+    return true;
+}
+
+static void registrar_primeira_saida(void) {
+    //Marca o instante da primeira saída PWM com o controle em operação. Sem
+    //configuração restaurada ligada, a primeira saída espera alguém ligar o
+    //sistema e não diz nada sobre a partida
+    if (medir_partida && !tempo_primeiro_pwm_us && estado.controle.sistema_ligado) {
+        tempo_primeiro_pwm_us = time_us_64();
+    }
+}
+
 void inicializar_hardware(void) {
     //Inicializa comunicação serial
     stdio_init_all();
-    
+
+    //Retoma o log persistente (também fornece a última saída antes do reset)
+    if (!log_inicializar()) {
+        printf("Firmware invade a regiao do log: historico persistente desativado\n");
+    }
+
+    //Restaura setpoint, ganhos, limites e o estado ligado antes de tocar nos periféricos lentos
+    zonas_inicializar(&zonas, LIMITE_INTEGRAL);
+    configuracao_restaurada = restaurar_configuracao();
+    if (!configuracao_restaurada) {
+        capturar_configuracao(&configuracao_gravada);
+    }
+    medir_partida = configuracao_restaurada && estado.controle.sistema_ligado;
+
+    //Configura sensores e saídas PWM de todas as zonas (a principal usa o LED azul)
+    for (size_t i = 0; i < count_of(CONFIGURACAO_ZONAS); i++) {
+        const ConfiguracaoZona *config = &CONFIGURACAO_ZONAS[i];
+        float setpoint = i == ZONA_PRINCIPAL ? (float)estado.controle.setpoint_temperatura : config->setpoint;
+        if (zonas_adicionar(&zonas, config->nome, config->tipo_sensor, config->pino_sensor,
+                            config->pino_pwm, setpoint, estado.controle.ganho_kp, estado.controle.ganho_ki) < 0) {
+            printf("Zona %s ignorada: tabela cheia ou canal PWM em uso\n", config->nome);
+        }
+    }
+#if defined(PLANTA_SIMULADA) && PLANTA_SIMULADA
+    static const ParametrosPlanta PLANTA = PLANTA_PADRAO;
+    planta_inicializar(&planta_principal, &PLANTA, PERIODO_CONTROLE_MS / 1000.0f, time_us_32());
+    zonas_simular(&zonas, ZONA_PRINCIPAL, &planta_principal);
+    printf("Zona principal usando a planta simulada\n");
+#endif
+
+    //Se o controle estava em operação, a zona principal volta imediatamente para a
+    //última saída registrada; o integrador parte desse valor e o PI assume sem salto
+    //assim que chegar a primeira leitura válida do sensor
+    if (estado.controle.sistema_ligado) {
+        RegistroLog ultimo;
+        zonas.ligada[ZONA_PRINCIPAL] = true;
+        if (log_ultimo_registro(&ultimo) && ultimo.ligado) {
+            float sinal = ultimo.ciclo_pwm * (2.0f * CONTROLE_PI_SAIDA_MAX / CONTROLE_PI_PWM_MAX) - CONTROLE_PI_SAIDA_MAX;
+            zonas.integral[ZONA_PRINCIPAL] = fmaxf(-zonas.limite_integral, fminf(zonas.limite_integral, sinal));
+            zonas.ciclo_pwm[ZONA_PRINCIPAL] = ultimo.ciclo_pwm;
+        }
+        zonas_aplicar_saidas(&zonas);
+        estado.ciclo_pwm = zonas.ciclo_pwm[ZONA_PRINCIPAL];
+        registrar_primeira_saida();
+    }
+
+    //Prepara o histórico de temperaturas
+    historico_inicializar(&estado.historico);
+    grafico_tendencia_inicializar(&tendencia, PAGINA_GRAFICO);
+
     //Inicializa matriz de LEDs
     inicializar_matriz_led();
 
@@ -89,25 +416,109 @@ void inicializar_hardware(void) {
     gpio_pull_up(PINO_I2C_SCL);
     
     //Inicializa o display OLED
-    ssd1306_init(&estado.display, 128, 64, false, ENDERECO_OLED, PORTA_I2C_OLED);
+    barramento_i2c_inicializar(&barramento_i2c, PORTA_I2C_OLED);
+    barramento_i2c_dispositivo(&dispositivo_oled, &barramento_i2c, ENDERECO_OLED, BARRAMENTO_I2C_PRIORIDADE_NORMAL);
+    ssd1306_init_buffer(&estado.display, 128, 64, false, ENDERECO_OLED, PORTA_I2C_OLED, framebuffer_oled);
+    ssd1306_set_transporte(&estado.display, barramento_i2c_transporte, &dispositivo_oled);
     ssd1306_config(&estado.display);
 
-    //Configura PWM para o LED azul
-    gpio_set_function(PINO_LED_AZUL, GPIO_FUNC_PWM);
-    estado.fatia_pwm_led = pwm_gpio_to_slice_num(PINO_LED_AZUL);
-    estado.canal_pwm_led = pwm_gpio_to_channel(PINO_LED_AZUL);
-    pwm_set_wrap(estado.fatia_pwm_led, 65535);
-    pwm_set_chan_level(estado.fatia_pwm_led, estado.canal_pwm_led, 0);
-    pwm_set_enabled(estado.fatia_pwm_led, true);
+    //Buzzer em silêncio até o primeiro alerta
+    sequenciador_tons_inicializar(PINO_BUZZER);
 }
 
-float calcular_media_temperaturas(void) {
-    //Calcula a média das temperaturas armazenadas no histórico
-    float soma = 0.0f;
-    for (int i = 0; i < estado.contador_temperaturas; i++) {
-        soma += estado.temperaturas[i];
+static void enviar_rastro(const uint8_t *dados, size_t tamanho) {
+    //Uma linha por período com registros inteiros: o leitor pode começar em qualquer linha com ESTADO
+    static const char HEX[] = "0123456789abcdef";
+    static char linha[2 * RASTRO_BLOCO_MAX + 1];
+    for (size_t i = 0; i < tamanho; i++) {
+        linha[2 * i] = HEX[dados[i] >> 4];
+        linha[2 * i + 1] = HEX[dados[i] & 0x0F];
     }
-    return estado.contador_temperaturas ? (soma / estado.contador_temperaturas) : 0.0f;
+    linha[2 * tamanho] = '\0';
+    printf("rastro %s\n", linha);
+}
+
+static void tocar_alarme(NivelAlarme nivel) {
+    //O passo de controle escolhe o nível pela faixa de erro; o sequenciador só é tocado quando ele muda
+    sequenciador_tons_tocar(PADROES_ALARME[nivel].notas, PADROES_ALARME[nivel].quantidade);
+}
+
+static void gravar_configuracao_se_alterada(void) {
+    //Grava só depois que a configuração fica estável, poupando a flash durante ajustes pelo joystick
+    static ConfiguracaoPersistente pendente;
+    static uint32_t alterada_em_ms = 0;
+    ConfiguracaoPersistente atual;
+    capturar_configuracao(&atual);
+    if (memcmp(&atual, &configuracao_gravada, sizeof(atual)) == 0) {
+        return;
+    }
+    uint32_t agora_ms = to_ms_since_boot(get_absolute_time());
+    if (memcmp(&atual, &pendente, sizeof(atual)) != 0) {
+        pendente = atual;
+        alterada_em_ms = agora_ms;
+        return;
+    }
+    if (agora_ms - alterada_em_ms < ATRASO_GRAVACAO_CONFIG_MS) {
+        return;
+    }
+    if (config_salvar(&atual)) {
+        configuracao_gravada = atual;
+    } else {
+        printf("Falha ao gravar a configuracao na flash\n");
+    }
+}
+
+static void capturar_entradas_controle(void) {
+    //Uma só cópia por período, com as interrupções desligadas: um comando da web ou uma
+    //leitura que chegue durante o passo entra inteira no período seguinte, e o rastro
+    //grava exatamente as entradas que o passo usa
+    taskENTER_CRITICAL();
+    controle_capturado = estado.controle;
+    zonas_capturadas = zonas;
+    taskEXIT_CRITICAL();
+    controle_calculado = controle_capturado;
+    zonas_calculadas = zonas_capturadas;
+}
+
+//Devolve o campo calculado se ninguém o mudou desde a captura; senão a mudança prevalece
+#define PUBLICAR_CAMPO(vivo, capturado, calculado, campo) \
+    do { \
+        if (memcmp(&(vivo).campo, &(capturado).campo, sizeof((vivo).campo)) == 0) { \
+            (vivo).campo = (calculado).campo; \
+        } \
+    } while (0)
+
+static void publicar_saidas_controle(void) {
+    //Só os campos que o passo escreve voltam ao estado compartilhado
+    taskENTER_CRITICAL();
+    PUBLICAR_CAMPO(estado.controle, controle_capturado, controle_calculado, ganho_kp);
+    PUBLICAR_CAMPO(estado.controle, controle_capturado, controle_calculado, ganho_ki);
+    if (estado.controle.autotune_ativo == controle_capturado.autotune_ativo &&
+        memcmp(&estado.controle.autotune, &controle_capturado.autotune, sizeof(estado.controle.autotune)) == 0) {
+        //Ensaio e flag andam juntos: um autotune pedido durante o passo não é sobrescrito
+        estado.controle.autotune = controle_calculado.autotune;
+        estado.controle.autotune_ativo = controle_calculado.autotune_ativo;
+    }
+    estado.controle.avaliador = controle_calculado.avaliador;
+    estado.controle.ligado_anterior = controle_calculado.ligado_anterior;
+    estado.controle.alarme = controle_calculado.alarme;
+    for (int i = 0; i < zonas.quantidade; i++) {
+        PUBLICAR_CAMPO(zonas, zonas_capturadas, zonas_calculadas, setpoint[i]);
+        PUBLICAR_CAMPO(zonas, zonas_capturadas, zonas_calculadas, kp[i]);
+        PUBLICAR_CAMPO(zonas, zonas_capturadas, zonas_calculadas, ki[i]);
+        PUBLICAR_CAMPO(zonas, zonas_capturadas, zonas_calculadas, ligada[i]);
+        PUBLICAR_CAMPO(zonas, zonas_capturadas, zonas_calculadas, saida_externa[i]);
+        zonas.integral[i] = zonas_calculadas.integral[i];
+        zonas.ciclo_pwm[i] = zonas_calculadas.ciclo_pwm[i];
+    }
+    taskEXIT_CRITICAL();
+}
+
+void iniciar_autotune(void) {
+    //Liga o sistema executando o ensaio do relé em torno do setpoint atual. Também roda
+    //no callback do lwIP: a mensagem sai da task de controle quando ela vê o ensaio
+    passo_controle_iniciar_autotune(&estado.controle);
+    marcar_estado_alterado();
 }
 
 void atualizar_tela_oled_selecao(void) {
@@ -115,7 +526,7 @@ void atualizar_tela_oled_selecao(void) {
     char texto[32];
     ssd1306_fill(&estado.display, false);
     ssd1306_draw_string(&estado.display, "Ajuste Setpoint:", 0, 0, false);
-    snprintf(texto, sizeof(texto), "   %2d °C", estado.setpoint_temperatura);
+    snprintf(texto, sizeof(texto), "   %2d °C", estado.controle.setpoint_temperatura);
     ssd1306_draw_string(&estado.display, texto, 0, 16, false);
     ssd1306_draw_string(&estado.display, "[A] Confirma", 0, 32, false);
     ssd1306_send_data(&estado.display);
@@ -125,18 +536,18 @@ void atualizar_tela_oled_principal(void) {
     //Exibe informações principais (temperatura, setpoint, erro, PWM)
     char texto[32];
     ssd1306_fill(&estado.display, false);
-    snprintf(texto, sizeof(texto), "Temp: %4.1f °C", estado.temperatura_ambiente);
+    snprintf(texto, sizeof(texto), "Temp: %4.1f °C", estado.controle.temperatura_ambiente);
     ssd1306_draw_string(&estado.display, texto, 0, 0, false);
-    snprintf(texto, sizeof(texto), "Set:  %3d °C", estado.setpoint_temperatura);
+    snprintf(texto, sizeof(texto), "Set:  %3d °C", estado.controle.setpoint_temperatura);
     ssd1306_draw_string(&estado.display, texto, 0, 16, false);
-    snprintf(texto, sizeof(texto), "Erro: %4.1f °C", (float)estado.setpoint_temperatura - estado.temperatura_ambiente);
+    snprintf(texto, sizeof(texto), "Erro: %4.1f °C", (float)estado.controle.setpoint_temperatura - estado.controle.temperatura_ambiente);
     ssd1306_draw_string(&estado.display, texto, 0, 32, false);
     snprintf(texto, sizeof(texto), "PWM:  %5u", estado.ciclo_pwm);
     ssd1306_draw_string(&estado.display, texto, 0, 48, false);
     ssd1306_send_data(&estado.display);
 
     //Atualiza a matriz de LEDs com base no erro
-    float erro = fabsf((float)estado.setpoint_temperatura - estado.temperatura_ambiente);
+    float erro = fabsf((float)estado.controle.setpoint_temperatura - estado.controle.temperatura_ambiente);
     int parte_inteira = (int)floorf(erro);
     float parte_decimal = erro - parte_inteira;
     int digito = (parte_decimal >= 0.6f) ? parte_inteira + 1 : parte_inteira;
@@ -180,303 +591,1131 @@ void atualizar_tela_oled_rpm(void) {
 
     snprintf(texto, sizeof(texto), "Min:%4.0f Max:%4.0f", RPM_MINIMO, RPM_MAXIMO);
     ssd1306_draw_string(&estado.display, texto, 0, 32, false);
-    const char *mensagem = (estado.temperatura_ambiente > estado.setpoint_temperatura) ? "ESFRIAR!!" : "ESQUENTAR!!";
+    const char *mensagem = (estado.controle.temperatura_ambiente > estado.controle.setpoint_temperatura) ? "ESFRIAR!!" : "ESQUENTAR!!";
     ssd1306_draw_string(&estado.display, mensagem, 0, 50, false);
     ssd1306_send_data(&estado.display);
 }
 
+void atualizar_tela_oled_tendencia(bool entrou) {
+    //Tendência dos últimos 128 s: o gráfico rola uma coluna por amostra e o texto
+    //só é refeito quando muda, então a maior parte das chamadas não envia nada
+    static char cabecalho_anterior[32];
+    char texto[32];
+    if (entrou) {
+        ssd1306_fill(&estado.display, false);
+        grafico_tendencia_invalidar(&tendencia);
+        cabecalho_anterior[0] = '\0';
+    }
+
+    snprintf(texto, sizeof(texto), "%4.1f C  %d-%d", estado.controle.temperatura_ambiente,
+             tendencia.escala_minima / 100, tendencia.escala_maxima / 100);
+    bool cabecalho_mudou = strcmp(texto, cabecalho_anterior) != 0;
+    if (cabecalho_mudou) {
+        ssd1306_rect(&estado.display, 0, 0, estado.display.width, PAGINA_GRAFICO * 8, false, true);
+        ssd1306_draw_string(&estado.display, texto, 0, 4, false);
+        strcpy(cabecalho_anterior, texto);
+    }
+    bool grafico_mudou = grafico_tendencia_desenhar(&tendencia, &estado.display);
+
+    if (cabecalho_mudou && grafico_mudou) {
+        ssd1306_send_data(&estado.display);
+    } else if (cabecalho_mudou) {
+        ssd1306_send_pages(&estado.display, 0, PAGINA_GRAFICO - 1);
+    } else if (grafico_mudou) {
+        ssd1306_send_pages(&estado.display, PAGINA_GRAFICO, estado.display.pages - 1);
+    }
+}
+
+void atualizar_tela_oled_autotune(void) {
+    //Exibe o andamento do ensaio do relé
+    char texto[32];
+    ssd1306_fill(&estado.display, false);
+    ssd1306_draw_string(&estado.display, "Autotune rele", 0, 0, false);
+    snprintf(texto, sizeof(texto), "Ciclos: %d/%d", estado.controle.autotune.ciclos, estado.controle.autotune.ciclos_desejados + 1);
+    ssd1306_draw_string(&estado.display, texto, 0, 16, false);
+    snprintf(texto, sizeof(texto), "Temp: %4.1f °C", estado.controle.temperatura_ambiente);
+    ssd1306_draw_string(&estado.display, texto, 0, 32, false);
+    snprintf(texto, sizeof(texto), "Rele: %s", estado.controle.autotune.saida_alta ? "ALTO" : "BAIXO");
+    ssd1306_draw_string(&estado.display, texto, 0, 48, false);
+    ssd1306_send_data(&estado.display);
+}
+
 //=== taskS DO FreeRTOS ===
 void task_leitura_sensor(void *parametros) {
-    //Configura o pino do sensor DHT11
-    gpio_init(PINO_DHT11);
-    
+    TickType_t proxima_liberacao = xTaskGetTickCount();
+
     while (true) {
-        if (estado.sistema_ligado) {
-            float umidade, temperatura;
-            //Lê temperatura e umidade do sensor DHT11
-            if (dht11_read(PINO_DHT11, &umidade, &temperatura) == 0) {
-                estado.temperatura_ambiente = temperatura;
-                estado.umidade_ambiente = umidade;
-                //Armazena a temperatura no buffer circular
-                estado.temperaturas[estado.indice_temperatura] = temperatura;
-                estado.indice_temperatura = (estado.indice_temperatura + 1) % TAMANHO_HISTORICO;
-                if (estado.contador_temperaturas < TAMANHO_HISTORICO) {
-                    estado.contador_temperaturas++;
-                }
-            }
+        metricas_periodo_marcar(&metricas_tarefas[TAREFA_SENSOR]);
+
+        //Lê os sensores de todas as zonas ligadas (a principal acompanha o sistema)
+        zonas.ligada[ZONA_PRINCIPAL] = estado.controle.sistema_ligado;
+        zonas_ler_sensores(&zonas);
+
+        if (estado.controle.sistema_ligado && zonas.leitura_valida[ZONA_PRINCIPAL]) {
+            float temperatura = zonas.temperatura[ZONA_PRINCIPAL];
+            estado.controle.temperatura_ambiente = temperatura;
+            estado.umidade_ambiente = zonas.umidade[ZONA_PRINCIPAL];
+            //Armazena a temperatura no histórico (agregados atualizados incrementalmente)
+            historico_registrar(&estado.historico, temperatura, to_ms_since_boot(get_absolute_time()) / 1000);
+            amostras_registradas++;
+            marcar_estado_alterado();
         }
-        vTaskDelay(pdMS_TO_TICKS(1000)); //Aguarda 1 segundo
+        metricas_periodo_concluir(&metricas_tarefas[TAREFA_SENSOR]);
+        //Prazo absoluto: a duração da leitura do DHT11 não desloca o próximo período
+        vTaskDelayUntil(&proxima_liberacao, pdMS_TO_TICKS(PERIODO_CONTROLE_MS));
+    }
+}
+
+static void registrar_latencia_entrada(uint64_t instante_evento_us) {
+    uint32_t latencia = (uint32_t)(time_us_64() - instante_evento_us);
+    metricas_entrada.eventos++;
+    metricas_entrada.soma_latencias_us += latencia;
+    if (latencia > metricas_entrada.latencia_maxima_us) {
+        metricas_entrada.latencia_maxima_us = latencia;
     }
 }
 
 void task_entrada_usuario(void *parametros) {
-    //Inicializa ADC para o joystick e configura o botão
-    adc_init();
-    adc_gpio_init(PINO_JOYSTICK_Y);
-    adc_select_input(0);
-    gpio_init(PINO_BOTAO_A);
-    gpio_set_dir(PINO_BOTAO_A, GPIO_IN);
-    gpio_pull_up(PINO_BOTAO_A);
+    //Botão por interrupção e joystick por ADC + DMA; a task dorme até um evento
+    TaskHandle_t esta_tarefa = xTaskGetCurrentTaskHandle();
+    botao_irq_iniciar(&botao_a, PINO_BOTAO_A, esta_tarefa, EVENTO_BOTAO_A);
+    joystick_adc_iniciar(&joystick, ENTRADA_ADC_JOYSTICK, JOYSTICK_LIMITE_BAIXO, JOYSTICK_LIMITE_ALTO,
+                         JOYSTICK_HISTERESE, esta_tarefa, EVENTO_JOYSTICK);
+    //Também inicia os sensores analógicos que as zonas registraram
+    aquisicao_adc_iniciar(CONVERSOES_ADC_HZ);
 
-    bool botao_anterior = false;
-    int direcao_anterior = 0;
+    //Os contadores não perdem toques mais curtos que o tempo de resposta da task
+    uint32_t pressoes_vistas = botao_a.pressoes;
+    uint32_t subidas_vistas = joystick.subidas;
+    uint32_t descidas_vistas = joystick.descidas;
+    uint64_t inicio_pressao_us = 0;
+    bool ligou_nesta_pressao = false;
 
     while (true) {
-        //Lê o valor do joystick (eixo Y) e o estado do botão
-        uint16_t valor_adc = adc_read();
-        bool botao_atual = (gpio_get(PINO_BOTAO_A) == 0);
-        int direcao = (valor_adc > 3000 ? 1 : (valor_adc < 1000 ? -1 : 0));
+        //Só acorda por tempo enquanto uma pressão longa ainda pode completar
+        TickType_t espera = portMAX_DELAY;
+        if (ligou_nesta_pressao) {
+            uint32_t decorrido_ms = (uint32_t)((time_us_64() - inicio_pressao_us) / 1000);
+            espera = decorrido_ms >= TEMPO_BOTAO_LONGO_MS ? 0 : pdMS_TO_TICKS(TEMPO_BOTAO_LONGO_MS - decorrido_ms);
+        }
+        uint32_t eventos = 0;
+        xTaskNotifyWait(0, UINT32_MAX, &eventos, espera);
+
+        if (eventos & EVENTO_BOTAO_A) {
+            registrar_latencia_entrada(botao_a.instante_us);
+        }
+        if (eventos & EVENTO_JOYSTICK) {
+            registrar_latencia_entrada(joystick.instante_us);
+        }
+
+        uint32_t pressoes = botao_a.pressoes;
+        bool nova_pressao = pressoes != pressoes_vistas;
+        pressoes_vistas = pressoes;
+        uint32_t subidas = joystick.subidas - subidas_vistas;
+        uint32_t descidas = joystick.descidas - descidas_vistas;
+        subidas_vistas += subidas;
+        descidas_vistas += descidas;
+        bool alterou = nova_pressao || subidas || descidas;
 
         //Ajusta o setpoint apenas no modo de seleção e com sistema desligado
-        if (estado.modo_selecao && !estado.sistema_ligado) {
-            if (direcao == 1 && direcao_anterior == 0 && estado.setpoint_temperatura < 30) {
-                estado.setpoint_temperatura++;
+        if (estado.controle.modo_selecao && !estado.controle.sistema_ligado) {
+            while (subidas-- > 0 && estado.controle.setpoint_temperatura < estado.setpoint_maximo) {
+                estado.controle.setpoint_temperatura++;
             }
-            if (direcao == -1 && direcao_anterior == 0 && estado.setpoint_temperatura > 10) {
-                estado.setpoint_temperatura--;
+            while (descidas-- > 0 && estado.controle.setpoint_temperatura > estado.setpoint_minimo) {
+                estado.controle.setpoint_temperatura--;
             }
-            if (botao_atual && !botao_anterior) {
-                estado.modo_selecao = false;
-                estado.sistema_ligado = true;
+            if (nova_pressao) {
+                estado.controle.modo_selecao = false;
+                estado.controle.sistema_ligado = true;
+                ligou_nesta_pressao = true;
+                inicio_pressao_us = botao_a.instante_us;
             }
-        } else if (botao_atual && !botao_anterior) {
-            estado.modo_selecao = true;
-            estado.sistema_ligado = false;
+        } else if (nova_pressao) {
+            estado.controle.modo_selecao = true;
+            estado.controle.sistema_ligado = false;
+        } else if (botao_a.pressionado && ligou_nesta_pressao &&
+                   time_us_64() - inicio_pressao_us >= TEMPO_BOTAO_LONGO_MS * 1000ull) {
+            //Pressão longa na confirmação troca o controle PI pela autossintonia
+            ligou_nesta_pressao = false;
+            iniciar_autotune();
+        }
+        if (!botao_a.pressionado) {
+            ligou_nesta_pressao = false;
+        }
+        if (alterou) {
+            marcar_estado_alterado();
         }
-
-        botao_anterior = botao_atual;
-        direcao_anterior = direcao;
-        vTaskDelay(pdMS_TO_TICKS(100)); //Aguarda 100ms para debounce
     }
 }
 
-void task_controle_pi(void *parametros) {
-    //Parâmetros do controlador PI
-    const float kp = 120.0f; //Ganho proporcional
-    const float ki = 120.0f / 15.0f; //Ganho integral
-    const float intervalo = 1.0f; //Intervalo de amostragem (1s)
-    float integral = 0.0f;
+void task_controle_zonas(void *parametros) {
+    //Uma única task executa o PI de todas as zonas a cada período
+    const float intervalo_nominal = PERIODO_CONTROLE_MS / 1000.0f;
+    bool tempo_partida_informado = false;
+    bool gravando_rastro = false;
+    bool autotune_visto = false; //Ensaio ativo na captura anterior
+    TickType_t proxima_liberacao = xTaskGetTickCount();
 
-    pwm_set_chan_level(estado.fatia_pwm_led, estado.canal_pwm_led, 0);
+    zonas_aplicar_saidas(&zonas);
 
     while (true) {
-        if (estado.sistema_ligado) {
-            //Calcula o erro entre a temperatura desejada e a atual
-            float erro = estado.temperatura_ambiente - (float)estado.setpoint_temperatura;
-            float termo_proporcional = kp * erro;
-            integral += ki * erro * intervalo;
-            integral = fmaxf(fminf(integral, 4096.0f), -4096.0f); //Limita o termo integral
-
-            //Calcula o sinal de controle e converte para ciclo de trabalho PWM
-            float sinal_controle = termo_proporcional + integral;
-            int32_t ciclo = (int32_t)((sinal_controle + 4096.0f) * (65535.0f / 8192.0f));
-            ciclo = ciclo < 0 ? 0 : (ciclo > 65535 ? 65535 : ciclo);
-            estado.ciclo_pwm = ciclo;
+        //O PI integra o intervalo realmente decorrido; atrasos anormais (ex.: gravação
+        //na flash) são limitados a dois períodos para não saturar o integrador
+        float intervalo = metricas_periodo_marcar(&metricas_tarefas[TAREFA_CONTROLE]) / 1000000.0f;
+        if (intervalo > 2.0f * intervalo_nominal) {
+            intervalo = 2.0f * intervalo_nominal;
+        }
+
+        //O rastro e o passo trabalham sobre a mesma cópia das entradas
+        capturar_entradas_controle();
+        if (controle_capturado.autotune_ativo && !autotune_visto) {
+            printf("Autotune iniciado em %d °C\n", controle_capturado.setpoint_temperatura);
+        }
+        autotune_visto = controle_capturado.autotune_ativo;
+        if (gravar_rastro != gravando_rastro) {
+            gravando_rastro = gravar_rastro;
+            if (gravando_rastro) {
+                rastro_gravador_iniciar(&gravador_rastro);
+            }
+        }
+        bool rastro_completo = gravando_rastro &&
+            rastro_gravar_entradas(&gravador_rastro, &controle_calculado, &zonas_calculadas, ZONA_PRINCIPAL,
+                                   to_ms_since_boot(get_absolute_time()), intervalo);
 
+        //Autossintonia, avaliação, PI de todas as zonas e alarme
+        uint32_t eventos = passo_controle_executar(&controle_calculado, &zonas_calculadas, ZONA_PRINCIPAL, intervalo);
+        publicar_saidas_controle();
+        if (gravando_rastro) {
+            rastro_completo &= rastro_gravar_saidas(&gravador_rastro, &controle_calculado, &zonas_calculadas);
+            if (rastro_completo) {
+                enviar_rastro(gravador_rastro.bloco, gravador_rastro.tamanho);
+            } else {
+                printf("Rastro: periodo nao coube no bloco, gravacao interrompida\n");
+                gravar_rastro = gravando_rastro = false;
+            }
+        }
+        zonas_aplicar_saidas(&zonas);
+        registrar_primeira_saida();
+        if (tempo_primeiro_pwm_us && !tempo_partida_informado) {
+            printf("Primeira saida PWM %llu us apos o reset (configuracao restaurada)\n",
+                   (unsigned long long)tempo_primeiro_pwm_us);
+            tempo_partida_informado = true;
+        }
+        if (eventos & PASSO_AUTOTUNE_CONCLUIDO) {
+            printf("Autotune: Ku=%.1f Pu=%.1fs -> Kp=%.2f Ki=%.3f\n", controle_calculado.autotune.ganho_critico,
+                   controle_calculado.autotune.periodo_critico_s, controle_calculado.ganho_kp, controle_calculado.ganho_ki);
+        }
+        if (eventos & PASSO_AUTOTUNE_FALHOU) {
+            printf("Autotune falhou, mantendo Kp=%.2f Ki=%.3f\n", controle_calculado.ganho_kp, controle_calculado.ganho_ki);
+        }
+        if (eventos & PASSO_ACOMODOU) {
+            printf("Resposta: acomodacao=%.0fs sobressinal=%.1f °C\n",
+                   controle_calculado.avaliador.tempo_acomodacao_s, controle_calculado.avaliador.sobressinal);
+        }
+        if (eventos & PASSO_ALARME_MUDOU) {
+            tocar_alarme(controle_calculado.alarme);
+        }
+
+        //Reflete a zona principal no estado exibido
+        estado.ciclo_pwm = zonas.ciclo_pwm[ZONA_PRINCIPAL];
+        if (estado.controle.sistema_ligado) {
             //Atualiza o RPM simulado com base no ciclo PWM
             estado.rpm_atual = RPM_MINIMO + (RPM_MAXIMO - RPM_MINIMO) * (estado.ciclo_pwm / 65535.0f);
-            pwm_set_chan_level(estado.fatia_pwm_led, estado.canal_pwm_led, estado.ciclo_pwm);
         } else {
-            //Reseta o controlador e desliga o PWM quando o sistema está desligado
-            integral = 0.0f;
-            estado.ciclo_pwm = 0;
             estado.rpm_atual = RPM_MINIMO;
-            pwm_set_chan_level(estado.fatia_pwm_led, estado.canal_pwm_led, 0);
         }
-        vTaskDelay(pdMS_TO_TICKS(1000)); //Aguarda 1 segundo
+        marcar_estado_alterado();
+
+        //Gravações na flash acontecem logo após o passo, longe do próximo período
+        if (tarefa_registro) {
+            xTaskNotifyGive(tarefa_registro);
+        }
+        metricas_periodo_concluir(&metricas_tarefas[TAREFA_CONTROLE]);
+        vTaskDelayUntil(&proxima_liberacao, pdMS_TO_TICKS(PERIODO_CONTROLE_MS));
     }
 }
 
-void task_buzzer_alerta(void *parametros) {
-    //Configura o buzzer como saída PWM
-    gpio_set_function(PINO_BUZZER, GPIO_FUNC_PWM);
-    uint fatia_pwm = pwm_gpio_to_slice_num(PINO_BUZZER);
-    uint canal_pwm = pwm_gpio_to_channel(PINO_BUZZER);
-    pwm_set_enabled(fatia_pwm, true);
+void task_registro_historico(void *parametros) {
+    while (true) {
+        //Aguarda o aviso da task de controle
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        gravar_configuracao_se_alterada();
+        if (!estado.controle.sistema_ligado) {
+            continue;
+        }
+
+        RegistroLog registro = {
+            .tempo_s = log_tempo_atual(),
+            .temperatura_centi = (int16_t)lroundf(estado.controle.temperatura_ambiente * 100.0f),
+            .umidade_deci = (uint16_t)lroundf(estado.umidade_ambiente * 10.0f),
+            .ciclo_pwm = estado.ciclo_pwm,
+            .setpoint_deci = (int16_t)(estado.controle.setpoint_temperatura * 10),
+            .ligado = 1
+        };
+        log_adicionar(&registro);
+    }
+}
 
+void task_simulacao_malha(void *parametros) {
+    //Roda abaixo de todas as outras tasks, então um ensaio longo só ocupa o tempo ocioso.
+    //O pedido chega do contexto do lwIP por um flag, conferido a cada SIMULACAO_ESPERA_MS
     while (true) {
-        if (estado.sistema_ligado && !estado.modo_selecao) {
-            //Calcula o erro absoluto da temperatura
-            float erro = fabsf(estado.temperatura_ambiente - (float)estado.setpoint_temperatura);
-            if (erro > 9.6f) {
-                //Alarme rápido para erro crítico
-                pwm_set_clkdiv(fatia_pwm, 125.0f / 1000.0f);
-                pwm_set_wrap(fatia_pwm, 1000);
-                pwm_set_chan_level(fatia_pwm, canal_pwm, 500);
-                pwm_set_enabled(fatia_pwm, true);
-                vTaskDelay(pdMS_TO_TICKS(100));
-                pwm_set_enabled(fatia_pwm, false);
-                vTaskDelay(pdMS_TO_TICKS(100));
-            } else if (erro >= 3.6f) {
-                //Alarme moderado para erro médio
-                pwm_set_clkdiv(fatia_pwm, 125.0f / 500.0f);
-                pwm_set_wrap(fatia_pwm, 1000);
-                pwm_set_chan_level(fatia_pwm, canal_pwm, 500);
-                pwm_set_enabled(fatia_pwm, true);
-                vTaskDelay(pdMS_TO_TICKS(200));
-                pwm_set_enabled(fatia_pwm, false);
-                vTaskDelay(pdMS_TO_TICKS(600));
-            } else {
-                //Alarme lento para erro baixo
-                pwm_set_clkdiv(fatia_pwm, 125.0f / 200.0f);
-                pwm_set_wrap(fatia_pwm, 1000);
-                pwm_set_chan_level(fatia_pwm, canal_pwm, 500);
-                pwm_set_enabled(fatia_pwm, true);
-                vTaskDelay(pdMS_TO_TICKS(300));
-                pwm_set_enabled(fatia_pwm, false);
-                vTaskDelay(pdMS_TO_TICKS(1000));
-            }
-        } else {
-            pwm_set_enabled(fatia_pwm, false);
-            vTaskDelay(pdMS_TO_TICKS(100));
+        if (simulacao.estado != SIMULACAO_NA_FILA) {
+            vTaskDelay(pdMS_TO_TICKS(SIMULACAO_ESPERA_MS));
+            continue;
         }
+        simulacao.estado = SIMULACAO_EXECUTANDO;
+        uint64_t inicio = time_us_64();
+        malha_simulada_executar(&simulacao.planta, &simulacao.ensaio, &simulacao.resultado, NULL, NULL);
+        simulacao.duracao_us = (uint32_t)(time_us_64() - inicio);
+        simulacao.estado = SIMULACAO_CONCLUIDA;
     }
 }
 
 void task_atualizar_display(void *parametros) {
     uint32_t ultima_troca = to_ms_since_boot(get_absolute_time());
+    TickType_t proxima_liberacao = xTaskGetTickCount();
+    uint32_t amostras_vistas = 0;
+    bool tendencia_visivel = false;
 
     while (true) {
+        metricas_periodo_marcar(&metricas_tarefas[TAREFA_DISPLAY]);
+
+        //Passa as amostras novas do histórico para o gráfico, mesmo com outra tela visível
+        uint32_t novas = amostras_registradas - amostras_vistas;
+        amostras_vistas += novas;
+        uint16_t disponiveis = historico_quantidade(&estado.historico, NIVEL_SEGUNDOS);
+        if (novas > disponiveis) novas = disponiveis;
+        while (novas > 0) {
+            novas--;
+            grafico_tendencia_adicionar(&tendencia, historico_amostra(&estado.historico, NIVEL_SEGUNDOS, novas) / 100.0f);
+        }
+
         //Alterna entre telas a cada 5 segundos quando o sistema está ligado
         uint32_t agora = to_ms_since_boot(get_absolute_time());
-        if (estado.sistema_ligado && !estado.modo_selecao && agora - ultima_troca > 5000) {
-            estado.tela_principal = !estado.tela_principal;
+        if (estado.controle.sistema_ligado && !estado.controle.modo_selecao && agora - ultima_troca > TEMPO_POR_TELA_MS) {
+            estado.tela = (TelaOled)((estado.tela + 1) % TELAS_RODIZIO);
             ultima_troca = agora;
         }
 
         //Exibe a tela apropriada com base no estado do sistema
-        if (estado.modo_selecao || !estado.sistema_ligado) {
+        bool exibindo_tendencia = false;
+        if (estado.controle.modo_selecao || !estado.controle.sistema_ligado) {
             atualizar_tela_oled_selecao();
-        } else if (estado.tela_principal) {
+        } else if (estado.controle.autotune_ativo) {
+            atualizar_tela_oled_autotune();
+        } else if (estado.tela == TELA_PRINCIPAL) {
             atualizar_tela_oled_principal();
-        } else {
+        } else if (estado.tela == TELA_RPM) {
             atualizar_tela_oled_rpm();
+        } else {
+            atualizar_tela_oled_tendencia(!tendencia_visivel);
+            exibindo_tendencia = true;
         }
+        tendencia_visivel = exibindo_tendencia;
 
-        vTaskDelay(pdMS_TO_TICKS(100)); //Aguarda 100ms
+        metricas_periodo_concluir(&metricas_tarefas[TAREFA_DISPLAY]);
+        vTaskDelayUntil(&proxima_liberacao, pdMS_TO_TICKS(PERIODO_INTERFACE_MS));
     }
 }
 
-static err_t callback_envio_web(void *arg, struct tcp_pcb *tpcb, uint16_t len) {
-    //Fecha a conexão TCP após o envio dos dados
-    tcp_close(tpcb);
-    return ERR_OK;
+typedef enum {
+    EXPORTACAO_CSV,
+    EXPORTACAO_JSON,
+    EXPORTACAO_BINARIA //Blocos do codec_amostras, decodificados por ferramentas/decodificar_historico
+} FormatoExportacao;
+
+typedef struct {
+    bool em_uso;
+    FormatoExportacao formato;
+    bool iniciada; //Preâmbulo (assinatura, colunas) já entregue ao escritor
+    bool primeiro; //Ainda não enviou nenhuma amostra (controle da vírgula no JSON)
+    bool concluida; //Rodapé já formatado
+    bool retida; //Amostra lida do cursor que não coube no bloco binário anterior
+    RegistroLog amostra_retida;
+    CursorLog cursor;
+    uint32_t agora; //Instante da requisição, repetido no preâmbulo JSON
+} ExportacaoHistorico;
+
+static ExportacaoHistorico exportacoes[CONEXOES_EXPORTACAO];
+
+static size_t formatar_bloco_binario(ExportacaoHistorico *exportacao, uint8_t *bloco, size_t tamanho) {
+    //Bloco: quantidade de amostras e bytes (16 bits, little-endian) seguidos do fluxo comprimido
+    CodificadorAmostras codificador;
+    codec_iniciar_codificador(&codificador, bloco + 4, tamanho - 4);
+    if (exportacao->retida) {
+        codec_codificar(&codificador, &exportacao->amostra_retida);
+        exportacao->retida = false;
+    }
+    while (log_cursor_proximo(&exportacao->cursor, &exportacao->amostra_retida)) {
+        if (!codec_codificar(&codificador, &exportacao->amostra_retida)) {
+            exportacao->retida = true;
+            break;
+        }
+    }
+    exportacao->concluida = exportacao->cursor.fim && !exportacao->retida;
+
+    uint16_t bytes = codec_bytes_usados(&codificador);
+    bloco[0] = codificador.amostras & 0xFF;
+    bloco[1] = codificador.amostras >> 8;
+    bloco[2] = bytes & 0xFF;
+    bloco[3] = bytes >> 8;
+    return codificador.amostras ? 4 + bytes : 0;
+}
+
+static size_t formatar_bloco_exportacao(ExportacaoHistorico *exportacao, char *bloco, size_t tamanho) {
+    //Formata registros do cursor até encher o bloco
+    if (exportacao->formato == EXPORTACAO_BINARIA) {
+        return formatar_bloco_binario(exportacao, (uint8_t *)bloco, tamanho);
+    }
+    bool json = exportacao->formato == EXPORTACAO_JSON;
+    int usado = 0;
+    RegistroLog registro;
+    while (usado < (int)tamanho - 96 && log_cursor_proximo(&exportacao->cursor, &registro)) {
+        usado += snprintf(bloco + usado, tamanho - usado,
+            json ? "%s[%lu,%.2f,%.1f,%u,%.1f,%u]" : "%s%lu,%.2f,%.1f,%u,%.1f,%u\n",
+            json && !exportacao->primeiro ? "," : "",
+            (unsigned long)registro.tempo_s, registro.temperatura_centi / 100.0f, registro.umidade_deci / 10.0f,
+            registro.ciclo_pwm, registro.setpoint_deci / 10.0f, registro.ligado);
+        exportacao->primeiro = false;
+    }
+    if (exportacao->cursor.fim) {
+        if (json) {
+            usado += snprintf(bloco + usado, tamanho - usado, "]}\n");
+        }
+        exportacao->concluida = true;
+    }
+    return usado;
+}
+
+static size_t gerar_exportacao(void *contexto, char *destino, size_t tamanho) {
+    //Gerador do escritor: preâmbulo, blocos do cursor e 0 no fim; a RAM não cresce com o intervalo pedido
+    ExportacaoHistorico *exportacao = contexto;
+    if (!exportacao->iniciada) {
+        exportacao->iniciada = true;
+        if (exportacao->formato == EXPORTACAO_BINARIA) {
+            //Assinatura e versão do formato; os blocos seguem até o fim do corpo
+            memcpy(destino, "TGH1", 4);
+            return 4;
+        }
+        if (exportacao->formato == EXPORTACAO_JSON) {
+            return snprintf(destino, tamanho,
+                "{\"agora\":%lu,\"colunas\":[\"tempo\",\"temperatura\",\"umidade\",\"pwm\",\"setpoint\",\"ligado\"],\"amostras\":[",
+                (unsigned long)exportacao->agora);
+        }
+        return snprintf(destino, tamanho, "tempo,temperatura,umidade,pwm,setpoint,ligado\n");
+    }
+    while (!exportacao->concluida) {
+        size_t usado = formatar_bloco_exportacao(exportacao, destino, tamanho);
+        if (usado) {
+            return usado;
+        }
+    }
+    return 0;
+}
+
+static void encerrar_exportacao(void *contexto, bool concluida) {
+    //Resposta terminada ou conexão perdida: libera o cursor
+    ((ExportacaoHistorico *)contexto)->em_uso = false;
+}
+
+static int montar_pagina_html(char *corpo, size_t tamanho) {
+    //Copia os valores exibidos; a formatação fica em lib/Web
+    ResumoPagina resumo = {
+        .sistema_ligado = estado.controle.sistema_ligado,
+        .autotune_ativo = estado.controle.autotune_ativo,
+        .setpoint = estado.controle.setpoint_temperatura,
+        .setpoint_minimo = estado.setpoint_minimo,
+        .setpoint_maximo = estado.setpoint_maximo,
+        .temperatura = estado.controle.temperatura_ambiente,
+        .umidade = estado.umidade_ambiente,
+        .ciclo_pwm = estado.ciclo_pwm,
+        .rpm = estado.rpm_atual == RPM_MINIMO ? 0.0f : estado.rpm_atual,
+        .kp = estado.controle.ganho_kp,
+        .ki = estado.controle.ganho_ki,
+        .autotune_concluido = estado.controle.autotune.estado == AUTOTUNE_CONCLUIDO,
+        .autotune_falhou = estado.controle.autotune.estado == AUTOTUNE_FALHOU,
+        .ganho_critico = estado.controle.autotune.ganho_critico,
+        .periodo_critico_s = estado.controle.autotune.periodo_critico_s,
+        .avaliacao_concluida = estado.controle.avaliador.concluido,
+        .avaliacao_ativa = estado.controle.avaliador.ativo,
+        .tempo_acomodacao_s = estado.controle.avaliador.tempo_acomodacao_s,
+        .sobressinal = estado.controle.avaliador.sobressinal,
+        .tempo_avaliacao_s = estado.controle.avaliador.tempo_s,
+    };
+    historico_estatisticas(&estado.historico, NIVEL_SEGUNDOS, &resumo.recentes);
+    return pagina_web_montar(&resumo, corpo, tamanho);
+}
+
+static err_t responder_erro(struct tcp_pcb *tpcb, const char *status, const char *mensagem) {
+    //Erros da API em JSON: {"erro":"..."}
+    char corpo[160];
+    int tamanho = snprintf(corpo, sizeof(corpo), "{\"erro\":\"%s\"}", mensagem);
+    return escritor_http_copia(tpcb, status, "application/json", NULL, corpo, LWIP_MIN(tamanho, (int)sizeof(corpo) - 1));
+}
+
+//Respostas compartilhadas: o dashboard e os JSON que só mudam com o estado
+static char buffers_pagina[CACHE_RESPOSTA_COPIAS][CACHE_RESPOSTA_CABECALHO + TAMANHO_PAGINA];
+static char buffers_estatisticas[CACHE_RESPOSTA_COPIAS][CACHE_RESPOSTA_CABECALHO + TAMANHO_JSON_ESTATISTICAS];
+static char buffers_zonas[CACHE_RESPOSTA_COPIAS][CACHE_RESPOSTA_CABECALHO + TAMANHO_JSON_ZONAS];
+static char buffers_controle[CACHE_RESPOSTA_COPIAS][CACHE_RESPOSTA_CABECALHO + TAMANHO_JSON_CONTROLE];
+static RespostaCache cache_pagina;
+static RespostaCache cache_estatisticas;
+static RespostaCache cache_zonas;
+static RespostaCache cache_controle;
+
+static void liberar_copia(void *contexto, bool concluida) {
+    cache_resposta_liberar(contexto);
+}
+
+static err_t responder_com_cache(struct tcp_pcb *tpcb, RespostaCache *cache) {
+    //Clientes na mesma versão do estado recebem o mesmo buffer, sem montar nem copiar;
+    //com as duas cópias presas em envios lentos o cliente recebe 503 e tenta de novo
+    CopiaResposta *copia = cache_resposta_obter(cache, versao_estado);
+    if (!copia) {
+        return escritor_http_recusar(tpcb);
+    }
+    err_t resultado = escritor_http_referencia(tpcb, copia->dados, copia->tamanho, liberar_copia, copia);
+    if (resultado != ERR_OK) {
+        cache_resposta_liberar(copia);
+    }
+    return resultado;
+}
+
+static bool extrair_parametro_inteiro(const RequisicaoHttp *requisicao, const char *nome, long long *valor) {
+    //Leitura tolerante da exportação (o que não for número vira zero); os tempos do log
+    //não cabem com precisão em float
+    const char *texto = rotas_parametro(requisicao, nome, NULL);
+    if (texto) {
+        *valor = strtoll(texto, NULL, 10);
+    }
+    return texto != NULL;
+}
+
+static err_t iniciar_exportacao(struct tcp_pcb *tpcb, const RequisicaoHttp *requisicao) {
+    //GET /api/history?from=&to=&step=&format=csv|json|bin
+    //Tempos em segundos do log; valores negativos são relativos ao instante atual
+    ExportacaoHistorico *exportacao = NULL;
+    for (int i = 0; i < CONEXOES_EXPORTACAO; i++) {
+        if (!exportacoes[i].em_uso) {
+            exportacao = &exportacoes[i];
+            break;
+        }
+    }
+    if (!exportacao) {
+        return escritor_http_recusar(tpcb);
+    }
+
+    long long agora = log_tempo_atual();
+    long long de = 0, ate = agora, passo = 1;
+    extrair_parametro_inteiro(requisicao, "from", &de);
+    extrair_parametro_inteiro(requisicao, "to", &ate);
+    extrair_parametro_inteiro(requisicao, "step", &passo);
+    if (de < 0) de += agora;
+    if (ate < 0) ate += agora;
+    const char *formato = rotas_parametro(requisicao, "format", NULL);
+
+    exportacao->formato = EXPORTACAO_CSV;
+    if (formato && strncmp(formato, "json", 4) == 0) {
+        exportacao->formato = EXPORTACAO_JSON;
+    } else if (formato && strncmp(formato, "bin", 3) == 0) {
+        exportacao->formato = EXPORTACAO_BINARIA;
+    }
+    exportacao->iniciada = false;
+    exportacao->primeiro = true;
+    exportacao->concluida = false;
+    exportacao->retida = false;
+    exportacao->agora = (uint32_t)agora;
+    log_cursor_abrir(&exportacao->cursor, de < 0 ? 0 : (uint32_t)de, ate < 0 ? 0 : (uint32_t)ate, passo < 1 ? 1 : (uint32_t)passo);
+
+    //Corpo em chunked, sem Content-Length: o cliente distingue o fim de uma conexão cortada
+    const char *tipo = exportacao->formato == EXPORTACAO_JSON ? "application/json" :
+                       exportacao->formato == EXPORTACAO_BINARIA ? "application/octet-stream" : "text/csv";
+    err_t resultado = escritor_http_gerador(tpcb, tipo, gerar_exportacao, encerrar_exportacao, exportacao);
+    exportacao->em_uso = resultado == ERR_OK;
+    return resultado;
+}
+
+static int montar_json_zonas(char *buffer, size_t tamanho) {
+    //Lista todas as zonas com entradas, ganhos e saída
+    int usado = snprintf(buffer, tamanho, "{\"zonas\":[");
+    for (int i = 0; i < zonas.quantidade && usado < (int)tamanho; i++) {
+        usado += snprintf(buffer + usado, tamanho - usado,
+            "%s{\"id\":%d,\"nome\":\"%s\",\"ligada\":%s,\"temperatura\":%.1f,\"umidade\":%.1f,"
+            "\"setpoint\":%.1f,\"kp\":%.2f,\"ki\":%.3f,\"pwm\":%u}",
+            i ? "," : "", i, zonas.nome[i], zonas.ligada[i] ? "true" : "false",
+            zonas.temperatura[i], zonas.umidade[i], zonas.setpoint[i],
+            zonas.kp[i], zonas.ki[i], zonas.ciclo_pwm[i]);
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "]}");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
+
+static int montar_json_estatisticas(char *buffer, size_t tamanho) {
+    //Estatísticas de cada nível do histórico, todas calculadas em O(1)
+    static const char *nomes[HISTORICO_NIVEIS] = {"segundos", "minutos", "horas"};
+    int usado = snprintf(buffer, tamanho, "{");
+    for (int n = 0; n < HISTORICO_NIVEIS && usado < (int)tamanho; n++) {
+        EstatisticasHistorico e;
+        historico_estatisticas(&estado.historico, (NivelHistorico)n, &e);
+        usado += snprintf(buffer + usado, tamanho - usado,
+            "%s\"%s\":{\"amostras\":%u,\"media\":%.2f,\"minimo\":%.2f,\"maximo\":%.2f,\"variancia\":%.4f}",
+            n ? "," : "", nomes[n], e.quantidade, e.media, e.minimo, e.maximo, e.variancia);
+    }
+    //Log na flash: amostras registradas (com o bloco em RAM) e, só das páginas gravadas, amostras e
+    //bytes comprimidos; a taxa de compressão sai de amostras_gravadas e bytes_gravados
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado,
+            ",\"log\":{\"amostras\":%lu,\"amostras_gravadas\":%lu,\"bytes_gravados\":%lu,\"falhas\":%lu}",
+            (unsigned long)log_registros_gravados(), (unsigned long)log_amostras_gravadas(),
+            (unsigned long)log_bytes_gravados(), (unsigned long)log_falhas_gravacao());
+    }
+    //Partida: origem da configuração e tempo do reset até a primeira saída PWM, só
+    //medido quando a configuração restaurada liga o sistema (null nos outros casos)
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado,
+            ",\"partida\":{\"configuracao_restaurada\":%s,\"primeiro_pwm_us\":",
+            configuracao_restaurada ? "true" : "false");
+    }
+    if (usado < (int)tamanho) {
+        usado += tempo_primeiro_pwm_us
+            ? snprintf(buffer + usado, tamanho - usado, "%llu}", (unsigned long long)tempo_primeiro_pwm_us)
+            : snprintf(buffer + usado, tamanho - usado, "null}");
+    }
+    //Wi-Fi: estado do supervisor, reconexões e tempo até obter IP
+    const MetricasWifi *wifi = supervisor_wifi_metricas();
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado,
+            ",\"wifi\":{\"estado\":\"%s\",\"tentativas\":%lu,\"conexoes\":%lu,\"quedas\":%lu,\"falhas_cache\":%lu,"
+            "\"tempo_ate_ip_ms\":%lu,\"melhor_tempo_ate_ip_ms\":%lu,\"primeiro_ip_ms\":%lu,\"com_cache\":%s}}",
+            supervisor_wifi_nome_estado(supervisor_wifi_estado()), (unsigned long)wifi->tentativas,
+            (unsigned long)wifi->conexoes, (unsigned long)wifi->quedas, (unsigned long)wifi->falhas_cache,
+            (unsigned long)wifi->tempo_ate_ip_ms, (unsigned long)wifi->melhor_tempo_ate_ip_ms,
+            (unsigned long)wifi->primeiro_ip_ms, wifi->ultima_com_cache ? "true" : "false");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
+
+static int montar_json_metricas(char *buffer, size_t tamanho) {
+    //Período real, tempo de execução e histograma do desvio em relação ao nominal de cada task
+    static const uint32_t limites[] = METRICAS_LIMITES_US;
+    int usado = snprintf(buffer, tamanho, "{\"limites_desvio_us\":[");
+    for (size_t i = 0; i < count_of(limites) && usado < (int)tamanho; i++) {
+        usado += snprintf(buffer + usado, tamanho - usado, "%s%lu", i ? "," : "", (unsigned long)limites[i]);
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "],\"tarefas\":[");
+    }
+    for (int t = 0; t < TAREFAS_PERIODICAS && usado < (int)tamanho; t++) {
+        if (t) {
+            usado += snprintf(buffer + usado, tamanho - usado, ",");
+        }
+        if (usado < (int)tamanho) {
+            usado += metricas_periodo_json(&metricas_tarefas[t], buffer + usado, tamanho - usado);
+        }
+    }
+    //Heap e pools do lwIP, para dimensionar o perfil de memória com a carga real
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "],\"lwip\":");
+    }
+    if (usado < (int)tamanho) {
+        usado += metricas_lwip_json(buffer + usado, tamanho - usado);
+    }
+    //Latência da entrada do usuário e aquisição do ADC
+    if (usado < (int)tamanho) {
+        uint32_t media = metricas_entrada.eventos ? (uint32_t)(metricas_entrada.soma_latencias_us / metricas_entrada.eventos) : 0;
+        usado += snprintf(buffer + usado, tamanho - usado,
+                          ",\"entrada\":{\"eventos\":%lu,\"latencia_media_us\":%lu,\"latencia_max_us\":%lu},\"adc\":",
+                          (unsigned long)metricas_entrada.eventos, (unsigned long)media,
+                          (unsigned long)metricas_entrada.latencia_maxima_us);
+    }
+    if (usado < (int)tamanho) {
+        usado += aquisicao_adc_json(buffer + usado, tamanho - usado);
+    }
+    //Transações e disputa no I2C compartilhado
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, ",\"i2c\":");
+    }
+    if (usado < (int)tamanho) {
+        usado += barramento_i2c_json(&barramento_i2c, buffer + usado, tamanho - usado);
+    }
+    //Respostas servidas do cache contra montagens: com vários clientes as entregas crescem e as montagens não
+    const RespostaCache *caches[] = {&cache_pagina, &cache_estatisticas, &cache_zonas, &cache_controle};
+    static const char *nomes_cache[] = {"pagina", "estatisticas", "zonas", "controle"};
+    for (size_t i = 0; i < count_of(caches) && usado < (int)tamanho; i++) {
+        usado += snprintf(buffer + usado, tamanho - usado, "%s\"%s\":", i ? "," : ",\"cache\":{", nomes_cache[i]);
+        if (usado < (int)tamanho) {
+            usado += cache_resposta_json(caches[i], buffer + usado, tamanho - usado);
+        }
+    }
+    //Respostas em andamento, recusadas com 503 e escritas adiadas por falta de buffer de envio
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "},\"escritor\":");
+    }
+    if (usado < (int)tamanho) {
+        usado += escritor_http_json(buffer + usado, tamanho - usado);
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "}");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
+
+static int montar_json_simulacao(char *buffer, size_t tamanho) {
+    //Situação do último ensaio; o resultado só é lido depois que a task o concluiu
+    static const char *const NOMES[] = {"ociosa", "na_fila", "executando", "concluida"};
+    EstadoSimulacao situacao = simulacao.estado;
+    int usado = snprintf(buffer, tamanho, "{\"estado\":\"%s\"", NOMES[situacao]);
+    if (situacao == SIMULACAO_CONCLUIDA && usado < (int)tamanho) {
+        const EnsaioMalha *ensaio = &simulacao.ensaio;
+        usado += snprintf(buffer + usado, tamanho - usado,
+                          ",\"kp\":%.3f,\"ki\":%.4f,\"duracao_us\":%lu,\"aceleracao\":%.0f,\"resultado\":",
+                          ensaio->kp, ensaio->ki, (unsigned long)simulacao.duracao_us,
+                          simulacao.duracao_us ? ensaio->duracao_s * 1e6f / simulacao.duracao_us : 0.0f);
+        if (usado < (int)tamanho) {
+            usado += malha_simulada_json(&simulacao.resultado, buffer + usado, tamanho - usado);
+        }
+    }
+    if (usado < (int)tamanho) {
+        usado += snprintf(buffer + usado, tamanho - usado, "}");
+    }
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
+
+static int montar_json_controle(char *buffer, size_t tamanho) {
+    //Estado da zona principal nos mesmos termos aceitos por PUT /api/controle
+    int usado = snprintf(buffer, tamanho,
+        "{\"ligado\":%s,\"autotune\":%s,\"setpoint\":%d,\"setpoint_minimo\":%d,\"setpoint_maximo\":%d,"
+        "\"kp\":%.2f,\"ki\":%.3f,\"temperatura\":%.1f,\"pwm\":%u}",
+        estado.controle.sistema_ligado ? "true" : "false", estado.controle.autotune_ativo ? "true" : "false",
+        estado.controle.setpoint_temperatura, estado.setpoint_minimo, estado.setpoint_maximo,
+        estado.controle.ganho_kp, estado.controle.ganho_ki, estado.controle.temperatura_ambiente, estado.ciclo_pwm);
+    return usado < (int)tamanho ? usado : (int)tamanho - 1;
+}
+
+//Comandos da API: validam todos os parâmetros antes de alterar o estado, então
+//uma requisição recusada não deixa nada pela metade. Retornam NULL se aplicaram
+//ou o status HTTP da recusa, com o motivo em 'mensagem'
+typedef const char *(*ComandoWeb)(const RequisicaoHttp *requisicao, char *mensagem, size_t tamanho);
+
+#define STATUS_INVALIDO "400 Bad Request"
+#define STATUS_CONFLITO "409 Conflict"
+
+static const char *validar_operacao(SituacaoParametro setpoint, const char *nome_ligado, SituacaoParametro ligado, long valor_ligado,
+                                    char *mensagem, size_t tamanho) {
+    //Regras da interface local para a zona principal: o setpoint só muda desligado
+    //(desligar e ajustar na mesma requisição vale)
+    if (ligado == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "%s deve ser 0 ou 1", nome_ligado);
+        return STATUS_INVALIDO;
+    }
+    if (setpoint == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "setpoint deve ser inteiro entre %d e %d", estado.setpoint_minimo, estado.setpoint_maximo);
+        return STATUS_INVALIDO;
+    }
+    bool desligado = !estado.controle.sistema_ligado || (ligado == PARAMETRO_VALIDO && !valor_ligado);
+    if (setpoint == PARAMETRO_VALIDO && !desligado) {
+        snprintf(mensagem, tamanho, "setpoint so muda com o sistema desligado");
+        return STATUS_CONFLITO;
+    }
+    return NULL;
+}
+
+static void aplicar_operacao(SituacaoParametro setpoint, long valor_setpoint, SituacaoParametro ligado, long valor_ligado) {
+    //Desliga antes de ajustar e liga depois, como na sequência STOP, ajuste e OK da página
+    if (ligado == PARAMETRO_VALIDO && !valor_ligado) {
+        estado.controle.modo_selecao = true;
+        estado.controle.sistema_ligado = false;
+    }
+    if (setpoint == PARAMETRO_VALIDO) {
+        estado.controle.setpoint_temperatura = (int)valor_setpoint;
+    }
+    if (ligado == PARAMETRO_VALIDO && valor_ligado && !estado.controle.sistema_ligado) {
+        estado.controle.modo_selecao = false;
+        estado.controle.sistema_ligado = true;
+    }
+}
+
+static const char *comando_controle(const RequisicaoHttp *requisicao, char *mensagem, size_t tamanho) {
+    //PUT /api/controle com qualquer combinação de setpoint, limites do setpoint, kp, ki e ligado
+    long setpoint = 0, ligado = 0;
+    long minimo = estado.setpoint_minimo, maximo = estado.setpoint_maximo;
+    float kp = 0.0f, ki = 0.0f;
+    SituacaoParametro tem_minimo = rotas_parametro_inteiro(requisicao, "setpoint_minimo", SETPOINT_LIMITE_INFERIOR,
+                                                           SETPOINT_LIMITE_SUPERIOR, &minimo);
+    SituacaoParametro tem_maximo = rotas_parametro_inteiro(requisicao, "setpoint_maximo", SETPOINT_LIMITE_INFERIOR,
+                                                           SETPOINT_LIMITE_SUPERIOR, &maximo);
+    if (tem_minimo == PARAMETRO_INVALIDO || tem_maximo == PARAMETRO_INVALIDO || minimo > maximo) {
+        snprintf(mensagem, tamanho, "setpoint_minimo e setpoint_maximo devem ser inteiros entre %d e %d, minimo <= maximo",
+                 SETPOINT_LIMITE_INFERIOR, SETPOINT_LIMITE_SUPERIOR);
+        return STATUS_INVALIDO;
+    }
+    //O setpoint informado é conferido contra os limites novos
+    SituacaoParametro tem_setpoint = rotas_parametro_inteiro(requisicao, "setpoint", minimo, maximo, &setpoint);
+    if (tem_setpoint == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "setpoint deve ser inteiro entre %ld e %ld", minimo, maximo);
+        return STATUS_INVALIDO;
+    }
+    SituacaoParametro tem_kp = rotas_parametro_numero(requisicao, "kp", 0.0f, KP_MAXIMO, &kp);
+    SituacaoParametro tem_ki = rotas_parametro_numero(requisicao, "ki", 0.0f, KI_MAXIMO, &ki);
+    SituacaoParametro tem_ligado = rotas_parametro_inteiro(requisicao, "ligado", 0, 1, &ligado);
+
+    if (tem_kp == PARAMETRO_INVALIDO || tem_ki == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "kp deve estar entre 0 e %.0f e ki entre 0 e %.0f", KP_MAXIMO, KI_MAXIMO);
+        return STATUS_INVALIDO;
+    }
+    const char *recusa = validar_operacao(tem_setpoint, "ligado", tem_ligado, ligado, mensagem, tamanho);
+    if (recusa) {
+        return recusa;
+    }
+    bool muda_ganhos = tem_kp == PARAMETRO_VALIDO || tem_ki == PARAMETRO_VALIDO;
+    bool muda_limites = tem_minimo == PARAMETRO_VALIDO || tem_maximo == PARAMETRO_VALIDO;
+    if (!muda_ganhos && !muda_limites && tem_setpoint == PARAMETRO_AUSENTE && tem_ligado == PARAMETRO_AUSENTE) {
+        snprintf(mensagem, tamanho, "informe setpoint, setpoint_minimo, setpoint_maximo, kp, ki ou ligado");
+        return STATUS_INVALIDO;
+    }
+    //Limites que deixariam o setpoint atual de fora exigem um setpoint novo (e, portanto, o sistema desligado)
+    int setpoint_final = tem_setpoint == PARAMETRO_VALIDO ? (int)setpoint : estado.controle.setpoint_temperatura;
+    if (setpoint_final < minimo || setpoint_final > maximo) {
+        snprintf(mensagem, tamanho, "setpoint atual %d fora de %ld a %ld; informe um setpoint novo",
+                 setpoint_final, minimo, maximo);
+        return STATUS_CONFLITO;
+    }
+    //O ensaio do relé aplica os próprios ganhos ao terminar
+    if (muda_ganhos && estado.controle.autotune_ativo && !(tem_ligado == PARAMETRO_VALIDO && !ligado)) {
+        snprintf(mensagem, tamanho, "autotune em andamento");
+        return STATUS_CONFLITO;
+    }
+
+    estado.setpoint_minimo = (int)minimo;
+    estado.setpoint_maximo = (int)maximo;
+    aplicar_operacao(tem_setpoint, setpoint, tem_ligado, ligado);
+    if (tem_kp == PARAMETRO_VALIDO) {
+        estado.controle.ganho_kp = kp;
+    }
+    if (tem_ki == PARAMETRO_VALIDO) {
+        estado.controle.ganho_ki = ki;
+    }
+    return NULL;
+}
+
+static const char *comando_autotune(const RequisicaoHttp *requisicao, char *mensagem, size_t tamanho) {
+    //POST /api/autotune: o ensaio parte do setpoint atual, com o sistema desligado
+    if (estado.controle.sistema_ligado) {
+        snprintf(mensagem, tamanho, "desligue o sistema antes do autotune");
+        return STATUS_CONFLITO;
+    }
+    iniciar_autotune();
+    return NULL;
+}
+
+static const char *comando_simular(const RequisicaoHttp *requisicao, char *mensagem, size_t tamanho) {
+    //POST /api/simular?kp=120&ki=8&setpoint=20&duracao=3600&tau=90&atraso=8; os ausentes
+    //vêm do controle atual e da planta padrão
+    if (simulacao.estado == SIMULACAO_NA_FILA || simulacao.estado == SIMULACAO_EXECUTANDO) {
+        snprintf(mensagem, tamanho, "ensaio em andamento");
+        return STATUS_CONFLITO;
+    }
+    ParametrosPlanta planta = PLANTA_PADRAO;
+    EnsaioMalha ensaio = {
+        .kp = estado.controle.ganho_kp, .ki = estado.controle.ganho_ki, .limite_integral = LIMITE_INTEGRAL,
+        .setpoint = (float)estado.controle.setpoint_temperatura, .intervalo_s = PERIODO_CONTROLE_MS / 1000.0f,
+        .duracao_s = 3600.0f, .banda = AUTOTUNE_BANDA, .janela_estavel_s = AUTOTUNE_JANELA_S, .semente = 1,
+    };
+    if (rotas_parametro_numero(requisicao, "kp", 0.0f, KP_MAXIMO, &ensaio.kp) == PARAMETRO_INVALIDO ||
+        rotas_parametro_numero(requisicao, "ki", 0.0f, KI_MAXIMO, &ensaio.ki) == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "kp deve estar entre 0 e %.0f e ki entre 0 e %.0f", KP_MAXIMO, KI_MAXIMO);
+        return STATUS_INVALIDO;
+    }
+    if (rotas_parametro_numero(requisicao, "setpoint", SETPOINT_LIMITE_INFERIOR, SETPOINT_LIMITE_SUPERIOR,
+                               &ensaio.setpoint) == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "setpoint deve estar entre %d e %d", SETPOINT_LIMITE_INFERIOR, SETPOINT_LIMITE_SUPERIOR);
+        return STATUS_INVALIDO;
+    }
+    if (rotas_parametro_numero(requisicao, "duracao", ensaio.intervalo_s, SIMULACAO_DURACAO_MAX_S,
+                               &ensaio.duracao_s) == PARAMETRO_INVALIDO ||
+        rotas_parametro_numero(requisicao, "tau", 1.0f, SIMULACAO_TAU_MAX_S, &planta.constante_tempo_s) == PARAMETRO_INVALIDO ||
+        rotas_parametro_numero(requisicao, "atraso", 0.0f, SIMULACAO_ATRASO_MAX_S, &planta.atraso_s) == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "duracao ate %.0f s, tau de 1 a %.0f s e atraso ate %.0f s",
+                 SIMULACAO_DURACAO_MAX_S, SIMULACAO_TAU_MAX_S, SIMULACAO_ATRASO_MAX_S);
+        return STATUS_INVALIDO;
+    }
+    simulacao.planta = planta;
+    simulacao.ensaio = ensaio;
+    simulacao.estado = SIMULACAO_NA_FILA;
+    return NULL;
+}
+
+static const char *comando_zona(const RequisicaoHttp *requisicao, char *mensagem, size_t tamanho) {
+    //PUT /api/zona com id e setpoint e/ou ligada; a zona principal segue as regras da interface local
+    long id = 0, ligada = 0;
+    if (rotas_parametro_inteiro(requisicao, "id", 0, zonas.quantidade - 1, &id) != PARAMETRO_VALIDO) {
+        snprintf(mensagem, tamanho, "id deve ser inteiro entre 0 e %d", zonas.quantidade - 1);
+        return STATUS_INVALIDO;
+    }
+    SituacaoParametro tem_ligada = rotas_parametro_inteiro(requisicao, "ligada", 0, 1, &ligada);
+    //Sem setpoint nem ligada (o setpoint ausente é o mesmo PARAMETRO_AUSENTE nas duas faixas abaixo)
+    if (tem_ligada == PARAMETRO_AUSENTE && !rotas_parametro(requisicao, "setpoint", NULL)) {
+        snprintf(mensagem, tamanho, "informe setpoint ou ligada");
+        return STATUS_INVALIDO;
+    }
+
+    if (id == ZONA_PRINCIPAL) {
+        long setpoint = 0;
+        SituacaoParametro tem_setpoint = rotas_parametro_inteiro(requisicao, "setpoint", estado.setpoint_minimo,
+                                                                 estado.setpoint_maximo, &setpoint);
+        const char *recusa = validar_operacao(tem_setpoint, "ligada", tem_ligada, ligada, mensagem, tamanho);
+        if (!recusa) {
+            aplicar_operacao(tem_setpoint, setpoint, tem_ligada, ligada);
+        }
+        return recusa;
+    }
+
+    float setpoint = 0.0f;
+    SituacaoParametro tem_setpoint = rotas_parametro_numero(requisicao, "setpoint", (float)estado.setpoint_minimo,
+                                                            (float)estado.setpoint_maximo, &setpoint);
+    if (tem_setpoint == PARAMETRO_INVALIDO || tem_ligada == PARAMETRO_INVALIDO) {
+        snprintf(mensagem, tamanho, "setpoint deve estar entre %d e %d e ligada ser 0 ou 1",
+                 estado.setpoint_minimo, estado.setpoint_maximo);
+        return STATUS_INVALIDO;
+    }
+    if (tem_setpoint == PARAMETRO_VALIDO) {
+        zonas.setpoint[id] = setpoint;
+    }
+    if (tem_ligada == PARAMETRO_VALIDO) {
+        zonas.ligada[id] = ligada != 0;
+    }
+    return NULL;
+}
+
+static err_t executar_comando(struct tcp_pcb *tpcb, const RequisicaoHttp *requisicao, ComandoWeb comando, RespostaCache *cache) {
+    //Aplica o comando e responde com o estado resultante
+    if (!rotas_corpo_completo(requisicao)) {
+        //A recepção espera o corpo inteiro enquanto ele couber em TAMANHO_MAX_REQUISICAO
+        return responder_erro(tpcb, STATUS_INVALIDO, "corpo maior que o buffer; envie os parametros na query");
+    }
+    char mensagem[96];
+    const char *recusa = comando(requisicao, mensagem, sizeof(mensagem));
+    if (recusa) {
+        return responder_erro(tpcb, recusa, mensagem);
+    }
+    marcar_estado_alterado();
+    if (requisicao->aceita_html) {
+        //Formulário do dashboard: volta para a página, e o refresh dela não repete o POST
+        return escritor_http_copia(tpcb, "303 See Other", "text/plain", "Location: /\r\n", "", 0);
+    }
+    return responder_com_cache(tpcb, cache);
+}
+
+static int montar_json_rastro(char *buffer, size_t tamanho) {
+    return snprintf(buffer, tamanho, "{\"gravando\":%s,\"passos\":%lu,\"bytes\":%lu}",
+                    gravar_rastro ? "true" : "false", (unsigned long)gravador_rastro.passos,
+                    (unsigned long)gravador_rastro.bytes);
+}
+
+static err_t responder_rastro(struct tcp_pcb *tpcb, const RequisicaoHttp *requisicao) {
+    //GET mostra a gravação; PUT/POST /api/rastro?gravar=0|1 liga ou desliga, e a task
+    //de controle assume no próximo período
+    if (requisicao) {
+        long gravar = 0;
+        if (!rotas_corpo_completo(requisicao)) {
+            return responder_erro(tpcb, STATUS_INVALIDO, "corpo maior que o buffer; envie os parametros na query");
+        }
+        if (rotas_parametro_inteiro(requisicao, "gravar", 0, 1, &gravar) != PARAMETRO_VALIDO) {
+            return responder_erro(tpcb, STATUS_INVALIDO, "gravar deve ser 0 ou 1");
+        }
+        gravar_rastro = gravar != 0;
+    }
+    static char json_rastro[96];
+    int tamanho_json = montar_json_rastro(json_rastro, sizeof(json_rastro));
+    return escritor_http_copia(tpcb, "200 OK", "application/json", NULL, json_rastro, tamanho_json);
+}
+
+static err_t iniciar_simulacao(struct tcp_pcb *tpcb, const RequisicaoHttp *requisicao) {
+    //202 logo após enfileirar: o resultado sai em GET /api/simular quando a task terminar
+    if (!rotas_corpo_completo(requisicao)) {
+        return responder_erro(tpcb, STATUS_INVALIDO, "corpo maior que o buffer; envie os parametros na query");
+    }
+    char mensagem[96];
+    const char *recusa = comando_simular(requisicao, mensagem, sizeof(mensagem));
+    if (recusa) {
+        return responder_erro(tpcb, recusa, mensagem);
+    }
+    static const char corpo[] = "{\"estado\":\"na_fila\"}";
+    return escritor_http_copia(tpcb, "202 Accepted", "application/json", "Location: /api/simular\r\n",
+                               corpo, sizeof(corpo) - 1);
+}
+
+
+//Métricas: montadas a cada pedido num buffer único enviado por referência (no perfil
+//pouca_ram o JSON é maior que o buffer de envio); outro pedido durante o envio recebe 503
+static char resposta_metricas[CACHE_RESPOSTA_CABECALHO + TAMANHO_JSON_METRICAS];
+static bool metricas_em_envio;
+
+static void liberar_metricas(void *contexto, bool concluida) {
+    metricas_em_envio = false;
+}
+
+static err_t responder_metricas(struct tcp_pcb *tpcb) {
+    if (metricas_em_envio) {
+        return escritor_http_recusar(tpcb);
+    }
+    //Mesma montagem do cache: o cabeçalho é encostado no corpo
+    char *corpo = resposta_metricas + CACHE_RESPOSTA_CABECALHO;
+    int tamanho_corpo = montar_json_metricas(corpo, TAMANHO_JSON_METRICAS);
+    char cabecalho[CACHE_RESPOSTA_CABECALHO];
+    int tamanho_cabecalho = pagina_web_cabecalho(cabecalho, sizeof(cabecalho), "200 OK", "application/json", tamanho_corpo);
+    memcpy(corpo - tamanho_cabecalho, cabecalho, tamanho_cabecalho);
+    metricas_em_envio = true;
+    err_t resultado = escritor_http_referencia(tpcb, corpo - tamanho_cabecalho, tamanho_cabecalho + tamanho_corpo,
+                                               liberar_metricas, NULL);
+    metricas_em_envio = resultado == ERR_OK;
+    return resultado;
+}
+
+//Requisição à espera do restante (o corpo de um formulário costuma vir num segmento
+//separado dos cabeçalhos): os pbufs recebidos ficam presos ao pcb por tcp_arg até a
+//requisição completar, encher o buffer, a conexão cair ou vencer o tcp_poll
+static void soltar_requisicao_pendente(struct tcp_pcb *tpcb, struct pbuf *pendente) {
+    tcp_arg(tpcb, NULL);
+    tcp_err(tpcb, NULL);
+    tcp_poll(tpcb, NULL, 0);
+    pbuf_free(pendente);
+}
+
+static void callback_erro_requisicao(void *arg, err_t err) {
+    //O lwIP já liberou o pcb; só os pbufs guardados são nossos
+    if (arg) {
+        pbuf_free((struct pbuf *)arg);
+    }
+}
+
+static err_t callback_espera_requisicao(void *arg, struct tcp_pcb *tpcb) {
+    if (!arg) {
+        return ERR_OK;
+    }
+    soltar_requisicao_pendente(tpcb, (struct pbuf *)arg);
+    return responder_erro(tpcb, "408 Request Timeout", "requisicao incompleta") == ERR_ABRT ? ERR_ABRT : ERR_OK;
+}
+
+static bool requisicao_incompleta(const char *texto, uint16_t tamanho, bool interpretada, const RequisicaoHttp *http) {
+    //Sem a linha de requisição, sem a linha em branco ou com menos corpo que o Content-Length
+    if (!interpretada) {
+        return memchr(texto, '\n', tamanho) == NULL;
+    }
+    return !http->corpo || !rotas_corpo_completo(http);
 }
 
 static err_t callback_recepcao_web(void *arg, struct tcp_pcb *tpcb, struct pbuf *p, err_t err) {
+    struct pbuf *pendente = (struct pbuf *)arg;
     if (!p) {
-        tcp_close(tpcb);
+        //Cliente fechou a conexão antes de completar um pedido
+        if (pendente) {
+            soltar_requisicao_pendente(tpcb, pendente);
+        }
+        if (tcp_close(tpcb) != ERR_OK) {
+            tcp_abort(tpcb);
+            return ERR_ABRT;
+        }
         return ERR_OK;
     }
+    tcp_recved(tpcb, p->tot_len);
+    if (pendente) {
+        pbuf_cat(pendente, p);
+        p = pendente;
+    }
+
+    //Copia a requisição recebida até aqui; os callbacks rodam um de cada vez, então um buffer basta
+    static char requisicao[TAMANHO_MAX_REQUISICAO];
+    uint16_t copiados = pbuf_copy_partial(p, requisicao, LWIP_MIN(p->tot_len, sizeof(requisicao) - 1), 0);
+    requisicao[copiados] = '\0';
+    RequisicaoHttp http;
+    bool interpretada = rotas_interpretar(requisicao, copiados, &http);
 
-    //Copia a requisição recebida
-    char *requisicao = malloc(p->len + 1);
-    memcpy(requisicao, p->payload, p->len);
-    requisicao[p->len] = '\0';
-    pbuf_free(p);
-
-    //Processa os endpoints da requisição
-    if (strncmp(requisicao, "GET /increase", 13) == 0 && !estado.sistema_ligado && estado.setpoint_temperatura < 30) {
-        estado.setpoint_temperatura++;
-    } else if (strncmp(requisicao, "GET /decrease", 13) == 0 && !estado.sistema_ligado && estado.setpoint_temperatura > 10) {
-        estado.setpoint_temperatura--;
-    } else if (strncmp(requisicao, "GET /ok", 7) == 0 && !estado.sistema_ligado) {
-        estado.modo_selecao = false;
-        estado.sistema_ligado = true;
-    } else if (strncmp(requisicao, "GET /stop", 9) == 0 && estado.sistema_ligado) {
-        estado.modo_selecao = true;
-        estado.sistema_ligado = false;
-    }
-    free(requisicao);
-
-    //Calcula valores para exibição
-    float percentual_pwm = (estado.ciclo_pwm / 65535.0f) * 100.0f;
-    float erro_temperatura = (float)estado.setpoint_temperatura - estado.temperatura_ambiente;
-    float rpm_exibicao = estado.rpm_atual == RPM_MINIMO ? 0.0f : estado.rpm_atual;
-    float angulo_servo = (estado.ciclo_pwm / 65535.0f) * 180.0f;
-    float media_temperaturas = calcular_media_temperaturas();
-
-    //Monta a página HTML com atualização automática a cada 2 segundos
-    char corpo[2048];
-    int tamanho_corpo = snprintf(corpo, sizeof(corpo),
-        "<!DOCTYPE html>\n"
-        "<html>\n"
-        "<head>\n"
-        "  <meta charset=\"UTF-8\">\n"
-        "  <meta http-equiv=\"refresh\" content=\"2\">\n"
-        "  <title>ThermoGuardian</title>\n"
-        "  <style>\n"
-        "    body { background-color: #b5e5fb; font-family: Arial, sans-serif; text-align: center; margin-top: 20px; }\n"
-        "    h1 { font-size: 36px; margin-bottom: 20px; }\n"
-        "    button { background-color: LightGray; font-size: 24px; margin: 5px; padding: 10px 20px; border-radius: 8px; }\n"
-        "    .info { font-size: 20px; margin-top: 10px; color: #333; }\n"
-        "    .info-container { display: inline-block; text-align: left; }\n"
-        "    .status { font-weight: bold; margin: 15px; font-size: 24px; }\n"
-        "    .active { color: green; }\n"
-        "    .inactive { color: red; }\n"
-        "  </style>\n"
-        "</head>\n"
-        "<body>\n"
-        "  <h1>ThermoGuardian</h1>\n"
-        "  <div class=\"status %s\">Sistema: %s</div>\n",
-        estado.sistema_ligado ? "active" : "inactive",
-        estado.sistema_ligado ? "ATIVO" : "INATIVO"
-    );
-
-    //Adiciona botões de controle se o sistema está desligado
-    if (!estado.sistema_ligado) {
-        tamanho_corpo += snprintf(corpo + tamanho_corpo, sizeof(corpo) - tamanho_corpo,
-            "  <form action=\"/increase\" method=\"get\"><button type=\"submit\">+1 °C</button></form>\n"
-            "  <form action=\"/decrease\" method=\"get\"><button type=\"submit\">–1 °C</button></form>\n"
-            "  <form action=\"/ok\" method=\"get\"><button type=\"submit\" style=\"background-color: #90EE90;\">OK</button></form>\n"
-        );
+    if (copiados < sizeof(requisicao) - 1 && requisicao_incompleta(requisicao, copiados, interpretada, &http)) {
+        if (!pendente) {
+            tcp_arg(tpcb, p);
+            tcp_err(tpcb, callback_erro_requisicao);
+            tcp_poll(tpcb, callback_espera_requisicao, ESPERA_REQUISICAO_POLL);
+        }
+        return ERR_OK;
+    }
+    if (pendente) {
+        soltar_requisicao_pendente(tpcb, p);
     } else {
-        tamanho_corpo += snprintf(corpo + tamanho_corpo, sizeof(corpo) - tamanho_corpo,
-            "  <form action=\"/stop\" method=\"get\"><button type=\"submit\" style=\"background-color: #FFCCCB;\">STOP</button></form>\n"
-        );
-    }
-
-    //Adiciona informações do sistema
-    tamanho_corpo += snprintf(corpo + tamanho_corpo, sizeof(corpo) - tamanho_corpo,
-        "  <div class=\"info-container\">\n"
-        "    <p class=\"info\">Setpoint: %d °C</p>\n"
-        "    <p class=\"info\">Temperatura Medida: %.1f °C</p>\n"
-        "    <p class=\"info\">Umidade Medida: %.1f %%</p>\n"
-        "    <p class=\"info\">Erro Atual: %.1f °C</p>\n"
-        "    <p class=\"info\">PWM LED: %u / 65535 (%.1f %%)</p>\n"
-        "    <p class=\"info\">RPM Simulado (300–2000): %.0f RPM</p>\n"
-        "    <p class=\"info\">Servo Motor Simulado: %.1f°</p>\n"
-        "    <p class=\"info\">Temp Média Últimos %d: %.1f °C</p>\n"
-        "  </div>\n"
-        "</body>\n"
-        "</html>\n",
-        estado.setpoint_temperatura,
-        estado.temperatura_ambiente,
-        estado.umidade_ambiente,
-        erro_temperatura,
-        estado.ciclo_pwm,
-        percentual_pwm,
-        rpm_exibicao,
-        angulo_servo,
-        estado.contador_temperaturas,
-        media_temperaturas
-    );
-
-    //Envia a resposta HTTP
-    char cabecalho[128];
-    int tamanho_cabecalho = snprintf(cabecalho, sizeof(cabecalho),
-        "HTTP/1.1 200 OK\r\n"
-        "Content-Type: text/html\r\n"
-        "Content-Length: %d\r\n"
-        "Connection: close\r\n\r\n",
-        tamanho_corpo
-    );
-
-    tcp_write(tpcb, cabecalho, tamanho_cabecalho, TCP_WRITE_FLAG_COPY);
-    tcp_write(tpcb, corpo, tamanho_corpo, TCP_WRITE_FLAG_COPY);
-    tcp_output(tpcb);
-    tcp_sent(tpcb, callback_envio_web);
-    return ERR_OK;
+        pbuf_free(p);
+    }
+
+    //As respostas retornam ERR_ABRT quando precisaram abortar a conexão: o lwIP não pode mais usar o pcb
+    if (!interpretada) {
+        return responder_erro(tpcb, STATUS_INVALIDO, "linha de requisicao malformada") == ERR_ABRT ? ERR_ABRT : ERR_OK;
+    }
+
+    err_t resultado;
+
+    switch (rotas_resolver(&http)) {
+    case ROTA_PAGINA:
+        //Página HTML da versão atual do estado, montada só pelo primeiro cliente que a pede
+        resultado = responder_com_cache(tpcb, &cache_pagina);
+        break;
+    case ROTA_HISTORICO:
+        //Exportação do log persistente, enviada em blocos conforme o TCP libera espaço
+        resultado = iniciar_exportacao(tpcb, &http);
+        break;
+    case ROTA_ESTATISTICAS:
+        resultado = responder_com_cache(tpcb, &cache_estatisticas);
+        break;
+    case ROTA_METRICAS:
+        resultado = responder_metricas(tpcb);
+        break;
+    case ROTA_SIMULAR: {
+        static char json_simulacao[384];
+        int tamanho_json = montar_json_simulacao(json_simulacao, sizeof(json_simulacao));
+        resultado = escritor_http_copia(tpcb, "200 OK", "application/json", NULL, json_simulacao, tamanho_json);
+        break;
+    }
+    case ROTA_SIMULAR_INICIAR:
+        resultado = iniciar_simulacao(tpcb, &http);
+        break;
+    case ROTA_RASTRO:
+        resultado = responder_rastro(tpcb, NULL);
+        break;
+    case ROTA_RASTRO_ALTERAR:
+        resultado = responder_rastro(tpcb, &http);
+        break;
+    case ROTA_CONTROLE:
+        resultado = responder_com_cache(tpcb, &cache_controle);
+        break;
+    case ROTA_CONTROLE_ALTERAR:
+        resultado = executar_comando(tpcb, &http, comando_controle, &cache_controle);
+        break;
+    case ROTA_AUTOTUNE:
+        resultado = executar_comando(tpcb, &http, comando_autotune, &cache_controle);
+        break;
+    case ROTA_ZONAS:
+        resultado = responder_com_cache(tpcb, &cache_zonas);
+        break;
+    case ROTA_ZONA_ALTERAR:
+        resultado = executar_comando(tpcb, &http, comando_zona, &cache_zonas);
+        break;
+    case ROTA_METODO_INVALIDO: {
+        //O caminho existe com outros métodos: informa quais no Allow
+        char permitidos[48] = "Allow: ";
+        rotas_metodos_permitidos(&http, permitidos + 7, sizeof(permitidos) - 7 - 2);
+        strcat(permitidos, "\r\n");
+        static const char corpo[] = "{\"erro\":\"metodo nao permitido\"}";
+        resultado = escritor_http_copia(tpcb, "405 Method Not Allowed", "application/json", permitidos, corpo, sizeof(corpo) - 1);
+        break;
+    }
+    default:
+        resultado = responder_erro(tpcb, "404 Not Found", "rota inexistente");
+        break;
+    }
+    //Recusas (503) já fecharam a conexão normalmente
+    return resultado == ERR_ABRT ? ERR_ABRT : ERR_OK;
 }
 
 static err_t callback_aceitar_conexao(void *arg, struct tcp_pcb *nova_conexao, err_t err) {
@@ -486,53 +1725,118 @@ static err_t callback_aceitar_conexao(void *arg, struct tcp_pcb *nova_conexao, e
 }
 
 void task_servidor_web(void *parametros) {
-    //Inicializa o módulo Wi-Fi
-    if (cyw43_arch_init()) {
+    //Inicializa o módulo Wi-Fi e dispara a associação sem bloquear
+    const ConfiguracaoWifi config_wifi = {
+        .nome_rede = WIFI_NOME_REDE,
+        .senha = WIFI_SENHA,
+        .autenticacao = CYW43_AUTH_WPA2_AES_PSK,
+#ifdef WIFI_IP_FIXO
+        .ip_fixo = WIFI_IP_FIXO,
+        .mascara = WIFI_MASCARA,
+        .gateway = WIFI_GATEWAY,
+#endif
+    };
+    printf("Conectando a %s%s...\n", WIFI_NOME_REDE, cache_wifi_restaurado.canal ? " (BSSID em cache)" : "");
+    if (!supervisor_wifi_iniciar(&config_wifi, &cache_wifi_restaurado)) {
         printf("Falha ao iniciar Wi-Fi\n");
         vTaskDelete(NULL);
     }
-    cyw43_arch_gpio_put(CYW43_WL_GPIO_LED_PIN, 0);
-    cyw43_arch_enable_sta_mode();
 
-    //Conecta à rede Wi-Fi
-    printf("Conectando a %s...\n", WIFI_NOME_REDE);
-    if (cyw43_arch_wifi_connect_timeout_ms(WIFI_NOME_REDE, WIFI_SENHA, CYW43_AUTH_WPA2_AES_PSK, 20000)) {
-        printf("Falha na conexão\n");
-        vTaskDelete(NULL);
-    }
-    printf("Conectado!\n");
-    if (netif_default) {
-        printf("IP: %s\n", ipaddr_ntoa(&netif_default->ip_addr));
-    }
+    //Buffers estáticos: os callbacks do lwIP rodam na pilha de interrupção, que é pequena
+    cache_resposta_iniciar(&cache_pagina, "text/html", montar_pagina_html, buffers_pagina[0], sizeof(buffers_pagina[0]));
+    cache_resposta_iniciar(&cache_estatisticas, "application/json", montar_json_estatisticas,
+                           buffers_estatisticas[0], sizeof(buffers_estatisticas[0]));
+    cache_resposta_iniciar(&cache_zonas, "application/json", montar_json_zonas, buffers_zonas[0], sizeof(buffers_zonas[0]));
+    cache_resposta_iniciar(&cache_controle, "application/json", montar_json_controle,
+                           buffers_controle[0], sizeof(buffers_controle[0]));
 
-    //Configura o servidor HTTP na porta 80
+    //O servidor HTTP escuta em qualquer endereço: passa a responder assim que o link tiver IP
+    cyw43_arch_lwip_begin();
     struct tcp_pcb *servidor = tcp_new();
     if (!servidor || tcp_bind(servidor, IP_ADDR_ANY, 80) != ERR_OK) {
+        cyw43_arch_lwip_end();
         printf("Erro ao vincular porta 80\n");
         vTaskDelete(NULL);
     }
     servidor = tcp_listen(servidor);
     tcp_accept(servidor, callback_aceitar_conexao);
+    cyw43_arch_lwip_end();
     printf("Servidor HTTP iniciado na porta 80\n");
 
+    TickType_t proxima_liberacao = xTaskGetTickCount();
     while (true) {
+        metricas_periodo_marcar(&metricas_tarefas[TAREFA_REDE]);
         cyw43_arch_poll(); //Processa eventos de rede
-        vTaskDelay(pdMS_TO_TICKS(100)); //Aguarda 100ms
+        //Associação, DHCP e reconexões avançam aqui sem bloquear as demais tasks
+        if (supervisor_wifi_executar()) {
+            const MetricasWifi *wifi = supervisor_wifi_metricas();
+            char endereco[IPADDR_STRLEN_MAX];
+            cyw43_arch_lwip_begin();
+            ipaddr_ntoa_r(&cyw43_state.netif[CYW43_ITF_STA].ip_addr, endereco, sizeof(endereco));
+            cyw43_arch_lwip_end();
+            printf("Conectado! IP: %s em %lu ms%s\n", endereco,
+                   (unsigned long)wifi->tempo_ate_ip_ms, wifi->ultima_com_cache ? " (BSSID em cache)" : "");
+        }
+        metricas_periodo_concluir(&metricas_tarefas[TAREFA_REDE]);
+        vTaskDelayUntil(&proxima_liberacao, pdMS_TO_TICKS(PERIODO_INTERFACE_MS));
     }
 }
 
+//=== CRIAÇÃO DAS TASKS ===
+static TaskHandle_t criar_tarefa(TaskFunction_t funcao, const char *nome, uint32_t palavras_pilha,
+                                 UBaseType_t prioridade, StackType_t *pilha, StaticTask_t *tcb) {
+#if MEMORIA_ESTATICA
+    TaskHandle_t tarefa = xTaskCreateStatic(funcao, nome, palavras_pilha, NULL, prioridade, pilha, tcb);
+#else
+    (void)pilha;
+    (void)tcb;
+    TaskHandle_t tarefa = NULL;
+    xTaskCreate(funcao, nome, palavras_pilha, NULL, prioridade, &tarefa);
+#endif
+    configASSERT(tarefa != NULL);
+    return tarefa;
+}
+
+#if MEMORIA_ESTATICA
+//Memória das tasks internas do FreeRTOS (exigida com configSUPPORT_STATIC_ALLOCATION)
+void vApplicationGetIdleTaskMemory(StaticTask_t **tcb, StackType_t **pilha, uint32_t *palavras) {
+    static StaticTask_t tcb_idle;
+    static StackType_t pilha_idle[configMINIMAL_STACK_SIZE];
+    *tcb = &tcb_idle;
+    *pilha = pilha_idle;
+    *palavras = configMINIMAL_STACK_SIZE;
+}
+
+void vApplicationGetTimerTaskMemory(StaticTask_t **tcb, StackType_t **pilha, uint32_t *palavras) {
+    static StaticTask_t tcb_timer;
+    static StackType_t pilha_timer[configTIMER_TASK_STACK_DEPTH];
+    *tcb = &tcb_timer;
+    *pilha = pilha_timer;
+    *palavras = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
 //=== FUNÇÃO PRINCIPAL ===
 int main(void) {
     //Inicializa o hardware (serial, I2C, PWM, etc.)
     inicializar_hardware();
 
+    //Métricas de período de cada task periódica
+    metricas_periodo_iniciar(&metricas_tarefas[TAREFA_SENSOR], "LeituraSensor", PERIODO_CONTROLE_MS * 1000);
+    metricas_periodo_iniciar(&metricas_tarefas[TAREFA_CONTROLE], "ControleZonas", PERIODO_CONTROLE_MS * 1000);
+    metricas_periodo_iniciar(&metricas_tarefas[TAREFA_DISPLAY], "AtualizarDisplay", PERIODO_INTERFACE_MS * 1000);
+    metricas_periodo_iniciar(&metricas_tarefas[TAREFA_REDE], "ServidorWeb", PERIODO_INTERFACE_MS * 1000);
+
     //Cria as tasks do FreeRTOS
-    xTaskCreate(task_leitura_sensor, "LeituraSensor", 256, NULL, 3, NULL);
-    xTaskCreate(task_entrada_usuario, "EntradaUsuario", 512, NULL, 2, NULL);
-    xTaskCreate(task_controle_pi, "ControlePI", 512, NULL, 2, NULL);
-    xTaskCreate(task_atualizar_display, "AtualizarDisplay", 512, NULL, 1, NULL);
-    xTaskCreate(task_buzzer_alerta, "BuzzerAlerta", 256, NULL, 1, NULL);
-    xTaskCreate(task_servidor_web, "ServidorWeb", 1280, NULL, 1, NULL);
+    criar_tarefa(task_leitura_sensor, "LeituraSensor", PILHA_SENSOR, 3, PILHA_TAREFA(sensor), TCB_TAREFA(sensor));
+    criar_tarefa(task_entrada_usuario, "EntradaUsuario", PILHA_ENTRADA, 2, PILHA_TAREFA(entrada), TCB_TAREFA(entrada));
+    criar_tarefa(task_controle_zonas, "ControleZonas", PILHA_CONTROLE, 2, PILHA_TAREFA(controle), TCB_TAREFA(controle));
+    criar_tarefa(task_atualizar_display, "AtualizarDisplay", PILHA_DISPLAY, 1, PILHA_TAREFA(display), TCB_TAREFA(display));
+    criar_tarefa(task_servidor_web, "ServidorWeb", PILHA_REDE, 1, PILHA_TAREFA(rede), TCB_TAREFA(rede));
+    tarefa_registro = criar_tarefa(task_registro_historico, "RegistroHistorico", PILHA_REGISTRO, 1,
+                                   PILHA_TAREFA(registro), TCB_TAREFA(registro));
+    criar_tarefa(task_simulacao_malha, "SimulacaoMalha", PILHA_SIMULACAO, tskIDLE_PRIORITY,
+                 PILHA_TAREFA(simulacao), TCB_TAREFA(simulacao));
 
     //Inicia o escalonador do FreeRTOS
     vTaskStartScheduler();